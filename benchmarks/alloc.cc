@@ -0,0 +1,82 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "stx/alloc.h"
+
+using stx::FallibleAllocator;
+
+struct Object {
+  int64_t values[4];
+};
+
+void MakeUnique(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    auto object = std::make_unique<Object>();
+    benchmark::DoNotOptimize(object.get());
+  }
+}
+
+void TryMakeUnique(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    auto object = stx::try_make_unique<Object>();
+    benchmark::DoNotOptimize(object);
+  }
+}
+
+constexpr size_t kElements = 1024;
+
+template <typename Vector>
+void PushBack(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    Vector vector;
+    for (size_t i = 0; i < kElements; i++) vector.push_back(i);
+    benchmark::DoNotOptimize(vector.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+template <typename Vector>
+void TryPushBack(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    Vector vector;
+    for (size_t i = 0; i < kElements; i++) {
+      if (stx::try_push_back(vector, i).is_err()) state.SkipWithError("oom");
+    }
+    benchmark::DoNotOptimize(vector.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+template <typename Vector>
+void Reserve(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    Vector vector;
+    vector.reserve(kElements);
+    benchmark::DoNotOptimize(vector.data());
+  }
+}
+
+template <typename Vector>
+void TryReserve(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    Vector vector;
+    if (stx::try_reserve(vector, kElements).is_err()) {
+      state.SkipWithError("oom");
+    }
+    benchmark::DoNotOptimize(vector.data());
+  }
+}
+
+using StdVector = std::vector<size_t>;
+using FallibleVector = std::vector<size_t, FallibleAllocator<size_t>>;
+
+BENCHMARK(MakeUnique);
+BENCHMARK(TryMakeUnique);
+BENCHMARK_TEMPLATE(PushBack, StdVector);
+BENCHMARK_TEMPLATE(TryPushBack, StdVector);
+BENCHMARK_TEMPLATE(TryPushBack, FallibleVector);
+BENCHMARK_TEMPLATE(Reserve, StdVector);
+BENCHMARK_TEMPLATE(TryReserve, StdVector);
+BENCHMARK_TEMPLATE(TryReserve, FallibleVector);
@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "stx/binary.h"
+
+using stx::Result, stx::Ok, stx::Err, stx::Report;
+
+using Response = Result<int64_t, Report>;
+
+constexpr size_t kElements = 1024;
+
+std::vector<Response> make_responses() {
+  std::vector<Response> responses;
+  responses.reserve(kElements);
+  for (size_t i = 0; i < kElements; i++) {
+    if (i % 8 == 0) {
+      responses.push_back(Err(Report(std::string_view("connection reset"))));
+    } else {
+      responses.push_back(Ok(static_cast<int64_t>(i)));
+    }
+  }
+  return responses;
+}
+
+// encodes each response at the next 8-byte aligned offset, as they would be
+// laid out in a shared memory ring
+std::vector<size_t> encode_all(std::vector<Response> const& responses,
+                               std::vector<std::byte>& buffer) {
+  std::vector<size_t> offsets;
+  offsets.reserve(responses.size());
+  size_t offset = 0;
+  for (Response const& response : responses) {
+    offsets.push_back(offset);
+    size_t size = stx::binary::encode(response, std::span(buffer).subspan(offset))
+                      .unwrap();
+    offset += (size + 7) & ~size_t{7};
+  }
+  return offsets;
+}
+
+void Binary_Encode(benchmark::State& state) {  // NOLINT
+  auto responses = make_responses();
+  std::vector<std::byte> buffer(kElements * 64);
+  for (auto _ : state) {
+    size_t offset = 0;
+    for (Response const& response : responses) {
+      size_t size =
+          stx::binary::encode(response, std::span(buffer).subspan(offset))
+              .unwrap();
+      offset += (size + 7) & ~size_t{7};
+    }
+    benchmark::DoNotOptimize(buffer.data());
+    state.SetBytesProcessed(state.bytes_processed() +
+                            static_cast<int64_t>(offset));
+  }
+}
+
+void Binary_Decode(benchmark::State& state) {  // NOLINT
+  auto responses = make_responses();
+  std::vector<std::byte> buffer(kElements * 64);
+  auto offsets = encode_all(responses, buffer);
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (size_t offset : offsets) {
+      Response response =
+          stx::binary::decode<Response>(std::span(buffer).subspan(offset))
+              .unwrap();
+      sum += std::move(response).unwrap_or(0);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+void Binary_View(benchmark::State& state) {  // NOLINT
+  auto responses = make_responses();
+  std::vector<std::byte> buffer(kElements * 64);
+  auto offsets = encode_all(responses, buffer);
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (size_t offset : offsets) {
+      auto view =
+          stx::binary::view<Response>(std::span(buffer).subspan(offset))
+              .unwrap();
+      sum += view.match([](int64_t value) { return value; },
+                        [](std::string_view err) {
+                          return static_cast<int64_t>(err.size());
+                        });
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+void Binary_RoundTrip(benchmark::State& state) {  // NOLINT
+  auto responses = make_responses();
+  std::vector<std::byte> buffer(kElements * 64);
+  for (auto _ : state) {
+    auto offsets = encode_all(responses, buffer);
+    int64_t sum = 0;
+    for (size_t offset : offsets) {
+      sum += stx::binary::decode<Response>(std::span(buffer).subspan(offset))
+                 .unwrap()
+                 .unwrap_or(0);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+BENCHMARK(Binary_Encode);
+BENCHMARK(Binary_Decode);
+BENCHMARK(Binary_View);
+BENCHMARK(Binary_RoundTrip);
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "stx/checked.h"
+
+constexpr size_t kElements = 4096;
+
+template <typename T>
+std::vector<T> make_values(int64_t seed) {
+  std::vector<T> values(kElements);
+  for (size_t i = 0; i < kElements; i++) {
+    values[i] = static_cast<T>(static_cast<int64_t>(i) * seed % 2001 - 1000);
+  }
+  return values;
+}
+
+template <typename T>
+void Unchecked_Sum(benchmark::State& state) {  // NOLINT
+  auto values = make_values<T>(7);
+  for (auto _ : state) {
+    T sum = 0;
+    for (T value : values) sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+template <typename T>
+void ScalarChecked_Sum(benchmark::State& state) {  // NOLINT
+  auto values = make_values<T>(7);
+  for (auto _ : state) {
+    T sum = 0;
+    bool overflow = false;
+    for (T value : values) overflow |= __builtin_add_overflow(sum, value, &sum);
+    benchmark::DoNotOptimize(sum);
+    benchmark::DoNotOptimize(overflow);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+template <typename T>
+void Checked_Sum(benchmark::State& state) {  // NOLINT
+  auto values = make_values<T>(7);
+  for (auto _ : state) {
+    auto sum = stx::checked_sum(std::span<T const>(values));
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+template <typename T>
+void Unchecked_Dot(benchmark::State& state) {  // NOLINT
+  auto a = make_values<T>(7);
+  auto b = make_values<T>(13);
+  for (auto _ : state) {
+    T sum = 0;
+    for (size_t i = 0; i < kElements; i++) sum += a[i] * b[i];
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+template <typename T>
+void Checked_Dot(benchmark::State& state) {  // NOLINT
+  auto a = make_values<T>(7);
+  auto b = make_values<T>(13);
+  for (auto _ : state) {
+    auto sum = stx::checked_dot(std::span<T const>(a), std::span<T const>(b));
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+template <typename T>
+void Unchecked_DivideEach(benchmark::State& state) {  // NOLINT
+  auto num = make_values<T>(7);
+  std::vector<T> den(kElements, 3);
+  std::vector<T> out(kElements);
+  for (auto _ : state) {
+    for (size_t i = 0; i < kElements; i++) out[i] = num[i] / den[i];
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+template <typename T>
+void Checked_DivideEach(benchmark::State& state) {  // NOLINT
+  auto num = make_values<T>(7);
+  std::vector<T> den(kElements, 3);
+  std::vector<T> out(kElements);
+  for (auto _ : state) {
+    auto result = stx::checked_divide_each(std::span<T const>(num),
+                                           std::span<T const>(den),
+                                           std::span<T>(out));
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+BENCHMARK_TEMPLATE(Unchecked_Sum, int32_t);
+BENCHMARK_TEMPLATE(ScalarChecked_Sum, int32_t);
+BENCHMARK_TEMPLATE(Checked_Sum, int32_t);
+BENCHMARK_TEMPLATE(Unchecked_Sum, int64_t);
+BENCHMARK_TEMPLATE(ScalarChecked_Sum, int64_t);
+BENCHMARK_TEMPLATE(Checked_Sum, int64_t);
+BENCHMARK_TEMPLATE(Unchecked_Dot, int32_t);
+BENCHMARK_TEMPLATE(Checked_Dot, int32_t);
+BENCHMARK_TEMPLATE(Unchecked_Dot, int64_t);
+BENCHMARK_TEMPLATE(Checked_Dot, int64_t);
+BENCHMARK_TEMPLATE(Unchecked_DivideEach, int32_t);
+BENCHMARK_TEMPLATE(Checked_DivideEach, int32_t);
+BENCHMARK_TEMPLATE(Unchecked_DivideEach, double);
+BENCHMARK_TEMPLATE(Checked_DivideEach, double);
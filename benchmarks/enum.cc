@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "stx/enum.h"
+
+constexpr size_t kElements = 4096;
+
+struct Add {
+  int64_t value;
+};
+
+struct Sub {
+  int64_t value;
+};
+
+struct Mul {
+  int64_t value;
+};
+
+struct Neg {};
+
+using EnumOp = stx::Enum<Add, Sub, Mul, Neg>;
+using VariantOp = std::variant<Add, Sub, Mul, Neg>;
+
+template <typename Op>
+std::vector<Op> make_ops() {
+  std::vector<Op> ops;
+  ops.reserve(kElements);
+  for (size_t i = 0; i < kElements; i++) {
+    auto value = static_cast<int64_t>(i);
+    // a pseudo-random sequence of alternatives, so the dispatch is not
+    // trivially predictable
+    switch ((i * 7 + i / 3) % 4) {
+      case 0:
+        ops.push_back(Op{Add{value}});
+        break;
+      case 1:
+        ops.push_back(Op{Sub{value}});
+        break;
+      case 2:
+        ops.push_back(Op{Mul{value % 3 + 1}});
+        break;
+      default:
+        ops.push_back(Op{Neg{}});
+        break;
+    }
+  }
+  return ops;
+}
+
+template <typename... Fns>
+struct Overloaded : Fns... {
+  using Fns::operator()...;
+};
+
+template <typename... Fns>
+Overloaded(Fns...) -> Overloaded<Fns...>;
+
+void Enum_Match(benchmark::State& state) {  // NOLINT
+  auto ops = make_ops<EnumOp>();
+  for (auto _ : state) {
+    int64_t acc = 0;
+    for (EnumOp const& op : ops) {
+      acc = op.match([acc](Add const& a) { return acc + a.value; },
+                     [acc](Sub const& s) { return acc - s.value; },
+                     [acc](Mul const& m) { return acc * m.value; },
+                     [acc](Neg const&) { return -acc; });
+    }
+    benchmark::DoNotOptimize(acc);
+  }
+}
+
+void Variant_Visit(benchmark::State& state) {  // NOLINT
+  auto ops = make_ops<VariantOp>();
+  for (auto _ : state) {
+    int64_t acc = 0;
+    for (VariantOp const& op : ops) {
+      acc = std::visit(
+          Overloaded{[acc](Add const& a) { return acc + a.value; },
+                     [acc](Sub const& s) { return acc - s.value; },
+                     [acc](Mul const& m) { return acc * m.value; },
+                     [acc](Neg const&) { return -acc; }},
+          op);
+    }
+    benchmark::DoNotOptimize(acc);
+  }
+}
+
+void Enum_Move(benchmark::State& state) {  // NOLINT
+  auto ops = make_ops<EnumOp>();
+  std::vector<EnumOp> dst;
+  dst.reserve(kElements);
+  for (auto _ : state) {
+    dst.clear();
+    for (EnumOp& op : ops) dst.push_back(std::move(op));
+    std::swap(ops, dst);
+    benchmark::DoNotOptimize(ops.data());
+  }
+}
+
+void Variant_Move(benchmark::State& state) {  // NOLINT
+  auto ops = make_ops<VariantOp>();
+  std::vector<VariantOp> dst;
+  dst.reserve(kElements);
+  for (auto _ : state) {
+    dst.clear();
+    for (VariantOp& op : ops) dst.push_back(std::move(op));
+    std::swap(ops, dst);
+    benchmark::DoNotOptimize(ops.data());
+  }
+}
+
+void Enum_Size(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) benchmark::DoNotOptimize(sizeof(EnumOp));
+  state.counters["bytes"] = sizeof(EnumOp);
+}
+
+void Variant_Size(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) benchmark::DoNotOptimize(sizeof(VariantOp));
+  state.counters["bytes"] = sizeof(VariantOp);
+}
+
+BENCHMARK(Enum_Match);
+BENCHMARK(Variant_Visit);
+BENCHMARK(Enum_Move);
+BENCHMARK(Variant_Move);
+BENCHMARK(Enum_Size);
+BENCHMARK(Variant_Size);
@@ -0,0 +1,23 @@
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "stx/flight_recorder.h"
+
+void RecordEvent(benchmark::State& state) {  // NOLINT
+  uint64_t value = 0;
+  for (auto _ : state) {
+    stx::this_thread::record_event("event", value++);
+  }
+  benchmark::DoNotOptimize(stx::this_thread::flight_recorder().count());
+}
+
+void FlightSpan(benchmark::State& state) {  // NOLINT
+  uint64_t value = 0;
+  for (auto _ : state) {
+    stx::FlightSpan span{"span", value++};
+    benchmark::ClobberMemory();
+  }
+}
+
+BENCHMARK(RecordEvent);
+BENCHMARK(FlightSpan);
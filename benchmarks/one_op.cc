@@ -1,7 +1,9 @@
+#include <cstdio>
 #include <iostream>
 #include <variant>
 
 #include "benchmark/benchmark.h"
+#include "stx/catch.h"
 #include "stx/option.h"
 
 enum Error { ZeroDivision, NoError };
@@ -27,6 +29,10 @@ Result<double, Error> result_divide(double numerator,
   return Ok(numerator / denominator);
 }
 
+double noexcept_divide(double numerator, double denominator) noexcept {
+  return numerator / denominator;
+}
+
 Error c_style_divide(double num, double div, double* result) noexcept {
   if (div == 0.0) return Error::ZeroDivision;
   *result = num / div;
@@ -73,6 +79,31 @@ void Result_SuccessPath(benchmark::State& state) noexcept {  // NOLINT
   }
 }
 
+void CatchResult_SuccessPath(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    stx::catch_result<Error>([] { return exception_divide(1.0, 0.5); })
+        .match([](auto value) { benchmark::DoNotOptimize(value); },
+               [](auto err) {
+                 if (err == Error::ZeroDivision) {
+                   benchmark::DoNotOptimize(err);
+                 }
+               });
+  }
+}
+
+// `noexcept_divide` is known not to throw, so no try block is entered
+void CatchResult_NoexceptPath(benchmark::State& state) noexcept {  // NOLINT
+  for (auto _ : state) {
+    stx::catch_result<Error>([]() noexcept { return noexcept_divide(1.0, 0.5); })
+        .match([](auto value) { benchmark::DoNotOptimize(value); },
+               [](auto err) {
+                 if (err == Error::ZeroDivision) {
+                   benchmark::DoNotOptimize(err);
+                 }
+               });
+  }
+}
+
 void CStyle_SuccessPath(benchmark::State& state) noexcept {  // NOLINT
   for (auto _ : state) {
     double result;
@@ -85,6 +116,26 @@ void CStyle_SuccessPath(benchmark::State& state) noexcept {  // NOLINT
   }
 }
 
+// the message is built before `expect`, on the success path as well
+void Expect_SuccessPath(benchmark::State& state) noexcept {  // NOLINT
+  int shard = 7;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(shard);
+    char message[64];
+    std::snprintf(message, sizeof(message), "dividing shard %d", shard);
+    benchmark::DoNotOptimize(result_divide(1.0, 0.5).expect(message));
+  }
+}
+
+void ExpectFmt_SuccessPath(benchmark::State& state) noexcept {  // NOLINT
+  int shard = 7;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(shard);
+    benchmark::DoNotOptimize(
+        result_divide(1.0, 0.5).expect_fmt("dividing shard {}", shard));
+  }
+}
+
 void Variant_FailurePath(benchmark::State& state) noexcept {  // NOLINT
   for (auto _ : state) {
     auto result = variant_divide(1.0, 0.0);
@@ -125,6 +176,18 @@ void Result_FailurePath(benchmark::State& state) noexcept {  // NOLINT
   }
 }
 
+void CatchResult_FailurePath(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    stx::catch_result<Error>([] { return exception_divide(1.0, 0.0); })
+        .match([](auto value) { benchmark::DoNotOptimize(value); },
+               [](auto err) {
+                 if (err == Error::ZeroDivision) {
+                   benchmark::DoNotOptimize(err);
+                 }
+               });
+  }
+}
+
 void CStyle_FailurePath(benchmark::State& state) noexcept {  // NOLINT
   for (auto _ : state) {
     double result;
@@ -140,9 +203,14 @@ void CStyle_FailurePath(benchmark::State& state) noexcept {  // NOLINT
 BENCHMARK(Variant_SuccessPath);
 BENCHMARK(Exception_SuccessPath);
 BENCHMARK(Result_SuccessPath);
+BENCHMARK(CatchResult_SuccessPath);
+BENCHMARK(CatchResult_NoexceptPath);
 BENCHMARK(CStyle_SuccessPath);
+BENCHMARK(Expect_SuccessPath);
+BENCHMARK(ExpectFmt_SuccessPath);
 
 BENCHMARK(Variant_FailurePath);
 BENCHMARK(Exception_FailurePath);
 BENCHMARK(Result_FailurePath);
+BENCHMARK(CatchResult_FailurePath);
 BENCHMARK(CStyle_FailurePath);
@@ -0,0 +1,112 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+#include "stx/panic/handlers/default/default.h"
+
+using stx::ReportPayload, stx::SourceLocation;
+
+namespace {
+
+// stderr is redirected to /dev/null for the whole run, so the latency
+// measured is that of assembling the report and the write calls.
+struct RedirectStderr {
+  RedirectStderr() {
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDERR_FILENO);
+    close(null);
+  }
+} const redirect;
+
+struct Context {
+  int user;
+  int shard;
+};
+
+stx::ReportWriter& operator<<(stx::ReportWriter& writer,
+                              Context const& context) {
+  return writer << "user " << context.user << " shard " << context.shard;
+}
+
+// the previous report, written character by character to `stderr` under a
+// `std::mutex`, for reference
+void fputc_report(std::string_view info, std::string_view payload,
+                  SourceLocation location) {
+  static std::mutex stderr_lock;
+  char log_buffer[256];
+
+  auto thread_id_hash =
+      std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+  stderr_lock.lock();
+  std::fputs("\nthread with hash: '", stderr);
+  std::snprintf(log_buffer, sizeof(log_buffer), "%zu", thread_id_hash);
+  std::fputs(log_buffer, stderr);
+  std::fputs("' panicked with: '", stderr);
+  for (char c : info) std::fputc(c, stderr);
+  std::fputc(':', stderr);
+  std::fputc(' ', stderr);
+  for (char c : payload) std::fputc(c, stderr);
+  std::fputs("' at function: '", stderr);
+  std::fputs(location.function_name(), stderr);
+  std::fputs("' [", stderr);
+  std::fputs(location.file_name(), stderr);
+  std::fputc(':', stderr);
+  std::snprintf(log_buffer, sizeof(log_buffer), "%d",
+                static_cast<int>(location.line()));
+  std::fputs(log_buffer, stderr);
+  std::fputc(':', stderr);
+  std::snprintf(log_buffer, sizeof(log_buffer), "%d",
+                static_cast<int>(location.column()));
+  std::fputs(log_buffer, stderr);
+  std::fputs("]\n", stderr);
+  std::fflush(stderr);
+  stderr_lock.unlock();
+}
+
+}  // namespace
+
+void Fputc_PanicReport(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    fputc_report("request failed", "user 42 shard 7",
+                 SourceLocation::current());
+  }
+}
+
+void Writev_PanicReport(benchmark::State& state) {  // NOLINT
+  Context context{42, 7};
+  for (auto _ : state) {
+    stx::internal::panic_util::write_panic_report(
+        "request failed", ReportPayload::deferred(context),
+        SourceLocation::current());
+  }
+}
+
+// every thread panics at the same location, as when workers hit the same bad
+// input. without storm control, every panic is written in full.
+void FullReports_PanicStorm(benchmark::State& state) {  // NOLINT
+  Context context{42, 7};
+  for (auto _ : state) {
+    stx::internal::panic_util::write_panic_report(
+        "bad input", ReportPayload::deferred(context),
+        SourceLocation::current());
+  }
+}
+
+void Deduplicated_PanicStorm(benchmark::State& state) {  // NOLINT
+  Context context{42, 7};
+  for (auto _ : state) {
+    stx::panic_default("bad input", ReportPayload::deferred(context),
+                       SourceLocation::current());
+  }
+}
+
+BENCHMARK(Fputc_PanicReport)->Threads(1)->Threads(4);
+BENCHMARK(Writev_PanicReport)->Threads(1)->Threads(4);
+BENCHMARK(FullReports_PanicStorm)->Threads(8)->Threads(64)->UseRealTime();
+BENCHMARK(Deduplicated_PanicStorm)->Threads(8)->Threads(64)->UseRealTime();
@@ -0,0 +1,134 @@
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "stx/parse.h"
+
+constexpr size_t kFields = 4096;
+
+std::string make_column(int64_t scale) {
+  std::string text;
+  for (size_t i = 0; i < kFields; i++) {
+    int64_t value = (static_cast<int64_t>(i) * 7919 % 20001 - 10000) * scale;
+    text += std::to_string(value);
+    text += ',';
+  }
+  text.pop_back();
+  return text;
+}
+
+std::vector<std::string> split(std::string const& text) {
+  std::vector<std::string> fields;
+  size_t begin = 0;
+  while (true) {
+    size_t end = text.find(',', begin);
+    fields.push_back(text.substr(begin, end - begin));
+    if (end == std::string::npos) break;
+    begin = end + 1;
+  }
+  return fields;
+}
+
+void Stoi_Int32(benchmark::State& state) {  // NOLINT
+  auto fields = split(make_column(1));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (std::string const& field : fields) sum += std::stoi(field);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kFields);
+}
+
+void Strtol_Int32(benchmark::State& state) {  // NOLINT
+  auto fields = split(make_column(1));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (std::string const& field : fields)
+      sum += std::strtol(field.c_str(), nullptr, 10);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kFields);
+}
+
+void Parse_Int32(benchmark::State& state) {  // NOLINT
+  auto fields = split(make_column(1));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (std::string const& field : fields)
+      sum += stx::parse<int32_t>(field).unwrap_or(0);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kFields);
+}
+
+void Parse_Double(benchmark::State& state) {  // NOLINT
+  auto fields = split(make_column(1));
+  for (auto& field : fields) field += ".125";
+  for (auto _ : state) {
+    double sum = 0;
+    for (std::string const& field : fields)
+      sum += stx::parse<double>(field).unwrap_or(0.0);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kFields);
+}
+
+void Strtod_Double(benchmark::State& state) {  // NOLINT
+  auto fields = split(make_column(1));
+  for (auto& field : fields) field += ".125";
+  for (auto _ : state) {
+    double sum = 0;
+    for (std::string const& field : fields)
+      sum += std::strtod(field.c_str(), nullptr);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kFields);
+}
+
+// splits and parses each field with `parse<T>`, as `parse_column` does
+// without the vectorized validation
+template <typename T>
+void FieldLoop_Column(benchmark::State& state) {  // NOLINT
+  std::string text = make_column(state.range(0));
+  std::vector<T> out(kFields);
+  for (auto _ : state) {
+    std::string_view rest = text;
+    size_t index = 0;
+    while (true) {
+      size_t end = rest.find(',');
+      out[index++] = stx::parse<T>(rest.substr(0, end)).unwrap_or(0);
+      if (end == std::string_view::npos) break;
+      rest.remove_prefix(end + 1);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kFields);
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(text.size()));
+}
+
+template <typename T>
+void ParseColumn(benchmark::State& state) {  // NOLINT
+  std::string text = make_column(state.range(0));
+  std::vector<T> out(kFields);
+  for (auto _ : state) {
+    auto values = stx::parse_column<T>(text, ',', out);
+    benchmark::DoNotOptimize(values);
+  }
+  state.SetItemsProcessed(state.iterations() * kFields);
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(text.size()));
+}
+
+BENCHMARK(Stoi_Int32);
+BENCHMARK(Strtol_Int32);
+BENCHMARK(Parse_Int32);
+BENCHMARK(Strtod_Double);
+BENCHMARK(Parse_Double);
+BENCHMARK_TEMPLATE(FieldLoop_Column, int32_t)->Arg(1);
+BENCHMARK_TEMPLATE(ParseColumn, int32_t)->Arg(1);
+BENCHMARK_TEMPLATE(FieldLoop_Column, int64_t)->Arg(1)->Arg(100'000'000);
+BENCHMARK_TEMPLATE(ParseColumn, int64_t)->Arg(1)->Arg(100'000'000);
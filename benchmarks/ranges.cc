@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "stx/ranges.h"
+
+using stx::Option, stx::Some, stx::None, stx::Result, stx::Ok, stx::Err;
+
+constexpr size_t kElements = 4096;
+
+std::vector<Option<int64_t>> make_options() {
+  std::vector<Option<int64_t>> options;
+  options.reserve(kElements);
+  for (size_t i = 0; i < kElements; i++) {
+    if (i % 3 == 0) {
+      options.push_back(None);
+    } else {
+      options.push_back(Some(static_cast<int64_t>(i)));
+    }
+  }
+  return options;
+}
+
+std::vector<Result<int64_t, int>> make_results() {
+  std::vector<Result<int64_t, int>> results;
+  results.reserve(kElements);
+  for (size_t i = 0; i < kElements; i++) {
+    if (i % 3 == 0) {
+      results.push_back(Err(static_cast<int>(i)));
+    } else {
+      results.push_back(Ok(static_cast<int64_t>(i)));
+    }
+  }
+  return results;
+}
+
+// a lambda rather than a function, so the call is not made through a
+// function pointer stored in the view
+constexpr auto halve_even = [](int64_t value) noexcept -> Option<int64_t> {
+  if (value % 2 == 0) return Some(value / 2);
+  return None;
+};
+
+void FlattenOptions_HandWritten(benchmark::State& state) {  // NOLINT
+  auto options = make_options();
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto& option : options) {
+      if (option.is_some()) sum += option.value();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+void FlattenOptions_View(benchmark::State& state) {  // NOLINT
+  auto options = make_options();
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (int64_t value : options | stx::views::flatten_options) sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+void OkValues_HandWritten(benchmark::State& state) {  // NOLINT
+  auto results = make_results();
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto& result : results) {
+      if (result.is_ok()) sum += result.value();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+void OkValues_View(benchmark::State& state) {  // NOLINT
+  auto results = make_results();
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (int64_t value : results | stx::views::ok_values) sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+void FilterMap_HandWritten(benchmark::State& state) {  // NOLINT
+  std::vector<int64_t> values(kElements);
+  for (size_t i = 0; i < kElements; i++) values[i] = static_cast<int64_t>(i);
+
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (int64_t value : values) {
+      if (value % 2 == 0) sum += value / 2;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+void FilterMap_View(benchmark::State& state) {  // NOLINT
+  std::vector<int64_t> values(kElements);
+  for (size_t i = 0; i < kElements; i++) values[i] = static_cast<int64_t>(i);
+
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (int64_t value : values | stx::views::filter_map(halve_even)) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+BENCHMARK(FlattenOptions_HandWritten);
+BENCHMARK(FlattenOptions_View);
+BENCHMARK(OkValues_HandWritten);
+BENCHMARK(OkValues_View);
+BENCHMARK(FilterMap_HandWritten);
+BENCHMARK(FilterMap_View);
@@ -0,0 +1,91 @@
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "stx/report.h"
+
+using stx::Report, stx::ReportQuery;
+
+enum class Status : uint8_t { Ok, NotFound, PermissionDenied, TimedOut };
+
+constexpr size_t kValues = 1024;
+constexpr auto query = ReportQuery{};
+
+template <typename T>
+std::vector<T> make_values() {
+  std::vector<T> values;
+  values.reserve(kValues);
+  for (size_t i = 0; i < kValues; i++) {
+    if constexpr (std::is_floating_point_v<T>) {
+      values.push_back(static_cast<T>(i) * 1.37 - 400.0);
+    } else if constexpr (std::is_enum_v<T>) {
+      values.push_back(static_cast<T>(i % 5));
+    } else {
+      values.push_back(static_cast<T>((i * 2654435761U) ^ (i << 40)));
+    }
+  }
+  return values;
+}
+
+// the previous `snprintf`-based formatting, for reference
+void Snprintf_Int32(benchmark::State& state) {  // NOLINT
+  auto values = make_values<int32_t>();
+  for (auto _ : state) {
+    for (int32_t value : values) {
+      char buffer[12];
+      std::snprintf(buffer, sizeof(buffer), "%" PRId32, value);
+      Report report(buffer);
+      benchmark::DoNotOptimize(report);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+void Snprintf_Double(benchmark::State& state) {  // NOLINT
+  auto values = make_values<double>();
+  for (auto _ : state) {
+    for (double value : values) {
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+      Report report(buffer);
+      benchmark::DoNotOptimize(report);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+template <typename T>
+void Report_Format(benchmark::State& state) {  // NOLINT
+  auto values = make_values<T>();
+  for (auto _ : state) {
+    for (T const& value : values) {
+      Report report = query >> value;
+      benchmark::DoNotOptimize(report);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+void Report_Pointer(benchmark::State& state) {  // NOLINT
+  auto values = make_values<uintptr_t>();
+  for (auto _ : state) {
+    for (uintptr_t value : values) {
+      auto pointer = reinterpret_cast<void const*>(value);
+      Report report = query >> pointer;
+      benchmark::DoNotOptimize(report);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kValues);
+}
+
+BENCHMARK(Snprintf_Int32);
+BENCHMARK_TEMPLATE(Report_Format, int32_t);
+BENCHMARK_TEMPLATE(Report_Format, uint64_t);
+BENCHMARK(Snprintf_Double);
+BENCHMARK_TEMPLATE(Report_Format, double);
+BENCHMARK_TEMPLATE(Report_Format, float);
+BENCHMARK_TEMPLATE(Report_Format, bool);
+BENCHMARK_TEMPLATE(Report_Format, Status);
+BENCHMARK(Report_Pointer);
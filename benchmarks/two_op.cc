@@ -2,6 +2,7 @@
 #include <variant>
 
 #include "benchmark/benchmark.h"
+#include "stx/catch.h"
 #include "stx/option.h"
 
 enum Error { ZeroDivision, NoError };
@@ -107,6 +108,34 @@ void Result_SuccessPath(benchmark::State& state) noexcept {  // NOLINT
   }
 }
 
+// both operations are bridged by a single `catch_result`
+void CatchResult_SuccessPath(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    stx::catch_result<Error>([] {
+      return divide_by_exceptional(5.0, exception_divide(0.444, 0.5));
+    }).match([](auto v) { benchmark::DoNotOptimize(v); },
+             [](auto e) {
+               if (e == Error::ZeroDivision) benchmark::DoNotOptimize(e);
+             });
+  }
+}
+
+// each operation is bridged by its own `catch_result`, and chained with
+// `and_then`
+void CatchResultEach_SuccessPath(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    stx::catch_result<Error>([] { return exception_divide(0.444, 0.5); })
+        .and_then([](double d) {
+          return stx::catch_result<Error>(
+              [d] { return divide_by_exceptional(5.0, d); });
+        })
+        .match([](auto v) { benchmark::DoNotOptimize(v); },
+               [](auto e) {
+                 if (e == Error::ZeroDivision) benchmark::DoNotOptimize(e);
+               });
+  }
+}
+
 void CStyle_SuccessPath(benchmark::State& state) noexcept {  // NOLINT
   for (auto _ : state) {
     double result;
@@ -164,6 +193,34 @@ void Result_FailurePath(benchmark::State& state) noexcept {  // NOLINT
   }
 }
 
+// both operations are bridged by a single `catch_result`
+void CatchResult_FailurePath(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    stx::catch_result<Error>([] {
+      return divide_by_exceptional(5.0, exception_divide(0.0, 0.5));
+    }).match([](auto v) { benchmark::DoNotOptimize(v); },
+             [](auto e) {
+               if (e == Error::ZeroDivision) benchmark::DoNotOptimize(e);
+             });
+  }
+}
+
+// each operation is bridged by its own `catch_result`, and chained with
+// `and_then`
+void CatchResultEach_FailurePath(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    stx::catch_result<Error>([] { return exception_divide(0.0, 0.5); })
+        .and_then([](double d) {
+          return stx::catch_result<Error>(
+              [d] { return divide_by_exceptional(5.0, d); });
+        })
+        .match([](auto v) { benchmark::DoNotOptimize(v); },
+               [](auto e) {
+                 if (e == Error::ZeroDivision) benchmark::DoNotOptimize(e);
+               });
+  }
+}
+
 void CStyle_FailurePath(benchmark::State& state) noexcept {  // NOLINT
   for (auto _ : state) {
     double result;
@@ -183,9 +240,13 @@ void CStyle_FailurePath(benchmark::State& state) noexcept {  // NOLINT
 BENCHMARK(Variant_SuccessPath);
 BENCHMARK(Exception_SuccessPath);
 BENCHMARK(Result_SuccessPath);
+BENCHMARK(CatchResult_SuccessPath);
+BENCHMARK(CatchResultEach_SuccessPath);
 BENCHMARK(CStyle_SuccessPath);
 
 BENCHMARK(Variant_FailurePath);
 BENCHMARK(Exception_FailurePath);
 BENCHMARK(Result_FailurePath);
+BENCHMARK(CatchResult_FailurePath);
+BENCHMARK(CatchResultEach_FailurePath);
 BENCHMARK(CStyle_FailurePath);
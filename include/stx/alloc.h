@@ -0,0 +1,362 @@
+/**
+ * @file alloc.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "stx/catch.h"
+#include "stx/panic.h"
+#include "stx/result.h"
+
+//! ### Fallible allocation
+//!
+//! Allocation functions that return an `AllocError` instead of throwing
+//! `std::bad_alloc`, so that a service under memory pressure can shed load,
+//! i.e. reject a request, instead of aborting.
+//!
+//! ``` cpp
+//! using Queue = std::vector<Request, FallibleAllocator<Request>>;
+//!
+//! Result<Unit, AllocError> accept(Queue& queue, Request request) {
+//!   return try_push_back(queue, std::move(request));
+//! }
+//! ```
+//!
+//! `try_reserve` and `try_push_back` work on any `std::vector`. With
+//! `FallibleAllocator`, the allocation is made before the vector grows and
+//! handed to it, so a failure is reported without the vector seeing an
+//! exception. With other allocators, `std::bad_alloc` is caught.
+
+namespace stx {
+
+/// Error type for fallible allocation
+enum class AllocError : uint8_t {
+  /// the allocator could not provide the memory
+  OutOfMemory,
+  /// the requested capacity exceeds the maximum size of the container or the
+  /// address space
+  CapacityOverflow
+};
+
+/// Allocates and constructs a `T` with `args`. Returns
+/// `AllocError::OutOfMemory` if the memory could not be allocated. Exceptions
+/// thrown by `T`'s constructor propagate as with `std::make_unique`.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// auto value = try_make_unique<std::array<char, 4096>>();
+/// ASSERT_TRUE(value.is_ok());
+/// ```
+template <typename T, typename... Args>
+requires(!std::is_array_v<T>) && std::is_constructible_v<T, Args&&...>
+    [[nodiscard]] auto try_make_unique(Args&&... args)
+        -> Result<std::unique_ptr<T>, AllocError> {
+  T* object = new (std::nothrow) T(std::forward<Args>(args)...);
+  if (object == nullptr) [[unlikely]] {
+    return Err(AllocError::OutOfMemory);
+  }
+  return Ok(std::unique_ptr<T>{object});
+}
+
+/// An allocator adaptor whose `try_allocate` returns `AllocError` instead of
+/// throwing. `try_reserve` and `try_push_back` use it to grow vectors without
+/// exceptions.
+///
+/// The memory is allocated from `Inner`. With `std::allocator`, the nothrow
+/// `operator new` is called, so no exception is thrown. An `Inner` with its own
+/// `try_allocate` returning `Result<T*, AllocError>` is called through it, and
+/// for any other `Inner` the `std::bad_alloc` of `allocate` is caught.
+template <typename T, typename Inner = std::allocator<T>>
+struct FallibleAllocator {
+  using value_type = T;
+  using inner_traits = std::allocator_traits<Inner>;
+  using is_always_equal = typename inner_traits::is_always_equal;
+  using propagate_on_container_copy_assignment =
+      typename inner_traits::propagate_on_container_copy_assignment;
+  using propagate_on_container_move_assignment =
+      typename inner_traits::propagate_on_container_move_assignment;
+  using propagate_on_container_swap =
+      typename inner_traits::propagate_on_container_swap;
+
+  static_assert(std::is_same_v<typename inner_traits::value_type, T>,
+                "the inner allocator must allocate `T`");
+
+  template <typename U>
+  struct rebind {
+    using other =
+        FallibleAllocator<U, typename inner_traits::template rebind_alloc<U>>;
+  };
+
+  constexpr FallibleAllocator() noexcept(
+      std::is_nothrow_default_constructible_v<Inner>) = default;
+
+  constexpr explicit FallibleAllocator(Inner inner) noexcept
+      : inner_{std::move(inner)} {}
+
+  template <typename U, typename InnerU>
+  constexpr FallibleAllocator(
+      FallibleAllocator<U, InnerU> const& other) noexcept
+      : inner_{other.inner()} {}
+
+  [[nodiscard]] constexpr Inner const& inner() const noexcept {
+    return inner_;
+  }
+
+  /// Allocates storage for `n` objects of type `T`.
+  [[nodiscard]] auto try_allocate(size_t n) noexcept
+      -> Result<T*, AllocError> {
+    if (n > inner_traits::max_size(inner_)) [[unlikely]] {
+      return Err(AllocError::CapacityOverflow);
+    }
+
+    if constexpr (std::is_same_v<Inner, std::allocator<T>>) {
+      // what `std::allocator` calls, without the exception
+      void* memory = nullptr;
+      if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        memory = ::operator new(n * sizeof(T), std::align_val_t{alignof(T)},
+                                std::nothrow);
+      } else {
+        memory = ::operator new(n * sizeof(T), std::nothrow);
+      }
+      if (memory == nullptr) [[unlikely]] {
+        return Err(AllocError::OutOfMemory);
+      }
+      return Ok(static_cast<T*>(memory));
+    } else if constexpr (requires(Inner & inner) {
+                           {
+                             inner.try_allocate(n)
+                             } -> std::same_as<Result<T*, AllocError>>;
+                         }) {
+      return inner_.try_allocate(n);
+    } else {
+#if defined(__cpp_exceptions)
+      try {
+        return Ok(inner_traits::allocate(inner_, n));
+      } catch (std::bad_alloc const&) {
+        return Err(AllocError::OutOfMemory);
+      }
+#else
+      return Ok(inner_traits::allocate(inner_, n));
+#endif
+    }
+  }
+
+  /// Allocates storage for `n` objects of type `T`, throws `std::bad_alloc` if
+  /// it can not, as required of allocators.
+  [[nodiscard]] T* allocate(size_t n) {
+    // the storage set aside by `try_reserve` for the vector it is growing
+    if (pending_ != nullptr && pending_size_ == n) {
+      return std::exchange(pending_, nullptr);
+    }
+
+    Result<T*, AllocError> memory = try_allocate(n);
+    if (memory.is_err()) [[unlikely]] {
+#if defined(__cpp_exceptions)
+      throw std::bad_alloc{};
+#else
+      panic("memory allocation failed", memory.err_value());
+#endif
+    }
+    return std::move(memory).unwrap();
+  }
+
+  void deallocate(T* pointer, size_t n) noexcept {
+    inner_traits::deallocate(inner_, pointer, n);
+  }
+
+  template <typename U, typename InnerU>
+  [[nodiscard]] constexpr bool operator==(
+      FallibleAllocator<U, InnerU> const& other) const noexcept {
+    return inner_ == other.inner();
+  }
+
+ private:
+  template <typename U, typename A>
+  friend auto try_reserve(std::vector<U, A>& vector, size_t capacity)
+      -> Result<Unit, AllocError>;
+
+  [[no_unique_address]] Inner inner_;
+
+  static inline thread_local constinit T* pending_ = nullptr;
+  static inline thread_local constinit size_t pending_size_ = 0;
+};
+
+namespace internal {
+namespace alloc {
+
+template <typename A>
+constexpr bool is_fallible_allocator = false;
+
+template <typename T, typename Inner>
+constexpr bool is_fallible_allocator<FallibleAllocator<T, Inner>> = true;
+
+}  // namespace alloc
+}  // namespace internal
+
+/// Reserves capacity for at least `capacity` elements in `vector`, as
+/// `std::vector::reserve` does. Returns `AllocError::CapacityOverflow` if
+/// `capacity` exceeds `vector.max_size()`, or `AllocError::OutOfMemory` if the
+/// memory could not be allocated, in which case `vector` is unchanged.
+///
+/// With `FallibleAllocator`, no exception is thrown for a failed allocation.
+/// Exceptions thrown by the elements' constructors propagate.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// std::vector<int, FallibleAllocator<int>> vector;
+/// ASSERT_EQ(try_reserve(vector, 64), Ok(Unit{}));
+/// ASSERT_EQ(try_reserve(vector, vector.max_size() + 1),
+///           Err(AllocError::CapacityOverflow));
+/// ```
+template <typename T, typename A>
+[[nodiscard]] auto try_reserve(std::vector<T, A>& vector, size_t capacity)
+    -> Result<Unit, AllocError> {
+  if (capacity <= vector.capacity()) [[likely]] {
+    return Ok(Unit{});
+  }
+  if (capacity > vector.max_size()) [[unlikely]] {
+    return Err(AllocError::CapacityOverflow);
+  }
+
+  if constexpr (internal::alloc::is_fallible_allocator<A>) {
+    A allocator = vector.get_allocator();
+    Result<T*, AllocError> memory = allocator.try_allocate(capacity);
+    if (memory.is_err()) [[unlikely]] {
+      return Err(std::move(memory).unwrap_err());
+    }
+
+    // the vector is handed the storage when it allocates for `capacity`
+    A::pending_ = std::move(memory).unwrap();
+    A::pending_size_ = capacity;
+    vector.reserve(capacity);
+    if (A::pending_ != nullptr) [[unlikely]] {
+      allocator.deallocate(std::exchange(A::pending_, nullptr), capacity);
+    }
+    return Ok(Unit{});
+  } else {
+#if defined(__cpp_exceptions)
+    try {
+      vector.reserve(capacity);
+    } catch (std::bad_alloc const&) {
+      return Err(AllocError::OutOfMemory);
+    }
+#else
+    vector.reserve(capacity);
+#endif
+    return Ok(Unit{});
+  }
+}
+
+namespace internal {
+namespace alloc {
+
+/// capacity to grow `vector` to for one more element, grows geometrically as
+/// `push_back` does
+template <typename T, typename A>
+size_t grown_capacity(std::vector<T, A> const& vector) noexcept {
+  size_t size = vector.size();
+  size_t max = vector.max_size();
+  if (size >= max / 2) return max;
+  return std::max<size_t>(size * 2, 1);
+}
+
+/// index of the element `value` points to, or `vector.size()` if it does not
+/// point into `vector`. Growing `vector` moves its elements, so a value that
+/// is one of them is found again by its index.
+template <typename T, typename A>
+size_t element_index(std::vector<T, A> const& vector,
+                     T const* value) noexcept {
+  std::less<T const*> const less;
+  T const* begin = vector.data();
+  T const* end = begin + vector.size();
+  if (!less(value, begin) && less(value, end)) {
+    return static_cast<size_t>(value - begin);
+  }
+  return vector.size();
+}
+
+/// grows a full `vector` for one more element
+template <typename T, typename A>
+[[nodiscard]] auto grow_for_push(std::vector<T, A>& vector)
+    -> Result<Unit, AllocError> {
+  if (vector.size() == vector.max_size()) {
+    return Err(AllocError::CapacityOverflow);
+  }
+  return try_reserve(vector, grown_capacity(vector));
+}
+
+}  // namespace alloc
+}  // namespace internal
+
+/// Appends `value` to `vector`, growing it with `try_reserve` if it is full.
+/// Returns the `AllocError` if it could not grow, in which case `vector` is
+/// unchanged. `value` may be an element of `vector`.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// std::vector<int, FallibleAllocator<int>> vector;
+/// ASSERT_EQ(try_push_back(vector, 42), Ok(Unit{}));
+/// ASSERT_EQ(vector.back(), 42);
+/// ```
+template <typename T, typename A>
+[[nodiscard]] STX_FORCE_INLINE auto try_push_back(
+    std::vector<T, A>& vector, std::type_identity_t<T> const& value)
+    -> Result<Unit, AllocError> {
+  T const* source = std::addressof(value);
+  if (vector.size() == vector.capacity()) [[unlikely]] {
+    size_t index = internal::alloc::element_index(vector, source);
+    Result<Unit, AllocError> grown = internal::alloc::grow_for_push(vector);
+    if (grown.is_err()) [[unlikely]] {
+      return grown;
+    }
+    if (index != vector.size()) source = vector.data() + index;
+  }
+  vector.push_back(*source);
+  return Ok(Unit{});
+}
+
+template <typename T, typename A>
+[[nodiscard]] STX_FORCE_INLINE auto try_push_back(
+    std::vector<T, A>& vector, std::type_identity_t<T>&& value)
+    -> Result<Unit, AllocError> {
+  T* source = std::addressof(value);
+  if (vector.size() == vector.capacity()) [[unlikely]] {
+    size_t index = internal::alloc::element_index(vector, source);
+    Result<Unit, AllocError> grown = internal::alloc::grow_for_push(vector);
+    if (grown.is_err()) [[unlikely]] {
+      return grown;
+    }
+    if (index != vector.size()) source = vector.data() + index;
+  }
+  vector.push_back(std::move(*source));
+  return Ok(Unit{});
+}
+
+};  // namespace stx
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 
 #include "stx/internal/option_result.h"
 
@@ -35,7 +36,7 @@ namespace backtrace {
 enum class SignalError {
   /// An Unknown error occurred
   Unknown,
-  /// `std::signal` returned `SIG_ERR`
+  /// `sigaction` failed to install the handler
   SigErr
 };
 
@@ -147,10 +148,33 @@ using Callback = bool (*)(Frame, int);
 // use one stack memory for the callback feed-loop.
 size_t trace(Callback callback);
 
+/// Captures the instruction pointers of the current thread's stack into
+/// `ips`, innermost first, without symbolizing them. It uses much less stack
+/// than `trace`, so the stack can be captured where it is short, and
+/// symbolized elsewhere, i.e. on the emergency reserve stack.
+///
+/// Returns the number of instruction pointers captured.
+size_t capture(std::span<void*> ips) noexcept;
+
+/// Calls `callback` on the frames of the instruction pointers captured by
+/// `capture`, as `trace` does.
+///
+/// Returns the number of stack frames read.
+size_t trace(std::span<void* const> ips, Callback callback);
+
 /// Installs an handler for the specified signal that prints a backtrace
 /// whenever the signal is raised. It can and will only handle `SIGSEGV`,
 /// `SIGILL`, and `SIGFPE`. It returns the previous signal handler if
-/// successful, else returns the error.
+/// successful, else returns the error. A previous handler installed with
+/// `SA_SIGINFO` can not be returned as a `void (*)(int)`, `SIG_DFL` is
+/// returned for it instead.
+///
+/// The handler runs on the alternate signal stack of the panic emergency
+/// reserve, which this sets up for the calling thread if it is not already,
+/// so that a stack overflow is reported too. Other threads need their own
+/// signal stack, see `setup_panic_signal_stack`. The report is written from a
+/// preallocated buffer through the async-signal-safe path of
+/// `panic_signal_safe`, and its backtrace starts at the faulting instruction.
 auto handle_signal(int signal) noexcept -> Result<void (*)(int), SignalError>;
 
 };  // namespace backtrace
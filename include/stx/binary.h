@@ -0,0 +1,473 @@
+/**
+ * @file binary.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-06
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "stx/report.h"
+#include "stx/result.h"
+
+//! ### Binary layout
+//!
+//! A stable, position-independent binary encoding of `Option`, `Result`,
+//! `Report` and the primitive types, meant to be shared between processes
+//! (i.e. over shared memory). The encoding contains no pointers and does not
+//! depend on the host:
+//!
+//! - integers, `bool`, `char` and enumerations: `sizeof(T)` bytes,
+//! little-endian, two's complement. `bool` is either `0` or `1`.
+//! - `float` and `double`: the IEEE-754 bits, little-endian.
+//! - `Option<T>`: a tag byte (`0` = `None`, `1` = `Some`). if `Some`, the
+//! value follows at the next multiple of `T`'s alignment.
+//! - `Result<T, E>`: a tag byte (`0` = `Ok`, `1` = `Err`), the value or error
+//! follows at the next multiple of the larger of `T`'s and `E`'s alignments.
+//! - `Report`: a 32-bit little-endian length, followed by the characters.
+//!
+//! The alignment of a primitive is its size, every value is placed at an
+//! offset that is a multiple of its alignment relative to the start of the
+//! encoding, and padding bytes are zero. Placing the encoding at an address
+//! aligned to `binary::Layout<T>::kAlign` thus makes every read an aligned
+//! read.
+//!
+//! `binary::view<T>` validates the encoded bytes once and returns a view that
+//! reads the values in place, i.e. an encoded `Result<int64_t, Report>` is
+//! viewed as a `ResultView<int64_t, Report>` whose error is a
+//! `std::string_view` into the encoded bytes.
+//!
+//! ``` cpp
+//! std::array<std::byte, 64> buffer;
+//!
+//! Result<int64_t, Report> response = Err(Report("connection reset"sv));
+//! size_t size = binary::encode(response, buffer).unwrap();
+//!
+//! auto view = binary::view<Result<int64_t, Report>>(
+//!                 std::span(buffer).first(size)).unwrap();
+//! ASSERT_TRUE(view.is_err());
+//! ASSERT_EQ(view.err().unwrap(), "connection reset"sv);
+//! ```
+
+namespace stx {
+namespace binary {
+
+/// Error type returned when encoding to or decoding from the binary layout
+enum class Error : uint8_t {
+  /// the buffer is smaller than the encoded value
+  BufferTooSmall,
+  /// a tag byte is neither of the values expected for the type
+  InvalidTag,
+  /// the encoded value is not a valid value of its type, i.e. a `bool` that is
+  /// neither `0` nor `1`
+  InvalidValue
+};
+
+/// Describes the binary layout of `T`. Specialized for the primitives,
+/// `Option`, `Result` and `Report`.
+///
+/// - `kAlign`: alignment of the encoding.
+/// - `size(value)`: size of `value`'s encoding.
+/// - `write(value, out)`: encodes `value` into `out`, which must have
+/// `size(value)` bytes.
+/// - `validate(in, size)`: checks that `in` holds a valid encoding, returns
+/// its size.
+/// - `read(in)`: decodes a validated encoding.
+/// - `view(in)`: returns a view of a validated encoding.
+template <typename T>
+struct Layout;
+
+template <typename T>
+concept Encodable = requires(T const& value, std::byte* out,
+                             std::byte const* in, size_t size) {
+  { Layout<T>::kAlign } -> convertible_to<size_t>;
+  { Layout<T>::size(value) } -> same_as<size_t>;
+  Layout<T>::write(value, out);
+  { Layout<T>::validate(in, size) } -> same_as<Result<size_t, Error>>;
+  { Layout<T>::read(in) } -> same_as<T>;
+  Layout<T>::view(in);
+};
+
+/// the type `binary::view<T>` returns, i.e. `ResultView<T, E>` for
+/// `Result<T, E>`, `std::string_view` for `Report`, and `T` itself for the
+/// primitives.
+template <Encodable T>
+using view_type = decltype(Layout<T>::view(std::declval<std::byte const*>()));
+
+}  // namespace binary
+
+namespace internal {
+namespace binary {
+
+[[nodiscard]] constexpr size_t align_up(size_t offset,
+                                        size_t alignment) noexcept {
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+template <size_t Size>
+using uint_of = std::conditional_t<
+    Size == 1, uint8_t,
+    std::conditional_t<Size == 2, uint16_t,
+                       std::conditional_t<Size == 4, uint32_t, uint64_t>>>;
+
+template <typename U>
+[[nodiscard]] STX_FORCE_INLINE constexpr U to_little_endian(U bits) noexcept {
+  if constexpr (std::endian::native == std::endian::little || sizeof(U) == 1) {
+    return bits;
+  } else {
+    U swapped = 0;
+    for (size_t i = 0; i < sizeof(U); i++) {
+      swapped = static_cast<U>((swapped << 8) | ((bits >> (i * 8)) & 0xFF));
+    }
+    return swapped;
+  }
+}
+
+template <typename T>
+STX_FORCE_INLINE void store(T value, std::byte* out) noexcept {
+  using U = uint_of<sizeof(T)>;
+  U bits = to_little_endian(std::bit_cast<U>(value));
+  std::memcpy(out, &bits, sizeof(U));
+}
+
+template <typename T>
+[[nodiscard]] STX_FORCE_INLINE T load(std::byte const* in) noexcept {
+  using U = uint_of<sizeof(T)>;
+  U bits;
+  std::memcpy(&bits, in, sizeof(U));
+  return std::bit_cast<T>(to_little_endian(bits));
+}
+
+STX_FORCE_INLINE void store_tag(uint8_t tag, size_t payload_offset,
+                                std::byte* out) noexcept {
+  out[0] = std::byte{tag};
+  std::memset(out + 1, 0, payload_offset - 1);
+}
+
+[[nodiscard]] STX_FORCE_INLINE uint8_t load_tag(std::byte const* in) noexcept {
+  return std::to_integer<uint8_t>(in[0]);
+}
+
+template <typename T>
+concept Primitive = std::is_integral_v<T> || std::is_enum_v<T> ||
+                    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+}  // namespace binary
+}  // namespace internal
+
+namespace binary {
+
+/// A view of an encoded `Option<T>`, reading the value in place.
+template <Encodable T>
+class OptionView {
+ public:
+  explicit constexpr OptionView(std::byte const* data) noexcept
+      : data_{data} {}
+
+  [[nodiscard]] bool is_some() const noexcept {
+    return internal::binary::load_tag(data_) == 1;
+  }
+
+  [[nodiscard]] bool is_none() const noexcept { return !is_some(); }
+
+  /// Returns a view of the value if the option is a `Some`, else `None`.
+  [[nodiscard]] auto get() const noexcept -> Option<view_type<T>> {
+    if (is_some()) {
+      return Some(Layout<Option<T>>::payload(data_));
+    } else {
+      return None;
+    }
+  }
+
+  template <typename SomeFn, typename NoneFn>
+  requires invocable<SomeFn&&, view_type<T>>&& invocable<NoneFn&&>  //
+      [[nodiscard]] auto match(SomeFn&& some_fn, NoneFn&& none_fn) const
+      -> invoke_result<SomeFn&&, view_type<T>> {
+    if (is_some()) {
+      return std::forward<SomeFn&&>(some_fn)(
+          Layout<Option<T>>::payload(data_));
+    } else {
+      return std::forward<NoneFn&&>(none_fn)();
+    }
+  }
+
+ private:
+  std::byte const* data_;
+};
+
+/// A view of an encoded `Result<T, E>`, reading the value or error in place.
+template <Encodable T, Encodable E>
+class ResultView {
+ public:
+  explicit constexpr ResultView(std::byte const* data) noexcept
+      : data_{data} {}
+
+  [[nodiscard]] bool is_ok() const noexcept {
+    return internal::binary::load_tag(data_) == 0;
+  }
+
+  [[nodiscard]] bool is_err() const noexcept { return !is_ok(); }
+
+  /// Returns a view of the value if the result is an `Ok`, else `None`.
+  [[nodiscard]] auto ok() const noexcept -> Option<view_type<T>> {
+    if (is_ok()) {
+      return Some(Layout<T>::view(data_ + Layout<Result<T, E>>::kOffset));
+    } else {
+      return None;
+    }
+  }
+
+  /// Returns a view of the error if the result is an `Err`, else `None`.
+  [[nodiscard]] auto err() const noexcept -> Option<view_type<E>> {
+    if (is_ok()) {
+      return None;
+    } else {
+      return Some(Layout<E>::view(data_ + Layout<Result<T, E>>::kOffset));
+    }
+  }
+
+  template <typename OkFn, typename ErrFn>
+  requires invocable<OkFn&&, view_type<T>>&&
+      invocable<ErrFn&&, view_type<E>>  //
+      [[nodiscard]] auto match(OkFn&& ok_fn, ErrFn&& err_fn) const
+      -> invoke_result<OkFn&&, view_type<T>> {
+    std::byte const* payload = data_ + Layout<Result<T, E>>::kOffset;
+    if (is_ok()) {
+      return std::forward<OkFn&&>(ok_fn)(Layout<T>::view(payload));
+    } else {
+      return std::forward<ErrFn&&>(err_fn)(Layout<E>::view(payload));
+    }
+  }
+
+ private:
+  std::byte const* data_;
+};
+
+template <internal::binary::Primitive T>
+struct Layout<T> {
+  static constexpr size_t kAlign = sizeof(T);
+
+  static constexpr size_t size(T const&) noexcept { return sizeof(T); }
+
+  static void write(T const& value, std::byte* out) noexcept {
+    internal::binary::store(value, out);
+  }
+
+  static auto validate(std::byte const* in, size_t size) noexcept
+      -> Result<size_t, Error> {
+    if (size < sizeof(T)) return Err(Error::BufferTooSmall);
+    if constexpr (std::is_same_v<T, bool>) {
+      if (internal::binary::load_tag(in) > 1) return Err(Error::InvalidValue);
+    }
+    return Ok(sizeof(T));
+  }
+
+  static T read(std::byte const* in) noexcept {
+    return internal::binary::load<T>(in);
+  }
+
+  static T view(std::byte const* in) noexcept { return read(in); }
+};
+
+template <Encodable T>
+struct Layout<Option<T>> {
+  static constexpr size_t kAlign = Layout<T>::kAlign;
+  static constexpr size_t kOffset = internal::binary::align_up(1, kAlign);
+
+  static constexpr size_t size(Option<T> const& option) noexcept {
+    return option.is_some() ? kOffset + Layout<T>::size(option.value()) : 1;
+  }
+
+  static void write(Option<T> const& option, std::byte* out) noexcept {
+    if (option.is_some()) {
+      internal::binary::store_tag(1, kOffset, out);
+      Layout<T>::write(option.value(), out + kOffset);
+    } else {
+      internal::binary::store_tag(0, 1, out);
+    }
+  }
+
+  static auto validate(std::byte const* in, size_t size) noexcept
+      -> Result<size_t, Error> {
+    if (size < 1) return Err(Error::BufferTooSmall);
+    switch (internal::binary::load_tag(in)) {
+      case 0:
+        return Ok(size_t{1});
+      case 1: {
+        if (size < kOffset) return Err(Error::BufferTooSmall);
+        return Layout<T>::validate(in + kOffset, size - kOffset)
+            .map([](size_t payload_size) { return kOffset + payload_size; });
+      }
+      default:
+        return Err(Error::InvalidTag);
+    }
+  }
+
+  static auto read(std::byte const* in) -> Option<T> {
+    if (internal::binary::load_tag(in) == 1) {
+      return Some(Layout<T>::read(in + kOffset));
+    } else {
+      return None;
+    }
+  }
+
+  static auto view(std::byte const* in) noexcept -> OptionView<T> {
+    return OptionView<T>(in);
+  }
+
+  static auto payload(std::byte const* in) noexcept -> view_type<T> {
+    return Layout<T>::view(in + kOffset);
+  }
+};
+
+template <Encodable T, Encodable E>
+struct Layout<Result<T, E>> {
+  static constexpr size_t kAlign = Layout<T>::kAlign > Layout<E>::kAlign
+                                       ? Layout<T>::kAlign
+                                       : Layout<E>::kAlign;
+  static constexpr size_t kOffset = internal::binary::align_up(1, kAlign);
+
+  static constexpr size_t size(Result<T, E> const& result) noexcept {
+    return kOffset + (result.is_ok() ? Layout<T>::size(result.value())
+                                     : Layout<E>::size(result.err_value()));
+  }
+
+  static void write(Result<T, E> const& result, std::byte* out) noexcept {
+    if (result.is_ok()) {
+      internal::binary::store_tag(0, kOffset, out);
+      Layout<T>::write(result.value(), out + kOffset);
+    } else {
+      internal::binary::store_tag(1, kOffset, out);
+      Layout<E>::write(result.err_value(), out + kOffset);
+    }
+  }
+
+  static auto validate(std::byte const* in, size_t size) noexcept
+      -> Result<size_t, Error> {
+    if (size < kOffset) return Err(Error::BufferTooSmall);
+    switch (internal::binary::load_tag(in)) {
+      case 0: {
+        return Layout<T>::validate(in + kOffset, size - kOffset)
+            .map([](size_t value_size) { return kOffset + value_size; });
+      }
+      case 1: {
+        return Layout<E>::validate(in + kOffset, size - kOffset)
+            .map([](size_t err_size) { return kOffset + err_size; });
+      }
+      default:
+        return Err(Error::InvalidTag);
+    }
+  }
+
+  static auto read(std::byte const* in) -> Result<T, E> {
+    if (internal::binary::load_tag(in) == 0) {
+      return Ok(Layout<T>::read(in + kOffset));
+    } else {
+      return Err(Layout<E>::read(in + kOffset));
+    }
+  }
+
+  static auto view(std::byte const* in) noexcept -> ResultView<T, E> {
+    return ResultView<T, E>(in);
+  }
+};
+
+template <>
+struct Layout<Report> {
+  static constexpr size_t kAlign = sizeof(uint32_t);
+
+  static size_t size(Report const& report) noexcept {
+    return sizeof(uint32_t) + report.what().size();
+  }
+
+  static void write(Report const& report, std::byte* out) noexcept {
+    std::string_view what = report.what();
+    internal::binary::store(static_cast<uint32_t>(what.size()), out);
+    std::memcpy(out + sizeof(uint32_t), what.data(), what.size());
+  }
+
+  static auto validate(std::byte const* in, size_t size) noexcept
+      -> Result<size_t, Error> {
+    if (size < sizeof(uint32_t)) return Err(Error::BufferTooSmall);
+    size_t length = internal::binary::load<uint32_t>(in);
+    if (size - sizeof(uint32_t) < length) return Err(Error::BufferTooSmall);
+    return Ok(sizeof(uint32_t) + length);
+  }
+
+  static auto read(std::byte const* in) noexcept -> Report {
+    return Report(view(in));
+  }
+
+  static auto view(std::byte const* in) noexcept -> std::string_view {
+    return std::string_view(reinterpret_cast<char const*>(in + sizeof(uint32_t)),
+                            internal::binary::load<uint32_t>(in));
+  }
+};
+
+/// Returns the size of `value`'s encoding.
+template <Encodable T>
+[[nodiscard]] size_t encoded_size(T const& value) noexcept {
+  return Layout<T>::size(value);
+}
+
+/// Encodes `value` into `out`, returns the number of bytes written.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// std::array<std::byte, 16> buffer;
+/// Option<int32_t> x = Some(7);
+/// ASSERT_EQ(binary::encode(x, buffer), Ok(8UL));
+/// ```
+template <Encodable T>
+[[nodiscard]] auto encode(T const& value, std::span<std::byte> out) noexcept
+    -> Result<size_t, Error> {
+  size_t size = Layout<T>::size(value);
+  if (out.size() < size) return Err(Error::BufferTooSmall);
+  Layout<T>::write(value, out.data());
+  return Ok(std::move(size));
+}
+
+/// Decodes a `T` from `in`.
+template <Encodable T>
+[[nodiscard]] auto decode(std::span<std::byte const> in) -> Result<T, Error> {
+  return Layout<T>::validate(in.data(), in.size()).map([&](size_t) {
+    return Layout<T>::read(in.data());
+  });
+}
+
+/// Validates the encoded `T` in `in` and returns a view that reads it in
+/// place. `in` must outlive the view.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// auto view = binary::view<Option<int32_t>>(bytes).unwrap();
+/// ASSERT_EQ(view.get(), Some(7));
+/// ```
+template <Encodable T>
+[[nodiscard]] auto view(std::span<std::byte const> in) noexcept
+    -> Result<view_type<T>, Error> {
+  return Layout<T>::validate(in.data(), in.size()).map([&](size_t) {
+    return Layout<T>::view(in.data());
+  });
+}
+
+}  // namespace binary
+}  // namespace stx
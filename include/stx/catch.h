@@ -0,0 +1,122 @@
+/**
+ * @file catch.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-10
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "stx/enum.h"
+#include "stx/result.h"
+
+//! ### Bridging exceptions
+//!
+//! `catch_result<E...>(fn)` invokes `fn` and maps the listed exception types
+//! into the error types of a `Result`, so code that throws can be called from
+//! code that uses `Result` without hand-written `try`/`catch` blocks. Exceptions
+//! that are not listed propagate as usual.
+//!
+//! ``` cpp
+//! Result<int, std::invalid_argument, std::out_of_range> value =
+//!     catch_result<std::invalid_argument, std::out_of_range>(
+//!         [&] { return std::stoi(input); });
+//! ```
+//!
+//! If `fn` is `noexcept`, no `try` block is entered at all and `catch_result`
+//! is itself `noexcept`.
+
+namespace stx {
+
+/// value type of the `Result` returned by `catch_result` for a function
+/// returning `void`
+using Unit = std::monostate;
+
+namespace internal {
+namespace catch_result {
+
+template <typename Fn>
+using value_type = std::conditional_t<std::is_void_v<invoke_result<Fn&>>, Unit,
+                                      invoke_result<Fn&>>;
+
+template <typename R, typename Fn>
+STX_FORCE_INLINE R invoke_ok(Fn& fn) {
+  if constexpr (std::is_void_v<invoke_result<Fn&>>) {
+    std::invoke(fn);
+    return Ok(Unit{});
+  } else {
+    return Ok(std::invoke(fn));
+  }
+}
+
+// catches `Es[I]`, and `Es[I - 1] ... Es[0]` in the nested calls. `Es[0]` is
+// thus caught in the innermost `try` block, so the exception types are matched
+// in the order they are listed, as a sequence of `catch` clauses would.
+template <typename R, size_t I, typename Fn, typename... Es>
+R catch_from(Fn& fn) {
+  using E = enum_::TypeAt<I, Es...>;
+  try {
+    if constexpr (I == 0) {
+      return invoke_ok<R>(fn);
+    } else {
+      return catch_from<R, I - 1, Fn, Es...>(fn);
+    }
+  } catch (E& error) {
+    return Err(std::move(error));
+  }
+}
+
+}  // namespace catch_result
+}  // namespace internal
+
+/// Invokes `fn` and returns its result as `Ok`, or an exception of one of
+/// `Es` thrown by it as `Err`. Exceptions of other types propagate. The
+/// exception types are matched in the order they are listed, as with a
+/// sequence of `catch` clauses, so a derived type must be listed before its
+/// base type. If `fn` returns `void`, the `Ok` value is `Unit`.
+///
+/// If `fn` is `noexcept` (or exceptions are disabled), `fn` is invoked
+/// directly without entering a `try` block, and `catch_result` is `noexcept`.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// auto parsed = catch_result<std::invalid_argument>(
+///     [] { return std::stoi("x"); });
+/// ASSERT_TRUE(parsed.is_err());
+///
+/// auto length = catch_result<std::length_error>(
+///     []() noexcept { return 42; });
+/// ASSERT_EQ(length, Ok(42));
+/// ```
+template <typename E, typename... Es, typename Fn>
+requires invocable<Fn&> [[nodiscard]] auto catch_result(Fn&& fn) noexcept(
+    std::is_nothrow_invocable_v<Fn&>)
+    -> Result<internal::catch_result::value_type<Fn>, E, Es...> {
+  using result_type = Result<internal::catch_result::value_type<Fn>, E, Es...>;
+
+#ifdef __cpp_exceptions
+  if constexpr (!std::is_nothrow_invocable_v<Fn&>) {
+    return internal::catch_result::catch_from<result_type, sizeof...(Es), Fn,
+                                              E, Es...>(fn);
+  } else {
+    return internal::catch_result::invoke_ok<result_type>(fn);
+  }
+#else
+  return internal::catch_result::invoke_ok<result_type>(fn);
+#endif
+}
+
+};  // namespace stx
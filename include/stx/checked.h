@@ -0,0 +1,257 @@
+/**
+ * @file checked.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#include "stx/option.h"
+#include "stx/result.h"
+
+#if !CFG(COMPILER, GNUC) && !CFG(COMPILER, CLANG)
+#error Checked arithmetic requires the `__builtin_*_overflow` compiler builtins, which are not available on this compiler.
+#endif
+
+//! ### Checked arithmetic
+//!
+//! Integer operations that return `None` (or an `Err`) instead of overflowing,
+//! built on the compiler's overflow-checking builtins, which compile to the
+//! operation and a branch on the CPU's overflow flag.
+//!
+//! ``` cpp
+//! ASSERT_EQ(checked_add<int8_t>(100, 27), Some<int8_t>(127));
+//! ASSERT_EQ(checked_add<int8_t>(100, 28), None);
+//! ASSERT_EQ(checked_div(1, 0), Err(ArithError::DivisionByZero));
+//! ASSERT_EQ(checked_cast<uint8_t>(-1), None);
+//! ```
+//!
+//! The span-level `checked_sum`, `checked_dot` and `checked_divide_each` check
+//! whole blocks of elements at once using AVX2 (selected at runtime) or NEON,
+//! and report the index of the first element at which the operation fails.
+
+namespace stx {
+
+/// Error type for checked arithmetic
+enum class ArithError : uint8_t {
+  /// the result does not fit in the type
+  Overflow,
+  /// the divisor is zero
+  DivisionByZero
+};
+
+/// Error type for the span-level checked operations, `index` is the index of
+/// the first element at which the operation failed.
+struct ArithErrorAt {
+  ArithError error;
+  size_t index;
+
+  [[nodiscard]] constexpr bool operator==(ArithErrorAt const&) const = default;
+};
+
+/// integral types, except `bool`
+template <typename T>
+concept CheckedInteger = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+/// Checked integer addition. Returns `None` if `a + b` overflows.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// ASSERT_EQ(checked_add<uint8_t>(250, 5), Some<uint8_t>(255));
+/// ASSERT_EQ(checked_add<uint8_t>(250, 6), None);
+/// ```
+template <CheckedInteger T>
+[[nodiscard]] STX_FORCE_INLINE constexpr auto checked_add(T a, T b) noexcept
+    -> Option<T> {
+  T result;
+  if (__builtin_add_overflow(a, b, &result)) return None;
+  return Some(std::move(result));
+}
+
+/// Checked integer subtraction. Returns `None` if `a - b` overflows.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// ASSERT_EQ(checked_sub<uint32_t>(1, 1), Some<uint32_t>(0));
+/// ASSERT_EQ(checked_sub<uint32_t>(1, 2), None);
+/// ```
+template <CheckedInteger T>
+[[nodiscard]] STX_FORCE_INLINE constexpr auto checked_sub(T a, T b) noexcept
+    -> Option<T> {
+  T result;
+  if (__builtin_sub_overflow(a, b, &result)) return None;
+  return Some(std::move(result));
+}
+
+/// Checked integer multiplication. Returns `None` if `a * b` overflows.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// ASSERT_EQ(checked_mul<int16_t>(-128, 256), Some<int16_t>(-32768));
+/// ASSERT_EQ(checked_mul<int16_t>(128, 256), None);
+/// ```
+template <CheckedInteger T>
+[[nodiscard]] STX_FORCE_INLINE constexpr auto checked_mul(T a, T b) noexcept
+    -> Option<T> {
+  T result;
+  if (__builtin_mul_overflow(a, b, &result)) return None;
+  return Some(std::move(result));
+}
+
+/// Checked integer division. Returns `Err(ArithError::DivisionByZero)` if `b`
+/// is zero and `Err(ArithError::Overflow)` if the quotient does not fit in
+/// `T`, i.e. `INT_MIN / -1`.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// ASSERT_EQ(checked_div(7, 2), Ok(3));
+/// ASSERT_EQ(checked_div(7, 0), Err(ArithError::DivisionByZero));
+/// ASSERT_EQ(checked_div(INT_MIN, -1), Err(ArithError::Overflow));
+/// ```
+template <CheckedInteger T>
+[[nodiscard]] STX_FORCE_INLINE constexpr auto checked_div(T a, T b) noexcept
+    -> Result<T, ArithError> {
+  if (b == 0) return Err(ArithError::DivisionByZero);
+  if constexpr (std::is_signed_v<T>) {
+    if (a == std::numeric_limits<T>::min() && b == -1)
+      return Err(ArithError::Overflow);
+  }
+  return Ok(static_cast<T>(a / b));
+}
+
+/// Checked left shift. Returns `None` if `shift` is not less than the number
+/// of bits in `T`, or if shifting loses any significant bits, i.e. if
+/// `value * 2^shift` overflows.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// ASSERT_EQ(checked_shl<uint8_t>(1, 7), Some<uint8_t>(128));
+/// ASSERT_EQ(checked_shl<uint8_t>(2, 7), None);
+/// ASSERT_EQ(checked_shl<int8_t>(1, 7), None);
+/// ```
+template <CheckedInteger T>
+[[nodiscard]] STX_FORCE_INLINE constexpr auto checked_shl(
+    T value, uint32_t shift) noexcept -> Option<T> {
+  using U = std::make_unsigned_t<T>;
+  if (shift >= static_cast<uint32_t>(std::numeric_limits<U>::digits))
+    return None;
+  T result;
+  if (__builtin_mul_overflow(value, static_cast<U>(U{1} << shift), &result))
+    return None;
+  return Some(std::move(result));
+}
+
+/// Checked integer conversion. Returns `None` if `value` is not representable
+/// as a `To`.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// ASSERT_EQ(checked_cast<uint8_t>(255), Some<uint8_t>(255));
+/// ASSERT_EQ(checked_cast<uint8_t>(256), None);
+/// ASSERT_EQ(checked_cast<uint32_t>(-1), None);
+/// ```
+template <CheckedInteger To, CheckedInteger From>
+[[nodiscard]] STX_FORCE_INLINE constexpr auto checked_cast(From value) noexcept
+    -> Option<To> {
+  To result;
+  if (__builtin_add_overflow(value, From{0}, &result)) return None;
+  return Some(std::move(result));
+}
+
+/// Sums `values` from left to right, returns an error with the index of the
+/// first element whose addition overflows.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// std::vector<int32_t> a{1, 2, 3};
+/// ASSERT_EQ(checked_sum(a), Ok(6));
+///
+/// std::vector<int32_t> b{INT32_MAX, 1, -1};
+/// ASSERT_EQ(checked_sum(b), Err(ArithErrorAt{ArithError::Overflow, 1}));
+/// ```
+[[nodiscard]] auto checked_sum(std::span<int32_t const> values) noexcept
+    -> Result<int32_t, ArithErrorAt>;
+
+[[nodiscard]] auto checked_sum(std::span<int64_t const> values) noexcept
+    -> Result<int64_t, ArithErrorAt>;
+
+/// Computes the dot product `a[0] * b[0] + a[1] * b[1] + ...` from left to
+/// right, returns an error with the index of the first element whose product
+/// or addition overflows. Only the first `min(a.size(), b.size())` elements
+/// are used.
+[[nodiscard]] auto checked_dot(std::span<int32_t const> a,
+                               std::span<int32_t const> b) noexcept
+    -> Result<int32_t, ArithErrorAt>;
+
+[[nodiscard]] auto checked_dot(std::span<int64_t const> a,
+                               std::span<int64_t const> b) noexcept
+    -> Result<int64_t, ArithErrorAt>;
+
+/// Divides each of `numerators` by the corresponding element of
+/// `denominators` into `out`, returns the written part of `out`, else an
+/// error with the index of the first element whose division fails. On error,
+/// the quotients before that index have been written.
+///
+/// Only the first `min(numerators.size(), denominators.size(), out.size())`
+/// elements are divided.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// std::array<double, 3> num{1.0, 2.0, 3.0};
+/// std::array<double, 3> den{2.0, 0.0, 1.0};
+/// std::array<double, 3> out;
+/// ASSERT_EQ(checked_divide_each(num, den, out).unwrap_err(),
+///           (ArithErrorAt{ArithError::DivisionByZero, 1}));
+/// ASSERT_EQ(out[0], 0.5);
+/// ```
+[[nodiscard]] auto checked_divide_each(std::span<int32_t const> numerators,
+                                       std::span<int32_t const> denominators,
+                                       std::span<int32_t> out) noexcept
+    -> Result<std::span<int32_t>, ArithErrorAt>;
+
+[[nodiscard]] auto checked_divide_each(std::span<int64_t const> numerators,
+                                       std::span<int64_t const> denominators,
+                                       std::span<int64_t> out) noexcept
+    -> Result<std::span<int64_t>, ArithErrorAt>;
+
+[[nodiscard]] auto checked_divide_each(std::span<double const> numerators,
+                                       std::span<double const> denominators,
+                                       std::span<double> out) noexcept
+    -> Result<std::span<double>, ArithErrorAt>;
+
+};  // namespace stx
@@ -225,6 +225,18 @@
 #endif
 #endif
 
+// marks a code path the program can never take, i.e. the default case of an
+// exhaustive switch
+#if CFG(COMPILER, GNUC) || CFG(COMPILER, CLANG)
+#define STX_UNREACHABLE() __builtin_unreachable()
+#else
+#if CFG(COMPILER, MSVC)
+#define STX_UNREACHABLE() __assume(0)
+#else
+#define STX_UNREACHABLE() (void)0
+#endif
+#endif
+
 /*********************** ATTRIBUTE REQUIREMENTS ***********************/
 
 #if !__has_cpp_attribute(nodiscard)
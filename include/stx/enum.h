@@ -0,0 +1,416 @@
+/**
+ * @file enum.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-04
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "stx/option.h"
+
+namespace stx {
+
+namespace internal {
+namespace enum_ {
+
+/// number of occurences of `T` in `Ts`
+template <typename T, typename... Ts>
+constexpr size_t count_of = (size_t{std::is_same_v<T, Ts>} + ... + 0);
+
+/// index of the first occurence of `T` in `Ts`
+template <typename T, typename... Ts>
+struct IndexOf;
+
+template <typename T, typename... Ts>
+struct IndexOf<T, T, Ts...> : std::integral_constant<size_t, 0> {};
+
+template <typename T, typename U, typename... Ts>
+struct IndexOf<T, U, Ts...>
+    : std::integral_constant<size_t, 1 + IndexOf<T, Ts...>::value> {};
+
+template <size_t I, typename... Ts>
+using TypeAt = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+/// the smallest unsigned integral type that can index `N` alternatives
+template <size_t N>
+using tag_type = std::conditional_t<
+    (N <= size_t{std::numeric_limits<uint8_t>::max()} + 1), uint8_t,
+    std::conditional_t<(N <= size_t{std::numeric_limits<uint16_t>::max()} + 1),
+                       uint16_t, uint32_t>>;
+
+/// recursive union holding one of `Ts`. It is trivially destructible and
+/// trivially copyable if all of `Ts` are.
+template <typename... Ts>
+union Storage;
+
+template <>
+union Storage<> {};
+
+template <typename T, typename... Ts>
+union Storage<T, Ts...> {
+  constexpr Storage() noexcept {}
+
+  template <typename... Args>
+  constexpr explicit Storage(std::in_place_index_t<0>, Args&&... args)
+      : head(std::forward<Args>(args)...) {}
+
+  template <size_t I, typename... Args>
+  requires(I > 0)  //
+      constexpr explicit Storage(std::in_place_index_t<I>, Args&&... args)
+      : tail(std::in_place_index<I - 1>, std::forward<Args>(args)...) {}
+
+  constexpr ~Storage() requires(std::is_trivially_destructible_v<T>&&... &&
+                                    std::is_trivially_destructible_v<Ts>) =
+      default;
+
+  constexpr ~Storage() {}
+
+  T head;
+  Storage<Ts...> tail;
+};
+
+template <size_t I, typename S>
+[[nodiscard]] STX_FORCE_INLINE constexpr auto& get(S& storage) noexcept {
+  if constexpr (I == 0) {
+    return storage.head;
+  } else {
+    return get<I - 1>(storage.tail);
+  }
+}
+
+// Calls `f` with `std::integral_constant<size_t, index>`. The cases are
+// expanded into a dense switch so the compiler can lower it to a jump table
+// and inline every arm, unlike a table of function pointers.
+#define STX_ENUM_DISPATCH_CASE(I)                                         \
+  case Offset + I:                                                        \
+    if constexpr (Offset + I < N) {                                       \
+      return std::forward<F>(f)(std::integral_constant<size_t, Offset + I>{}); \
+    } else {                                                              \
+      STX_UNREACHABLE();                                                  \
+    }
+
+template <size_t N, typename R, size_t Offset = 0, typename F>
+STX_FORCE_INLINE constexpr R dispatch(size_t index, F&& f) {
+  switch (index) {
+    STX_ENUM_DISPATCH_CASE(0)
+    STX_ENUM_DISPATCH_CASE(1)
+    STX_ENUM_DISPATCH_CASE(2)
+    STX_ENUM_DISPATCH_CASE(3)
+    STX_ENUM_DISPATCH_CASE(4)
+    STX_ENUM_DISPATCH_CASE(5)
+    STX_ENUM_DISPATCH_CASE(6)
+    STX_ENUM_DISPATCH_CASE(7)
+    STX_ENUM_DISPATCH_CASE(8)
+    STX_ENUM_DISPATCH_CASE(9)
+    STX_ENUM_DISPATCH_CASE(10)
+    STX_ENUM_DISPATCH_CASE(11)
+    STX_ENUM_DISPATCH_CASE(12)
+    STX_ENUM_DISPATCH_CASE(13)
+    STX_ENUM_DISPATCH_CASE(14)
+    STX_ENUM_DISPATCH_CASE(15)
+    default:
+      if constexpr (Offset + 16 < N) {
+        return dispatch<N, R, Offset + 16>(index, std::forward<F>(f));
+      } else {
+        STX_UNREACHABLE();
+      }
+  }
+}
+
+#undef STX_ENUM_DISPATCH_CASE
+
+}  // namespace enum_
+}  // namespace internal
+
+/// A sum type holding exactly one value of one of the alternative types `Ts`
+/// at any point in time. It is the generalization of `Result<T, E>` to any
+/// number of alternatives.
+///
+/// Like `Result<T, E>`, it is a union of the alternatives and a tag. The tag
+/// is the smallest unsigned integer able to index the alternatives (a single
+/// byte for up to 256 alternatives), and `Enum` is trivially copyable and
+/// trivially destructible whenever all of its alternatives are.
+///
+/// The alternatives are required to be nothrow move-constructible, `Enum`
+/// thus never ends up without a value (unlike `std::variant`'s
+/// `valueless_by_exception` state) and does not need to check for it.
+///
+/// `match` is exhaustive: it must be given exactly one function per
+/// alternative, and it dispatches via a switch the compiler lowers to a jump
+/// table.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// struct Ping { int seq; };
+/// struct Data { string payload; };
+/// struct Close {};
+///
+/// using Message = Enum<Ping, Data, Close>;
+///
+/// Message msg = Data{"hello"s};
+///
+/// auto size = move(msg).match([](Ping) { return 0UL; },
+///                             [](Data d) { return d.payload.size(); },
+///                             [](Close) { return 0UL; });
+/// ASSERT_EQ(size, 5UL);
+/// ```
+template <typename... Ts>
+class [[nodiscard]] Enum {
+  static_assert(sizeof...(Ts) > 0, "Enum must have at least one alternative");
+
+  static_assert((!std::is_reference_v<Ts> && ...),
+                "Cannot use T& nor T&& for type, To prevent subtleties use "
+                "type wrappers like std::reference_wrapper or any of the "
+                "`stx::ConstRef` or `stx::MutRef` specialized aliases instead");
+
+  static_assert((std::is_nothrow_move_constructible_v<Ts> && ...),
+                "Enum's alternatives must be nothrow move-constructible so "
+                "that the Enum can never be left without a value");
+
+  static constexpr bool kTriviallyCopyable =
+      (std::is_trivially_copyable_v<Ts> && ...);
+
+  static constexpr bool kTriviallyDestructible =
+      (std::is_trivially_destructible_v<Ts> && ...);
+
+ public:
+  /// number of alternatives
+  static constexpr size_t kAlternatives = sizeof...(Ts);
+
+  using index_type = internal::enum_::tag_type<kAlternatives>;
+
+  template <size_t I>
+  using alternative = internal::enum_::TypeAt<I, Ts...>;
+
+  /// constructs the `Enum` with the alternative of type `T`. `T` must appear
+  /// exactly once in `Ts` and `value` must be an r-value.
+  template <typename T>
+  requires(internal::enum_::count_of<T, Ts...> == 1)  //
+      [[nodiscard]] constexpr Enum(T&& value)           // NOLINT
+      : storage_(std::in_place_index<internal::enum_::IndexOf<T, Ts...>::value>,
+                 std::move(value)),
+        index_(internal::enum_::IndexOf<T, Ts...>::value) {}
+
+  /// constructs the `I`-th alternative in-place from `args`.
+  template <size_t I, typename... Args>
+  requires(I < kAlternatives) &&
+      std::is_constructible_v<alternative<I>, Args&&...>  //
+      [[nodiscard]] constexpr explicit Enum(std::in_place_index_t<I>,
+                                            Args&&... args)
+      : storage_(std::in_place_index<I>, std::forward<Args>(args)...),
+        index_(I) {}
+
+  [[nodiscard]] constexpr Enum(Enum&&) noexcept requires kTriviallyCopyable =
+      default;
+
+  [[nodiscard]] constexpr Enum(Enum&& rhs) noexcept
+      : storage_(), index_(rhs.index_) {
+    construct_from_(std::move(rhs));
+  }
+
+  constexpr Enum& operator=(Enum&&) noexcept requires kTriviallyCopyable =
+      default;
+
+  constexpr Enum& operator=(Enum&& rhs) noexcept {
+    if (this != &rhs) {
+      destroy_();
+      index_ = rhs.index_;
+      construct_from_(std::move(rhs));
+    }
+    return *this;
+  }
+
+  Enum() = delete;
+  Enum(Enum const&) = delete;
+  Enum& operator=(Enum const&) = delete;
+
+  constexpr ~Enum() noexcept requires kTriviallyDestructible = default;
+
+  constexpr ~Enum() noexcept { destroy_(); }
+
+  /// Returns the index of the alternative held.
+  [[nodiscard]] constexpr size_t index() const noexcept { return index_; }
+
+  /// Returns `true` if the `Enum` holds the alternative of type `T`.
+  template <typename T>
+  requires(internal::enum_::count_of<T, Ts...> == 1)  //
+      [[nodiscard]] constexpr bool is() const noexcept {
+    return index_ == internal::enum_::IndexOf<T, Ts...>::value;
+  }
+
+  /// Returns a mutable reference to the held value if the `Enum` holds the
+  /// alternative of type `T`, else returns `None`.
+  ///
+  /// # Examples
+  ///
+  /// Basic usage:
+  ///
+  /// ``` cpp
+  /// Enum<int, string> x = "hello"s;
+  /// ASSERT_EQ(x.get<int>(), None);
+  ///
+  /// x.get<string>().unwrap().get() = "bye"s;
+  /// ASSERT_EQ(x.get<string>(), Some("bye"s));
+  /// ```
+  template <typename T>
+  requires(internal::enum_::count_of<T, Ts...> == 1)  //
+      [[nodiscard]] constexpr auto get() & noexcept -> Option<MutRef<T>> {
+    constexpr size_t I = internal::enum_::IndexOf<T, Ts...>::value;
+    if (index_ == I) {
+      return Some(MutRef<T>(internal::enum_::get<I>(storage_)));
+    } else {
+      return None;
+    }
+  }
+
+  /// Returns a constant reference to the held value if the `Enum` holds the
+  /// alternative of type `T`, else returns `None`.
+  template <typename T>
+  requires(internal::enum_::count_of<T, Ts...> == 1)  //
+      [[nodiscard]] constexpr auto get() const& noexcept
+      -> Option<ConstRef<T>> {
+    constexpr size_t I = internal::enum_::IndexOf<T, Ts...>::value;
+    if (index_ == I) {
+      return Some(ConstRef<T>(internal::enum_::get<I>(storage_)));
+    } else {
+      return None;
+    }
+  }
+
+  template <typename T>
+  [[deprecated(
+      "calling Enum::get() on an r-value, and therefore binding a reference "
+      "to an object that is marked to be moved")]]  //
+  [[nodiscard]] constexpr auto
+  get() && noexcept -> Option<MutRef<T>> = delete;
+
+  /// Moves the held value into the function matching its alternative. The
+  /// `I`-th function is called with the `I`-th alternative and the return
+  /// type is that of the first function.
+  ///
+  /// # Examples
+  ///
+  /// Basic usage:
+  ///
+  /// ``` cpp
+  /// Enum<int, string, float> x = "hello"s;
+  /// auto len = move(x).match([](int) { return 0UL; },
+  ///                          [](string s) { return s.size(); },
+  ///                          [](float) { return 0UL; });
+  /// ASSERT_EQ(len, 5UL);
+  /// ```
+  template <typename... Fns>
+  [[nodiscard]] constexpr auto match(Fns&&... fns) && -> invoke_result<
+      internal::enum_::TypeAt<0, Fns&&...>, alternative<0>&&> {
+    static_assert(sizeof...(Fns) == kAlternatives,
+                  "Enum::match must be given exactly one function per "
+                  "alternative");
+    static_assert((invocable<Fns&&, Ts&&> && ...),
+                  "each function passed to Enum::match must be invocable with "
+                  "its alternative");
+
+    using R = invoke_result<internal::enum_::TypeAt<0, Fns&&...>,
+                            alternative<0>&&>;
+    auto fns_ = std::forward_as_tuple(std::forward<Fns>(fns)...);
+
+    return internal::enum_::dispatch<kAlternatives, R>(
+        index_, [&](auto i) -> R {
+          constexpr size_t I = decltype(i)::value;
+          return std::invoke(std::get<I>(std::move(fns_)),
+                             std::move(internal::enum_::get<I>(storage_)));
+        });
+  }
+
+  /// Calls the function matching the held alternative with a constant
+  /// reference to the held value.
+  template <typename... Fns>
+  [[nodiscard]] constexpr auto match(Fns&&... fns) const& -> invoke_result<
+      internal::enum_::TypeAt<0, Fns&&...>, alternative<0> const&> {
+    static_assert(sizeof...(Fns) == kAlternatives,
+                  "Enum::match must be given exactly one function per "
+                  "alternative");
+    static_assert((invocable<Fns&&, Ts const&> && ...),
+                  "each function passed to Enum::match must be invocable with "
+                  "its alternative");
+
+    using R = invoke_result<internal::enum_::TypeAt<0, Fns&&...>,
+                            alternative<0> const&>;
+    auto fns_ = std::forward_as_tuple(std::forward<Fns>(fns)...);
+
+    return internal::enum_::dispatch<kAlternatives, R>(
+        index_, [&](auto i) -> R {
+          constexpr size_t I = decltype(i)::value;
+          return std::invoke(std::get<I>(std::move(fns_)),
+                             internal::enum_::get<I>(storage_));
+        });
+  }
+
+  [[nodiscard]] constexpr bool operator==(Enum const& cmp) const
+      requires(equality_comparable<Ts>&&...) {
+    if (index_ != cmp.index_) return false;
+    return internal::enum_::dispatch<kAlternatives, bool>(
+        index_, [&](auto i) -> bool {
+          constexpr size_t I = decltype(i)::value;
+          return internal::enum_::get<I>(storage_) ==
+                 internal::enum_::get<I>(cmp.storage_);
+        });
+  }
+
+  [[nodiscard]] constexpr auto clone() const
+      -> Enum requires(copy_constructible<Ts>&&...) {
+    return internal::enum_::dispatch<kAlternatives, Enum>(
+        index_, [&](auto i) -> Enum {
+          constexpr size_t I = decltype(i)::value;
+          return Enum(std::in_place_index<I>,
+                      internal::enum_::get<I>(storage_));
+        });
+  }
+
+ private:
+  internal::enum_::Storage<Ts...> storage_;
+  index_type index_;
+
+  template <typename... Us>
+  friend class Enum;
+
+  template <Swappable Tp, Swappable Er, Swappable... Ers>
+  friend class Result;
+
+  // requires that `storage_` holds no value and `index_` is set to
+  // `rhs.index_`
+  constexpr void construct_from_(Enum&& rhs) noexcept {
+    internal::enum_::dispatch<kAlternatives, void>(index_, [&](auto i) {
+      constexpr size_t I = decltype(i)::value;
+      std::construct_at(std::addressof(internal::enum_::get<I>(storage_)),
+                        std::move(internal::enum_::get<I>(rhs.storage_)));
+    });
+  }
+
+  constexpr void destroy_() noexcept {
+    if constexpr (!kTriviallyDestructible) {
+      internal::enum_::dispatch<kAlternatives, void>(index_, [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        std::destroy_at(std::addressof(internal::enum_::get<I>(storage_)));
+      });
+    }
+  }
+};
+
+}  // namespace stx
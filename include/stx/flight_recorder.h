@@ -0,0 +1,235 @@
+/**
+ * @file flight_recorder.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-19
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "stx/config.h"
+
+#if CFG(ARCH, X86_64) && (CFG(COMPILER, GNUC) || CFG(COMPILER, CLANG))
+#include <x86intrin.h>
+#endif
+
+//! ### Flight recorder
+//!
+//! Each thread records what it is doing in a fixed-size ring of timestamped
+//! events, so that a panic report shows what the thread did just before it
+//! panicked, and not only where it panicked. `panic_default` and the backtrace
+//! signal handler append the thread's last `kFlightRecorderReportEvents`
+//! events to the report.
+//!
+//! ``` cpp
+//! void handle(Request const& request) {
+//!   FlightSpan span{"handle", request.id};
+//!   this_thread::record_event("parsed", request.size);
+//!   ...
+//! }
+//! ```
+//!
+//! Recording an event is a few stores into the thread's ring, with no locking
+//! and no allocation. Event names are string literals, so they are not copied.
+
+namespace stx {
+
+/// number of events kept per thread
+constexpr size_t kFlightRecorderCapacity = 128;
+
+/// number of the most recent events appended to a panic report
+constexpr size_t kFlightRecorderReportEvents = 16;
+
+static_assert((kFlightRecorderCapacity & (kFlightRecorderCapacity - 1)) == 0,
+              "the flight recorder's capacity must be a power of two");
+
+enum class FlightEventKind : uint8_t {
+  /// a point event
+  Event,
+  /// the start of a `FlightSpan`
+  SpanBegin,
+  /// the end of a `FlightSpan`
+  SpanEnd
+};
+
+/// The name of a flight recorder event. It must be a string literal, or
+/// another string with static storage duration, which is checked at
+/// compile-time.
+struct FlightEventName {
+  template <size_t N>
+  consteval FlightEventName(char const (&name)[N]) : str{name} {}  // NOLINT
+
+  char const* str;
+};
+
+struct FlightEvent {
+  /// ticks of the thread's clock, see `flight_ticks`
+  uint64_t timestamp;
+  char const* name;
+  uint64_t value;
+  FlightEventKind kind;
+};
+
+/// The timestamp of flight recorder events: the CPU's time-stamp counter on
+/// x86-64 and AArch64, else nanoseconds of the steady clock. Only differences
+/// between timestamps are meaningful.
+STX_FORCE_INLINE uint64_t flight_ticks() noexcept {
+#if CFG(ARCH, X86_64) && (CFG(COMPILER, GNUC) || CFG(COMPILER, CLANG))
+  return __rdtsc();
+#elif CFG(ARCH, ARM64) && (CFG(COMPILER, GNUC) || CFG(COMPILER, CLANG))
+  uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+/// A ring of the most recent events of a thread. It is only written by its
+/// thread, and read by the same thread when it panics or handles a signal, so
+/// it needs no synchronization other than ordering the event before the count
+/// for signal handlers.
+class FlightRecorder {
+ public:
+  constexpr FlightRecorder() noexcept = default;
+
+  FlightRecorder(FlightRecorder const&) = delete;
+  FlightRecorder& operator=(FlightRecorder const&) = delete;
+
+  STX_FORCE_INLINE void record(FlightEventKind kind, char const* name,
+                               uint64_t value) noexcept {
+    events_[count_ & (kFlightRecorderCapacity - 1)] =
+        FlightEvent{flight_ticks(), name, value, kind};
+    std::atomic_signal_fence(std::memory_order_release);
+    count_++;
+  }
+
+  /// number of events recorded, including those overwritten
+  [[nodiscard]] uint64_t count() const noexcept { return count_; }
+
+  /// Calls `fn` on the (up to) `max` most recent events, oldest first.
+  template <typename Fn>
+  void for_each_recent(size_t max, Fn&& fn) const {
+    uint64_t count = count_;
+    std::atomic_signal_fence(std::memory_order_acquire);
+    uint64_t num = std::min<uint64_t>(
+        {count, static_cast<uint64_t>(max), kFlightRecorderCapacity});
+    for (uint64_t i = count - num; i < count; i++) {
+      fn(events_[i & (kFlightRecorderCapacity - 1)]);
+    }
+  }
+
+  /// forgets all events
+  void clear() noexcept { count_ = 0; }
+
+ private:
+  FlightEvent events_[kFlightRecorderCapacity] = {};
+  uint64_t count_ = 0;
+};
+
+namespace internal {
+namespace flight_recorder {
+
+inline thread_local constinit FlightRecorder thread_recorder;
+
+constexpr char const* kind_name(FlightEventKind kind) noexcept {
+  switch (kind) {
+    case FlightEventKind::SpanBegin:
+      return "begin";
+    case FlightEventKind::SpanEnd:
+      return "end";
+    default:
+      return "event";
+  }
+}
+
+/// Writes the thread's most recent events to `report`, which is a
+/// `ReportWriter` with a `write_number` member, like the default handler's.
+/// The timestamps are relative to the time of the report.
+template <typename Report>
+void write_recent_events(Report& report) noexcept {
+  FlightRecorder const& recorder = thread_recorder;
+  if (recorder.count() == 0) return;
+
+  uint64_t const now = flight_ticks();
+
+  report.write("\nFlight recorder (most recent ");
+  report.write_number(
+      std::min<uint64_t>(recorder.count(), kFlightRecorderReportEvents));
+  report.write(" of ");
+  report.write_number(recorder.count());
+  report.write(" events, oldest first):\n");
+
+  recorder.for_each_recent(kFlightRecorderReportEvents,
+                           [&report, now](FlightEvent const& event) {
+                             report.write("  -");
+                             report.write_number(now - event.timestamp);
+                             report.write(" ticks\t");
+                             report.write(kind_name(event.kind));
+                             report.write(" '");
+                             report.write(event.name);
+                             report.write("' ");
+                             report.write_number(event.value);
+                             report.write("\n");
+                           });
+}
+
+}  // namespace flight_recorder
+}  // namespace internal
+
+namespace this_thread {
+
+/// Records a point event with an optional `value` in the thread's flight
+/// recorder.
+STX_FORCE_INLINE void record_event(FlightEventName name,
+                                   uint64_t value = 0) noexcept {
+  internal::flight_recorder::thread_recorder.record(FlightEventKind::Event,
+                                                    name.str, value);
+}
+
+/// The flight recorder of the current thread.
+inline FlightRecorder& flight_recorder() noexcept {
+  return internal::flight_recorder::thread_recorder;
+}
+
+}  // namespace this_thread
+
+/// Records the beginning of a span in the thread's flight recorder, and its
+/// end when it goes out of scope, so a panic report shows the spans the
+/// thread was in when it panicked.
+class [[nodiscard]] FlightSpan {
+ public:
+  STX_FORCE_INLINE explicit FlightSpan(FlightEventName name,
+                                       uint64_t value = 0) noexcept
+      : name_{name.str}, value_{value} {
+    internal::flight_recorder::thread_recorder.record(
+        FlightEventKind::SpanBegin, name_, value_);
+  }
+
+  FlightSpan(FlightSpan const&) = delete;
+  FlightSpan& operator=(FlightSpan const&) = delete;
+
+  STX_FORCE_INLINE ~FlightSpan() noexcept {
+    internal::flight_recorder::thread_recorder.record(FlightEventKind::SpanEnd,
+                                                      name_, value_);
+  }
+
+ private:
+  char const* name_;
+  uint64_t value_;
+};
+
+};  // namespace stx
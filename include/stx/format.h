@@ -0,0 +1,164 @@
+/**
+ * @file format.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-12
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "stx/report.h"
+
+#ifdef STX_STABLE_LIB_SOURCE_LOCATION
+#include <source_location>
+#else
+#include <experimental/source_location>
+#endif
+
+//! ### Format strings
+//!
+//! `FormatString<Args...>` is a format string that is checked at compile-time
+//! against the arguments it is used with. `{}` is replaced with the next
+//! argument, and `{{` and `}}` with `{` and `}`. The arguments are formatted
+//! with `write_report`, so any type that is `ReportWritable` or `Reportable`
+//! can be used.
+//!
+//! ``` cpp
+//! panic_fmt("user {} shard {}", id, shard);      // ok
+//! panic_fmt("user {} shard {}", id);             // compile error
+//! ```
+//!
+//! `FormatArgs` refers to the format string and the arguments, and is only
+//! formatted when written into a `ReportWriter`. Nothing is formatted when it
+//! is created.
+
+namespace stx {
+
+#ifdef STX_STABLE_LIB_SOURCE_LOCATION
+using SourceLocation = std::source_location;
+#else
+using SourceLocation = std::experimental::source_location;
+#endif
+
+/// types that can be used as format arguments
+template <typename T>
+concept Formattable = ReportWritable<T> || Reportable<T>;
+
+namespace internal {
+namespace format {
+
+// not `constexpr`, calling these from the `consteval` constructor of
+// `FormatString` makes the compiler reject the format string, with the name
+// of the function in the error.
+void invalid_format_string_unmatched_brace();
+void invalid_format_string_unsupported_specifier();
+void invalid_format_string_argument_count_mismatch();
+
+/// number of `{}` placeholders in `format`, rejects the format string at
+/// compile-time if it is malformed.
+constexpr size_t count_placeholders(std::string_view format) {
+  size_t count = 0;
+  for (size_t i = 0; i < format.size(); i++) {
+    char c = format[i];
+    if (c == '{') {
+      if (i + 1 == format.size()) invalid_format_string_unmatched_brace();
+      if (format[i + 1] == '{') {
+        i++;
+      } else if (format[i + 1] == '}') {
+        count++;
+        i++;
+      } else {
+        invalid_format_string_unsupported_specifier();
+      }
+    } else if (c == '}') {
+      if (i + 1 == format.size() || format[i + 1] != '}')
+        invalid_format_string_unmatched_brace();
+      i++;
+    }
+  }
+  return count;
+}
+
+/// writes `format` from `offset` up to the next placeholder into `writer`,
+/// returns the offset past the placeholder.
+inline size_t write_literal(ReportWriter& writer, std::string_view format,
+                            size_t offset) noexcept {
+  size_t begin = offset;
+  while (offset < format.size()) {
+    char c = format[offset];
+    if (c == '{' && format[offset + 1] == '}') {
+      writer.write(format.substr(begin, offset - begin));
+      return offset + 2;
+    }
+    if (c == '{' || c == '}') {
+      // an escaped brace, write one of the pair
+      writer.write(format.substr(begin, offset - begin + 1));
+      offset += 2;
+      begin = offset;
+      continue;
+    }
+    offset++;
+  }
+  writer.write(format.substr(begin, offset - begin));
+  return offset;
+}
+
+}  // namespace format
+}  // namespace internal
+
+/// A format string for `Args`, checked at compile-time. It also holds the
+/// location of the call it is passed to, as a default argument can not follow
+/// the arguments.
+template <Formattable... Args>
+struct FormatString {
+  template <typename S>
+  requires std::is_convertible_v<S const&, std::string_view>
+  consteval FormatString(  // NOLINT
+      S const& format, SourceLocation location = SourceLocation::current())
+      : str{format}, location{location} {
+    if (internal::format::count_placeholders(str) != sizeof...(Args))
+      internal::format::invalid_format_string_argument_count_mismatch();
+  }
+
+  std::string_view str;
+  SourceLocation location;
+};
+
+/// A format string and references to its arguments. The arguments must
+/// outlive it.
+template <Formattable... Args>
+struct FormatArgs {
+  constexpr FormatArgs(std::string_view format, Args const&... args) noexcept
+      : format{format}, args{args...} {}
+
+  std::string_view format;
+  std::tuple<Args const&...> args;
+};
+
+template <typename... Args>
+ReportWriter& operator<<(ReportWriter& writer,
+                         FormatArgs<Args...> const& message) noexcept {
+  std::apply(
+      [&](Args const&... args) {
+        size_t offset = 0;
+        ((offset = internal::format::write_literal(writer, message.format,
+                                                   offset),
+          write_report(writer, args)),
+         ...);
+        internal::format::write_literal(writer, message.format, offset);
+      },
+      message.args);
+  return writer;
+}
+
+};  // namespace stx
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "stx/internal/panic_helpers.h"
 
 // Why so long? Option and Result depend on each other. I don't know of a
@@ -224,7 +226,7 @@ struct [[nodiscard]] Ok {
  private:
   T value_;
 
-  template <Swappable Tp, Swappable Err>
+  template <Swappable Tp, Swappable Er, Swappable... Ers>
   friend class Result;
 };
 
@@ -282,13 +284,73 @@ struct [[nodiscard]] Err {
  private:
   E value_;
 
-  template <Swappable Tp, Swappable Err>
+  template <Swappable Tp, Swappable Er, Swappable... Ers>
   friend class Result;
 };
 
-template <Swappable T, Swappable E>
+/// `Result<T, E>` has a single error type, `Result<T, E1, E2, ...>` (declared
+/// in "stx/result.h") has several error alternatives stored in the same union
+/// as the value.
+template <Swappable T, Swappable E, Swappable... Es>
 class [[nodiscard]] Result;
 
+namespace internal {
+namespace result {
+
+template <typename... Ts>
+struct TypeList {};
+
+/// appends each of `Ts` not already present to the type list `List`
+template <typename List, typename... Ts>
+struct AppendUnique;
+
+template <typename... Ls>
+struct AppendUnique<TypeList<Ls...>> {
+  using type = TypeList<Ls...>;
+};
+
+template <typename... Ls, typename T, typename... Ts>
+struct AppendUnique<TypeList<Ls...>, T, Ts...> {
+  using type = typename AppendUnique<
+      std::conditional_t<(std::is_same_v<T, Ls> || ...), TypeList<Ls...>,
+                         TypeList<Ls..., T>>,
+      Ts...>::type;
+};
+
+template <typename T, typename List>
+struct ResultOf;
+
+template <typename T, typename... Es>
+struct ResultOf<T, TypeList<Es...>> {
+  using type = Result<T, Es...>;
+};
+
+template <typename T>
+struct IsResult : std::false_type {};
+
+template <typename T, typename... Es>
+struct IsResult<Result<T, Es...>> : std::true_type {};
+
+/// the result type of `and_then` on a `Result<T, Es...>` whose function
+/// returns `R`. if `R` is itself a `Result<U, Fs...>`, it is flattened into a
+/// `Result<U, Es..., Fs...>` with the duplicate error types removed.
+template <typename R, typename... Es>
+struct AndThen {
+  using type = Result<R, Es...>;
+};
+
+template <typename U, typename... Fs, typename... Es>
+struct AndThen<Result<U, Fs...>, Es...> {
+  using type = typename ResultOf<
+      U, typename AppendUnique<TypeList<Es...>, Fs...>::type>::type;
+};
+
+template <typename R, typename... Es>
+using and_then_result = typename AndThen<R, Es...>::type;
+
+};  // namespace result
+};  // namespace internal
+
 //! Optional values.
 //!
 //! Type `Option` represents an optional value: every `Option`
@@ -543,7 +605,7 @@ class [[nodiscard]] Option {
   ///
   /// ASSERT_EQ(x, Some(2));
   /// ```
-  [[nodiscard]] T& value() & noexcept {
+  [[nodiscard]] T& value() & STX_PANIC_NOEXCEPT {
     if (is_none_) internal::option::no_lref();
     return value_ref_();
   }
@@ -565,7 +627,7 @@ class [[nodiscard]] Option {
   ///
   /// ASSERT_EQ(y, 9);
   /// ```
-  [[nodiscard]] T const& value() const& noexcept {
+  [[nodiscard]] T const& value() const& STX_PANIC_NOEXCEPT {
     if (is_none_) internal::option::no_lref();
     return value_cref_();
   }
@@ -659,6 +721,37 @@ class [[nodiscard]] Option {
     }
   }
 
+  /// Unwraps an option, yielding the content of a `Some`.
+  ///
+  /// # Panics
+  ///
+  /// Panics if the value is a `None` with a panic message formatted from
+  /// `format` and `args`, as with `panic_fmt`. The arguments are only
+  /// formatted if the option is a `None`.
+  ///
+  /// # Examples
+  ///
+  /// Basic usage:
+  ///
+  /// ``` cpp
+  /// Option x = Some("value"s);
+  /// ASSERT_EQ(move(x).expect_fmt("user {} shard {}", 42, 7), "value");
+  ///
+  /// Option<string> y = None;
+  /// move(y).expect_fmt("user {} shard {}", 42, 7); // panics with
+  ///                                                // user 42 shard 7
+  /// ```
+  template <typename... Args>
+  [[nodiscard]] auto expect_fmt(
+      FormatString<std::type_identity_t<Args>...> format,
+      Args const&... args) && -> T {
+    if (is_none()) {
+      internal::option::expect_value_failed_fmt(
+          FormatArgs<Args...>{format.str, args...}, std::move(format.location));
+    }
+    return std::move(value_ref_());
+  }
+
   /// Moves the value out of the `Option<T>` if it is in the variant state of
   /// `Some<T>`.
   ///
@@ -1404,6 +1497,51 @@ class [[nodiscard]] Option {
     }
   }
 
+  /// Returns the number of contained values, `1` if the `Option` is a `Some`
+  /// and `0` if it is a `None`.
+  ///
+  /// Together with `begin()` and `end()`, this makes `Option<T>` a sized,
+  /// contiguous range of at most one element that can be used with
+  /// range-based for loops and `std::ranges` algorithms.
+  ///
+  /// # Examples
+  ///
+  /// Basic usage:
+  ///
+  /// ``` cpp
+  /// Option x = Some(2);
+  /// ASSERT_EQ(x.size(), 1);
+  ///
+  /// int sum = 0;
+  /// for (int& v : x) sum += v;
+  /// ASSERT_EQ(sum, 2);
+  ///
+  /// Option<int> y = None;
+  /// ASSERT_EQ(y.size(), 0);
+  /// ASSERT_EQ(y.begin(), y.end());
+  /// ```
+  [[nodiscard]] constexpr size_t size() const noexcept {
+    return is_some() ? 1 : 0;
+  }
+
+  /// Returns a pointer to the contained value. It must not be dereferenced if
+  /// the `Option` is a `None`, in which case it equals `end()`.
+  [[nodiscard]] constexpr T* begin() noexcept {
+    return std::addressof(storage_value_);
+  }
+
+  [[nodiscard]] constexpr T const* begin() const noexcept {
+    return std::addressof(storage_value_);
+  }
+
+  /// Returns a pointer past the contained value if the `Option` is a `Some`,
+  /// else returns `begin()`.
+  [[nodiscard]] constexpr T* end() noexcept { return begin() + size(); }
+
+  [[nodiscard]] constexpr T const* end() const noexcept {
+    return begin() + size();
+  }
+
  private:
   union {
     T storage_value_;
@@ -1471,7 +1609,7 @@ class [[nodiscard]] Option {
 //! Result is either in the Ok or Err state at any point in time
 //!
 template <Swappable T, Swappable E>
-class [[nodiscard]] Result {
+class [[nodiscard]] Result<T, E> {
  public:
   static_assert(!std::is_reference_v<T>,
                 "Cannot use T& nor T&& for type, To prevent subtleties use "
@@ -1795,7 +1933,7 @@ class [[nodiscard]] Result {
   ///
   /// ASSERT_EQ(result, Ok(97));
   /// ```
-  [[nodiscard]] T& value() & noexcept {
+  [[nodiscard]] T& value() & STX_PANIC_NOEXCEPT {
     if (is_err()) internal::result::no_lref(err_cref_());
     return value_ref_();
   }
@@ -1817,7 +1955,7 @@ class [[nodiscard]] Result {
   ///
   /// ASSERT_EQ(value, 6);
   /// ```
-  [[nodiscard]] T const& value() const& noexcept {
+  [[nodiscard]] T const& value() const& STX_PANIC_NOEXCEPT {
     if (is_err()) internal::result::no_lref(err_cref_());
     return value_cref_();
   }
@@ -1845,7 +1983,7 @@ class [[nodiscard]] Result {
   ///
   /// ASSERT_EQ(result, Err(46));
   /// ```
-  [[nodiscard]] E& err_value() & noexcept {
+  [[nodiscard]] E& err_value() & STX_PANIC_NOEXCEPT {
     if (is_ok_) internal::result::no_err_lref(value_cref_());
     return err_ref_();
   }
@@ -1867,7 +2005,7 @@ class [[nodiscard]] Result {
   ///
   /// ASSERT_EQ(err, 9);
   /// ```
-  [[nodiscard]] E const& err_value() const& noexcept {
+  [[nodiscard]] E const& err_value() const& STX_PANIC_NOEXCEPT {
     if (is_ok_) internal::result::no_err_lref(value_cref_());
     return err_cref_();
   }
@@ -2161,6 +2299,9 @@ class [[nodiscard]] Result {
   ///
   /// This function can be used for control flow based on `Result` values.
   ///
+  /// If `op` returns a `Result<U, F...>` it is not nested, the error types are
+  /// instead merged into a flat `Result<U, E, F...>`.
+  ///
   /// # Examples
   ///
   /// Basic usage:
@@ -2173,14 +2314,22 @@ class [[nodiscard]] Result {
   ///
   /// ASSERT_EQ(make_ok(2).and_then(sq).and_then(sq), Ok(16));
   /// ASSERT_EQ(make_err(3).and_then(sq).and_then(sq), Err(3));
+  ///
+  /// auto parse = [](int x) -> Result<float, string> { return Ok(x * 0.5f); };
+  /// Result<float, int, string> r = make_ok(2).and_then(parse);
+  /// ASSERT_EQ(r, Ok(1.0f));
   /// ```
   template <typename Fn>
   requires invocable<Fn&&, T&&>  //
-      [[nodiscard]] constexpr auto and_then(
-          Fn&& op) && -> Result<invoke_result<Fn&&, T&&>, E> {
+      [[nodiscard]] constexpr auto and_then(Fn&& op) && -> internal::result::
+          and_then_result<invoke_result<Fn&&, T&&>, E> {
+    using output = invoke_result<Fn&&, T&&>;
     if (is_ok()) {
-      return Ok<invoke_result<Fn&&, T&&>>(
-          std::forward<Fn&&>(op)(std::move(value_ref_())));
+      if constexpr (internal::result::IsResult<output>::value) {
+        return std::forward<Fn&&>(op)(std::move(value_ref_()));
+      } else {
+        return Ok<output>(std::forward<Fn&&>(op)(std::move(value_ref_())));
+      }
     } else {
       return Err<E>(std::move(err_ref_()));
     }
@@ -2354,6 +2503,35 @@ class [[nodiscard]] Result {
     return std::move(value_ref_());
   }
 
+  /// Unwraps a result, yielding the content of an `Ok`.
+  ///
+  /// # Panics
+  ///
+  /// Panics if the value is an `Err`, with a panic message formatted from
+  /// `format` and `args`, as with `panic_fmt`, and the content of the `Err`.
+  /// The arguments are only formatted if the result is an `Err`.
+  ///
+  /// # Examples
+  ///
+  /// Basic usage:
+  ///
+  /// ``` cpp
+  /// Result<int, string_view> x = Err("emergency failure"sv);
+  /// move(x).expect_fmt("shard {}", 7); // panics with
+  ///                                    // shard 7: emergency failure
+  /// ```
+  template <typename... Args>
+  [[nodiscard]] auto expect_fmt(
+      FormatString<std::type_identity_t<Args>...> format,
+      Args const&... args) && -> T {
+    if (is_err()) {
+      internal::result::expect_value_failed_fmt(
+          FormatArgs<Args...>{format.str, args...}, err_cref_(),
+          std::move(format.location));
+    }
+    return std::move(value_ref_());
+  }
+
   /// Unwraps a result, yielding the content of an `Err`.
   ///
   /// # Panics
@@ -2725,6 +2903,9 @@ class [[nodiscard]] Result {
     E storage_err_;
   };
 
+  template <Swappable Tp, Swappable Er, Swappable... Ers>
+  friend class Result;
+
   [[nodiscard]] constexpr T& value_ref_() noexcept { return storage_value_; }
 
   [[nodiscard]] constexpr T const& value_cref_() const noexcept {
@@ -2868,34 +3049,41 @@ template <typename T, typename E>
 
 };  // namespace stx
 
+// the temporary's name is unique per line so that several tries can be made
+// in the same scope
+#define STX_TRY_CONCAT_IMPL_(a, b) a##b
+#define STX_TRY_CONCAT_(a, b) STX_TRY_CONCAT_IMPL_(a, b)
+#define STX_TRY_TMP_ \
+  STX_TRY_CONCAT_(stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh, __LINE__)
+
 // normal return tries
 
 #define TRY_OK(identifier, result_expr)                                        \
-  decltype(result_expr) stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh = (result_expr); \
-  if (stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh.is_err())                          \
+  decltype(result_expr) STX_TRY_TMP_ = (result_expr);                          \
+  if (STX_TRY_TMP_.is_err())                                                   \
     return Err<decltype(result_expr)::error_type>(                             \
-        std::move(stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh).unwrap_err());        \
+        std::move(STX_TRY_TMP_).unwrap_err());                                 \
   decltype(result_expr)::value_type identifier =                               \
-      std::move(stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh).unwrap();
+      std::move(STX_TRY_TMP_).unwrap();
 
 #define TRY_SOME(identifier, option_expr)                                      \
-  decltype(option_expr) stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh = (option_expr); \
-  if (stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh.is_none()) return stx::None;       \
+  decltype(option_expr) STX_TRY_TMP_ = (option_expr);                          \
+  if (STX_TRY_TMP_.is_none()) return stx::None;                                \
   decltype(option_expr)::value_type identifier =                               \
-      std::move(stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh).unwrap();
+      std::move(STX_TRY_TMP_).unwrap();
 
 // Coroutines
 
 #define CO_TRY_OK(identifier, result_expr)                                     \
-  decltype(result_expr) stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh = (result_expr); \
-  if (stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh.is_err())                          \
+  decltype(result_expr) STX_TRY_TMP_ = (result_expr);                          \
+  if (STX_TRY_TMP_.is_err())                                                   \
     co_return Err<decltype(result_expr)::error_type>(                          \
-        std::move(stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh).unwrap_err());        \
+        std::move(STX_TRY_TMP_).unwrap_err());                                 \
   decltype(result_expr)::value_type identifier =                               \
-      std::move(stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh).unwrap();
+      std::move(STX_TRY_TMP_).unwrap();
 
 #define CO_TRY_SOME(identifier, option_expr)                                   \
-  decltype(option_expr) stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh = (option_expr); \
-  if (stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh.is_none()) co_return stx::None;    \
+  decltype(option_expr) STX_TRY_TMP_ = (option_expr);                          \
+  if (STX_TRY_TMP_.is_none()) co_return stx::None;                             \
   decltype(option_expr)::value_type identifier =                               \
-      std::move(stx_TmpVaRYoUHopEfUllYwOnTcoLlidEwiTh).unwrap();
+      std::move(STX_TRY_TMP_).unwrap();
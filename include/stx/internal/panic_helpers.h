@@ -18,40 +18,86 @@ namespace internal {
 
 // Forced inline functions basically function like macros.
 
+namespace format_report {
+
+/// a formatted message followed by the reported value, if it is `Formattable`
+template <typename Message, typename Value>
+struct WithValue {
+  Message const& message;
+  Value const& value;
+};
+
+template <typename Message, typename Value>
+ReportWriter& operator<<(ReportWriter& writer,
+                         WithValue<Message, Value> const& report) noexcept {
+  writer << report.message;
+  if constexpr (Formattable<Value>) {
+    writer << ": ";
+    write_report(writer, report.value);
+  }
+  return writer;
+}
+
+/// panics with `message`, followed by `value`
+template <typename Message, typename Value>
+[[noreturn]] STX_FORCE_INLINE void with_value(
+    Message const& message, Value const& value,
+    SourceLocation location) STX_PANIC_NOEXCEPT {
+  WithValue<Message, Value> const report{message, value};
+  begin_panic(std::string_view(), ReportPayload::deferred(report),
+              std::move(location));
+}
+
+};  // namespace format_report
+
 namespace option {
 using namespace std::string_view_literals;  // NOLINT
 
 /// panic helper for `Option<T>::expect()` when no value is present
 [[noreturn]] STX_FORCE_INLINE void expect_value_failed(
     std::string_view&& msg,
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic(std::forward<std::string_view&&>(msg), std::move(location));
 }
 
+/// panic helper for `Option<T>::expect_fmt()` when no value is present
+template <typename... Args>
+[[noreturn]] STX_FORCE_INLINE void expect_value_failed_fmt(
+    FormatArgs<Args...> const& message,
+    SourceLocation location) STX_PANIC_NOEXCEPT {
+  begin_panic(std::string_view(), ReportPayload::deferred(message),
+              std::move(location));
+}
+
 /// panic helper for `Option<T>::expect_none()` when a value is present
 [[noreturn]] STX_FORCE_INLINE void expect_none_failed(
     std::string_view&& msg, auto const& value,
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic(std::forward<std::string_view&&>(msg), value, std::move(location));
 }
 
 /// panic helper for `Option<T>::unwrap()` when no value is present
 [[noreturn]] STX_FORCE_INLINE void no_value(
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic("called `Option::unwrap()` on a `None` value",
              std::move(location));
 }
 
 /// panic helper for `Option<T>::value()` when no value is present
 [[noreturn]] STX_FORCE_INLINE void no_lref(
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic("called `Option::value()` on a `None` value", std::move(location));
 }
 
 /// panic helper for `Option<T>::unwrap_none()` when a value is present
 [[noreturn]] STX_FORCE_INLINE void no_none(
     auto const& value,
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic("called `Option::unwrap_none()` on a `Some` value", value,
              std::move(location));
 }
@@ -64,21 +110,32 @@ using namespace std::string_view_literals;  // NOLINT
 /// panic helper for `Result<T, E>::expect()` when no value is present
 [[noreturn]] STX_FORCE_INLINE void expect_value_failed(
     std::string_view&& msg, auto const& err,
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic(std::forward<std::string_view&&>(msg), err, std::move(location));
 }
 
+/// panic helper for `Result<T, E>::expect_fmt()` when no value is present
+template <typename... Args>
+[[noreturn]] STX_FORCE_INLINE void expect_value_failed_fmt(
+    FormatArgs<Args...> const& message, auto const& err,
+    SourceLocation location) STX_PANIC_NOEXCEPT {
+  format_report::with_value(message, err, std::move(location));
+}
+
 /// panic helper for `Result<T, E>::expect_err()` when a value is present
 [[noreturn]] STX_FORCE_INLINE void expect_err_failed(
     std::string_view&& msg, auto const& value,
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic(std::forward<std::string_view&&>(msg), value, std::move(location));
 }
 
 /// panic helper for `Result<T, E>::unwrap()` when no value is present
 [[noreturn]] STX_FORCE_INLINE void no_value(
     auto const& err,
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic("called `Result::unwrap()` on an `Err` value"sv, err,
              std::move(location));
 }
@@ -86,7 +143,8 @@ using namespace std::string_view_literals;  // NOLINT
 /// panic helper for `Result<T, E>::value()` when no value is present
 [[noreturn]] STX_FORCE_INLINE void no_lref(
     auto const& err,
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic("called `Result::value()` on an `Err` value"sv, err,
              std::move(location));
 }
@@ -94,7 +152,8 @@ using namespace std::string_view_literals;  // NOLINT
 /// panic helper for `Result<T, E>::unwrap_err()` when a value is present
 [[noreturn]] STX_FORCE_INLINE void no_err(
     auto const& value,
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic("called `Result::unwrap_err()` on an `Ok` value"sv, value,
              std::move(location));
 }
@@ -102,7 +161,8 @@ using namespace std::string_view_literals;  // NOLINT
 /// panic helper for `Result<T, E>::err_value()` when no value is present
 [[noreturn]] STX_FORCE_INLINE void no_err_lref(
     auto const& value,
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   stx::panic("called `Result::err_value()` on an `Ok` value"sv, value,
              std::move(location));
 }
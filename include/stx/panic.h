@@ -11,20 +11,24 @@
 
 #pragma once
 
+#include <type_traits>
+
+#include "stx/format.h"
 #include "stx/report.h"
 
-#ifdef STX_STABLE_LIB_SOURCE_LOCATION
-#include <source_location>
+#if defined(STX_ENABLE_PANIC_UNWIND) && defined(__cpp_exceptions)
+/// functions that can panic are not `noexcept` when panics can unwind
+#define STX_PANIC_NOEXCEPT
 #else
-#include <experimental/source_location>
+#define STX_PANIC_NOEXCEPT noexcept
 #endif
 
 namespace stx {
 
-#ifdef STX_STABLE_SOURCE_LOCATION
-using SourceLocation = std::source_location;
+#if defined(STX_ENABLE_PANIC_UNWIND) && defined(__cpp_exceptions)
+constexpr bool kPanicUnwind = true;
 #else
-using SourceLocation = std::experimental::source_location;
+constexpr bool kPanicUnwind = false;
 #endif
 
 // here, we can avoid any form of memory allocation that might be needed,
@@ -37,9 +41,12 @@ STX_LOCAL void panic_handler(std::string_view info,
 
 /// Handles and dispatches the panic handler. The debugging breakpoint should be
 /// attached to this function to investigate panics.
-[[noreturn]] STX_LOCAL void begin_panic(std::string_view info,
-                                        ReportPayload const& payload,
-                                        SourceLocation location) noexcept;
+///
+/// If `kPanicUnwind` is enabled and the thread is running in `catch_panic`, it
+/// throws `PanicUnwind` once the panic is handled, else it aborts.
+[[noreturn]] STX_LOCAL void begin_panic(
+    std::string_view info, ReportPayload const& payload,
+    SourceLocation location) STX_PANIC_NOEXCEPT;
 
 /// This allows a program to terminate immediately and provide feedback to the
 /// caller of the program. `panic` should be used when a program reaches an
@@ -49,22 +56,44 @@ STX_LOCAL void panic_handler(std::string_view info,
 /// `panic` when they are set to `None` or `Err` variants.
 [[noreturn]] STX_FORCE_INLINE void panic(
     std::string_view info,
-    SourceLocation location = SourceLocation::current()) noexcept {
-  begin_panic(std::move(info), ReportPayload(Report("")), std::move(location));
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
+  begin_panic(std::move(info), ReportPayload(), std::move(location));
 }
 
+/// `value` is only formatted if and when the panic handler writes the payload.
 [[noreturn]] STX_FORCE_INLINE void panic(
     std::string_view info, Reportable auto const& value,
-    SourceLocation location = SourceLocation::current()) noexcept {
-  begin_panic(std::move(info), ReportPayload(internal::report::query >> value),
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
+  begin_panic(std::move(info), ReportPayload::deferred(value),
               std::move(location));
 }
 
 [[noreturn]] STX_FORCE_INLINE void panic(
     std::string_view info, auto const& value,
-    SourceLocation location = SourceLocation::current()) noexcept {
+    SourceLocation location =
+        SourceLocation::current()) STX_PANIC_NOEXCEPT {
   (void)value;
-  begin_panic(std::move(info), ReportPayload(Report("")), std::move(location));
+  begin_panic(std::move(info), ReportPayload(), std::move(location));
+}
+
+/// Panics with a message formatted from `format` and `args`, as with
+/// `FormatString`. The arguments are captured by reference and only formatted
+/// if and when the panic handler writes the payload.
+///
+/// # Examples
+///
+/// ``` cpp
+/// if (shard >= shards.size()) panic_fmt("user {} shard {}", id, shard);
+/// ```
+template <Formattable... Args>
+[[noreturn]] STX_FORCE_INLINE void panic_fmt(
+    FormatString<std::type_identity_t<Args>...> format,
+    Args const&... args) STX_PANIC_NOEXCEPT {
+  FormatArgs<Args...> const message{format.str, args...};
+  begin_panic(std::string_view(), ReportPayload::deferred(message),
+              std::move(format.location));
 }
 
 };  // namespace stx
@@ -0,0 +1,140 @@
+/**
+ * @file binary.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-13
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <thread>  // thread::id NOLINT
+
+#include "stx/panic.h"
+#include "stx/panic/handlers/default/default.h"
+
+#if defined(STX_ENABLE_PANIC_BACKTRACE)
+#include "stx/backtrace.h"
+#endif
+
+//! ### Binary panic records
+//!
+//! `panic_binary` writes each panic as a record of little-endian fields:
+//!
+//! | field          | encoding                                             |
+//! | -------------- | ---------------------------------------------------- |
+//! | magic          | `u32`, `kPanicRecordMagic` ("STXP")                  |
+//! | version        | `u16`, `kPanicRecordVersion`                         |
+//! | thread id      | `u64`                                                |
+//! | timestamp      | `u64`, nanoseconds since the Unix epoch              |
+//! | line, column   | `u32` each, `0` if unknown                           |
+//! | info           | string                                               |
+//! | payload        | chunks: `u32` size and bytes, ending with size `0`   |
+//! | function, file | string each, empty if unknown                        |
+//! | frames         | `u8` `1`, `u64` ip, symbol string per frame, `u8` `0` |
+//!
+//! A string is a `u32` size followed by its bytes. The payload is chunked as
+//! it is streamed, so its size does not need to be known before it is written.
+
+namespace stx {
+
+/// "STXP" in little-endian
+constexpr uint32_t kPanicRecordMagic = 0x50585453;
+constexpr uint16_t kPanicRecordVersion = 1;
+
+namespace internal {
+namespace panic_util {
+
+template <typename T>
+inline void write_le(StderrReport& report, T value) noexcept {
+  char bytes[sizeof(T)];
+  for (size_t i = 0; i < sizeof(T); i++) {
+    bytes[i] = static_cast<char>(static_cast<uint64_t>(value) >> (8 * i));
+  }
+  report.write(std::string_view(bytes, sizeof(T)));
+}
+
+inline void write_binary_string(StderrReport& report,
+                                std::string_view text) noexcept {
+  write_le(report, static_cast<uint32_t>(text.size()));
+  report.write_ref(text);
+}
+
+inline void write_binary_string(StderrReport& report,
+                                char const* text) noexcept {
+  write_binary_string(report, text == nullptr ? std::string_view()
+                                              : std::string_view(text));
+}
+
+/// writes each piece of the payload as a chunk
+struct BinaryChunkWriter final : public ReportWriter {
+  explicit BinaryChunkWriter(StderrReport& report) noexcept : report{report} {}
+
+  void write(std::string_view text) noexcept override {
+    if (text.empty()) return;
+    write_le(report, static_cast<uint32_t>(text.size()));
+    report.write(text);
+  }
+
+  StderrReport& report;
+};
+
+}  // namespace panic_util
+}  // namespace internal
+
+/// Writes the panic report to stderr as a compact binary record, as described
+/// above. As with `panic_default`, the record is assembled in a per-thread
+/// buffer without allocating and written with `writev(2)`, and the payload is
+/// streamed so it is never truncated.
+inline void panic_binary(
+    std::string_view info, ReportPayload const& payload,
+    SourceLocation location = SourceLocation::current()) noexcept {
+  using namespace internal::panic_util;  // NOLINT
+
+  StderrReport& report = thread_report;
+
+  write_le(report, kPanicRecordMagic);
+  write_le(report, kPanicRecordVersion);
+  write_le(report, static_cast<uint64_t>(
+                       kThreadIdHash(std::this_thread::get_id())));
+  write_le(report, unix_timestamp_ns());
+  write_le(report, static_cast<uint32_t>(location.line()));
+  write_le(report, static_cast<uint32_t>(location.column()));
+  write_binary_string(report, info);
+
+  BinaryChunkWriter chunk_writer{report};
+  payload.write_to(chunk_writer);
+  write_le(report, uint32_t{0});
+
+  write_binary_string(report, location.function_name());
+  write_binary_string(report, location.file_name());
+
+#if defined(STX_ENABLE_PANIC_BACKTRACE)
+  stx::backtrace::trace([](backtrace::Frame frame, int) {
+    StderrReport& report = thread_report;
+
+    write_le(report, uint8_t{1});
+    write_le(report,
+             static_cast<uint64_t>(frame.ip.clone().unwrap_or(uintptr_t{0})));
+
+    // the symbol's buffer is cleared after the callback, so it is copied
+    std::string_view symbol = frame.symbol.as_ref().match(
+        [](Ref<backtrace::Symbol> sym) { return sym.get().raw(); },
+        []() { return std::string_view(); });
+    write_le(report, static_cast<uint32_t>(symbol.size()));
+    report.write(symbol);
+
+    return false;
+  });
+#endif
+
+  write_le(report, uint8_t{0});
+  report.finish();
+}
+
+};  // namespace stx
@@ -11,141 +11,490 @@
 
 #pragma once
 
-#include <mutex>   // mutex NOLINT
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <span>
 #include <thread>  // thread::id NOLINT
 
+#include "stx/flight_recorder.h"
+#include "stx/panic.h"
+#include "stx/panic/report_line.h"
+#include "stx/panic/reserve.h"
+
+#if CFG(OS, POSIX)
+#include <sys/uio.h>
+
+#include "stx/panic/sink.h"
+#endif
+
 #if defined(STX_ENABLE_PANIC_BACKTRACE)
 #include "stx/backtrace.h"
 #endif
 
 namespace stx {
 
-// probably too much, but enough
-// this will at least hold a formatted uint128_t (40 digits)
-
 namespace internal {
 namespace panic_util {
-constexpr int kFormatBufferSize = 256;
-constexpr auto kThreadIdHash = std::hash<std::thread::id>{};
-};  // namespace panic_util
-};  // namespace internal
 
-// this should be made thread-safe.
-inline void panic_default(
-    std::string_view info, ReportPayload const& payload,
-    SourceLocation location = SourceLocation::current()) noexcept {
-  using namespace internal::panic_util;  // NOLINT
+/// size of the per-thread buffer the panic report is assembled in
+constexpr size_t kReportBufferSize = 4096;
 
-  static std::mutex stderr_lock;
+/// maximum number of segments in one write, `_XOPEN_IOV_MAX`
+constexpr size_t kMaxReportSegments = 16;
 
-  char log_buffer[kFormatBufferSize];
+/// serializes the reports of panicking threads. It is held while a report is
+/// written, which can block on a full stderr pipe, so it must not be taken
+/// from a signal handler: use `panic_signal_safe` there.
+inline std::atomic_flag stderr_lock = ATOMIC_FLAG_INIT;
 
-  auto thread_id_hash = kThreadIdHash(std::this_thread::get_id());
+/// tells the CPU the thread is spinning, so it yields to a sibling thread and
+/// leaves the spin loop without a pipeline flush
+STX_FORCE_INLINE void spin_pause() noexcept {
+#if CFG(ARCH, X86_64) && (CFG(COMPILER, GNUC) || CFG(COMPILER, CLANG))
+  __builtin_ia32_pause();
+#elif CFG(ARCH, ARM64) && (CFG(COMPILER, GNUC) || CFG(COMPILER, CLANG))
+  asm volatile("yield");
+#endif
+}
 
-  stderr_lock.lock();
+/// Acquires `stderr_lock`. A waiter spins briefly, then yields, then sleeps
+/// with an exponential backoff of up to a millisecond, so threads queued
+/// behind a report blocked on a full pipe do not each burn a core.
+inline void lock_stderr() noexcept {
+  uint32_t sleep_us = 1;
+  for (uint32_t attempt = 0;
+       stderr_lock.test_and_set(std::memory_order_acquire); attempt++) {
+    if (attempt < 64) {
+      spin_pause();
+    } else if (attempt < 128) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds{sleep_us});
+      sleep_us = std::min<uint32_t>(sleep_us * 2, 1000);
+    }
+  }
+}
 
-  std::fputs("\nthread with hash: '", stderr);
+/// A panic report assembled in a per-thread buffer and written to the panic
+/// sink (stderr, fd 2, unless another is set, see `stx/panic/sink.h`) with a
+/// single `writev` call. Strings that outlive the report, like the panic
+/// info and the source location, are referred to by the write instead of being
+/// copied.
+///
+/// The report is usually written in one call with the lock held only for it.
+/// If it does not fit in the buffer, it is written in parts, with the lock held
+/// across them so the reports of panicking threads do not interleave.
+class StderrReport final : public ReportWriter {
+ public:
+  struct Segment {
+    char const* data;
+    size_t size;
+  };
+
+  constexpr StderrReport() noexcept
+      : buffer_{}, used_{0}, segments_{}, num_segments_{0}, locked_{false} {}
+
+  /// copies `text` into the report
+  void write(std::string_view text) noexcept override {
+    while (!text.empty()) {
+      if (used_ == kReportBufferSize) flush();
+      char* dest = buffer_ + used_;
+
+      // extend the segment if it ends where the copy starts, else make room
+      // for a new one before copying, as flushing reuses the buffer
+      bool extends = num_segments_ != 0 &&
+                     segments_[num_segments_ - 1].data +
+                             segments_[num_segments_ - 1].size ==
+                         dest;
+      if (!extends && num_segments_ == kMaxReportSegments) {
+        flush();
+        dest = buffer_;
+      }
+
+      size_t size = std::min(text.size(), kReportBufferSize - used_);
+      std::memcpy(dest, text.data(), size);
+      used_ += size;
+      text.remove_prefix(size);
+
+      if (extends) {
+        segments_[num_segments_ - 1].size += size;
+      } else {
+        add_segment(Segment{dest, size});
+      }
+    }
+  }
 
-  std::snprintf(log_buffer, kFormatBufferSize, "%zu", thread_id_hash);
-  std::fputs(log_buffer, stderr);
+  /// refers to `text` in the report, `text` must remain valid until `finish`
+  void write_ref(std::string_view text) noexcept {
+    if (text.empty()) return;
+    add_segment(Segment{text.data(), text.size()});
+  }
 
-  std::fputs("' panicked with: '", stderr);
+  template <typename T>
+  void write_number(T value, int base = 10) noexcept {
+    char digits[24];
+    std::to_chars_result result =
+        std::to_chars(digits, digits + sizeof(digits), value, base);
+    write(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+  }
 
-  for (char c : info) {
-    std::fputc(c, stderr);
+  /// writes the rest of the report and releases the lock
+  void finish() noexcept {
+    flush();
+    if (locked_) {
+      stderr_lock.clear(std::memory_order_release);
+      locked_ = false;
+    }
   }
 
-  if (!payload.data().empty()) {
-    std::fputc(':', stderr);
-    std::fputc(' ', stderr);
+ private:
+  void add_segment(Segment segment) noexcept {
+    if (num_segments_ == kMaxReportSegments) flush();
+    segments_[num_segments_] = segment;
+    num_segments_++;
+  }
 
-    for (auto c : payload.data()) {
-      std::fputc(c, stderr);
+  void flush() noexcept {
+    if (!locked_) {
+      lock_stderr();
+      locked_ = true;
     }
+    write_segments(segments_, num_segments_);
+    used_ = 0;
+    num_segments_ = 0;
   }
 
-  std::fputc('\'', stderr);
-
-  std::fputs(" at function: '", stderr);
+#if CFG(OS, POSIX)
+  static void write_segments(Segment const* segments, size_t num) noexcept {
+    iovec iov[kMaxReportSegments];
+    for (size_t i = 0; i < num; i++) {
+      iov[i].iov_base = const_cast<char*>(segments[i].data);
+      iov[i].iov_len = segments[i].size;
+    }
+    panic_sink::write_segments(iov, static_cast<int>(num));
+  }
+#else
+  static void write_segments(Segment const* segments, size_t num) noexcept {
+    for (size_t i = 0; i < num; i++) {
+      std::fwrite(segments[i].data, 1, segments[i].size, stderr);
+    }
+    std::fflush(stderr);
+  }
+#endif
 
-  if (location.function_name() != nullptr) {
-    std::fputs(location.function_name(), stderr);
-  } else {
-    std::fputs("<unknown>", stderr);
+  char buffer_[kReportBufferSize];
+  size_t used_;
+  Segment segments_[kMaxReportSegments];
+  size_t num_segments_;
+  bool locked_;
+};
+
+/// the report of the panicking thread, constant-initialized so that accessing
+/// it does not run any initialization code
+inline thread_local constinit StderrReport thread_report;
+
+/// maximum number of distinct source locations whose panics are counted in a
+/// window
+constexpr size_t kMaxPanicStormLocations = 64;
+
+// a slot counts the panics at the location `key` in one window. `count` holds
+// the window in its upper 32 bits and the count in its lower 32 bits, so a
+// count from an earlier window reads as stale without clearing the slots, and
+// a slot whose count is stale can be claimed by another location.
+struct StormSlot {
+  std::atomic<uint64_t> key{0};
+  std::atomic<uint64_t> count{0};
+};
+
+/// The panics counted by source location, and the rate limit of full reports
+/// for distinct locations, in a fixed window of `interval_ns`. Both start over
+/// in each window, so a storm is the panics at a location within a window.
+struct PanicStorm {
+  StormSlot slots[kMaxPanicStormLocations];
+  std::atomic<uint64_t> max_reports{8};
+  std::atomic<uint64_t> interval_ns{1'000'000'000};
+  std::atomic<uint64_t> window_start_ns{0};
+  std::atomic<uint64_t> window_reports{0};
+  // starts at 1, so that the zeroed slots are stale
+  std::atomic<uint32_t> window{1};
+};
+
+inline constinit PanicStorm panic_storm;
+
+/// FNV-1a hash of the location, never 0
+inline uint64_t location_key(SourceLocation const& location) noexcept {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  auto const mix = [&hash](uint64_t byte) {
+    hash ^= byte;
+    hash *= 0x100000001b3ULL;
+  };
+
+  if (char const* file = location.file_name(); file != nullptr) {
+    for (; *file != '\0'; file++) mix(static_cast<unsigned char>(*file));
+  }
+  for (uint64_t n : {static_cast<uint64_t>(location.line()),
+                     static_cast<uint64_t>(location.column())}) {
+    for (int i = 0; i < 4; i++) mix((n >> (8 * i)) & 0xff);
   }
 
-  std::fputs("' [", stderr);
+  return hash == 0 ? 1 : hash;
+}
 
-  if (location.file_name() != nullptr) {
-    std::fputs(location.file_name(), stderr);
-  } else {
-    std::fputs("<unknown>", stderr);
+inline uint64_t steady_timestamp_ns() noexcept {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+/// moves to a new window once the current one is over, and returns the
+/// current window
+inline uint32_t advance_storm_window() noexcept {
+  uint64_t const now = steady_timestamp_ns();
+  uint64_t start = panic_storm.window_start_ns.load(std::memory_order_relaxed);
+
+  // the thread that moves the window forward resets its counts
+  if (now - start >= panic_storm.interval_ns.load(std::memory_order_relaxed) &&
+      panic_storm.window_start_ns.compare_exchange_strong(
+          start, now, std::memory_order_relaxed)) {
+    panic_storm.window_reports.store(0, std::memory_order_relaxed);
+    return panic_storm.window.fetch_add(1, std::memory_order_relaxed) + 1;
   }
 
-  std::fputc(':', stderr);
+  return panic_storm.window.load(std::memory_order_relaxed);
+}
 
-  if (location.line() != 0) {
-    std::snprintf(log_buffer, kFormatBufferSize, "%d", location.line());
-    std::fputs(log_buffer, stderr);
-  } else {
-    std::fputs("<unknown>", stderr);
+/// adds a panic to the slot's count in `window`, returns the new count
+inline uint64_t add_storm_count(StormSlot& slot, uint32_t window) noexcept {
+  uint64_t count = slot.count.load(std::memory_order_relaxed);
+  uint64_t next;
+  do {
+    next = (count >> 32) == window ? count + 1
+                                   : (static_cast<uint64_t>(window) << 32) | 1;
+  } while (!slot.count.compare_exchange_weak(count, next,
+                                             std::memory_order_relaxed));
+  return next & 0xffff'ffff;
+}
+
+/// counts a panic at `location` in `window`, returns the number of panics at
+/// it in the window including this one, or 0 if all slots are used by other
+/// locations in the window
+inline uint64_t count_panic(SourceLocation const& location,
+                            uint32_t window) noexcept {
+  uint64_t const key = location_key(location);
+  size_t const start = key % kMaxPanicStormLocations;
+
+  for (size_t i = 0; i < kMaxPanicStormLocations; i++) {
+    StormSlot& slot = panic_storm.slots[(start + i) % kMaxPanicStormLocations];
+    uint64_t slot_key = slot.key.load(std::memory_order_relaxed);
+    if (slot_key == 0 &&
+        slot.key.compare_exchange_strong(slot_key, key,
+                                         std::memory_order_relaxed)) {
+      slot_key = key;
+    }
+    if (slot_key == key) return add_storm_count(slot, window);
   }
 
-  std::fputc(':', stderr);
+  // all slots have a location, one that did not panic in this window is taken
+  // over. A thread counting the slot's previous location at the same time may
+  // count into it, which only makes the count approximate.
+  for (size_t i = 0; i < kMaxPanicStormLocations; i++) {
+    StormSlot& slot = panic_storm.slots[(start + i) % kMaxPanicStormLocations];
+    uint64_t count = slot.count.load(std::memory_order_relaxed);
+    if ((count >> 32) != window &&
+        slot.count.compare_exchange_strong(
+            count, (static_cast<uint64_t>(window) << 32) | 1,
+            std::memory_order_relaxed)) {
+      slot.key.store(key, std::memory_order_relaxed);
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/// takes one of the full reports allowed in the current window
+inline bool take_report_token() noexcept {
+  uint64_t const max_reports =
+      panic_storm.max_reports.load(std::memory_order_relaxed);
+  if (max_reports == 0) return true;
 
-  if (location.column() != 0) {
-    std::snprintf(log_buffer, kFormatBufferSize, "%d", location.column());
-    std::fputs(log_buffer, stderr);
+  return panic_storm.window_reports.fetch_add(1, std::memory_order_relaxed) <
+         max_reports;
+}
+
+/// writes the one-line summary of a panic whose full report is suppressed
+inline void write_panic_summary(std::string_view info,
+                                SourceLocation const& location,
+                                uint64_t count) noexcept {
+  StderrReport& report = thread_report;
+
+  report.write("\nthread with hash: '");
+  report.write_number(kThreadIdHash(std::this_thread::get_id()));
+  report.write("' panicked with: '");
+  report.write_ref(info);
+  report.write("' at [");
+  write_location(report, location.file_name());
+  report.write(":");
+  write_location(report, location.line());
+  report.write(":");
+  write_location(report, location.column());
+  if (count <= 1) {
+    report.write("] (full report suppressed by the rate limit)\n");
   } else {
-    std::fputs("<unknown>", stderr);
+    report.write("] (panic #");
+    report.write_number(count);
+    report.write(" at this location, full report suppressed)\n");
   }
 
-  std::fputs("]\n", stderr);
+  report.finish();
+}
+
+#if defined(STX_ENABLE_PANIC_BACKTRACE)
+/// the stack of the panicking thread, captured before the report is written
+inline thread_local constinit void* thread_frames[STX_MAX_STACK_FRAME_DEPTH] =
+    {};
+#endif
+
+/// a panic to be reported, passed to the stack the report is written on
+struct PanicReportTask {
+  std::string_view info;
+  ReportPayload const* payload;
+  SourceLocation const* location;
+  std::span<void* const> frames;
+};
+
+inline void write_report_task(void* arg) noexcept {
+  PanicReportTask const& task = *static_cast<PanicReportTask const*>(arg);
+  std::string_view info = task.info;
+  ReportPayload const& payload = *task.payload;
+  SourceLocation const& location = *task.location;
+  StderrReport& report = thread_report;
+
+  report.write("\n");
+  write_panic_line(report, info, payload, location);
 
-  std::fflush(stderr);
+  // what the thread did before it panicked
+  flight_recorder::write_recent_events(report);
 
 #if defined(STX_ENABLE_PANIC_BACKTRACE)
   // assumes the presence of an operating system
 
-  std::fputs(
+  report.write(
       "\nBacktrace:\nip: Instruction Pointer,  sp: Stack "
-      "Pointer\n\n",
-      stderr);
+      "Pointer\n\n");
 
-  stx::backtrace::trace([](backtrace::Frame frame, int i) {
-    auto const print_none = []() { std::fputs("<unknown>", stderr); };
-    auto const print_ptr = [](Ref<uintptr_t> ip) {
-      std::fprintf(stderr, "0x%" PRIxPTR, ip.get());
+  stx::backtrace::trace(task.frames, [](backtrace::Frame frame, int i) {
+    StderrReport& report = thread_report;
+
+    auto const write_none = []() { thread_report.write("<unknown>"); };
+    auto const write_ptr = [](Ref<uintptr_t> ptr) {
+      thread_report.write("0x");
+      thread_report.write_number(ptr.get(), 16);
     };
 
-    std::fprintf(stderr, "#%d\t\t", i);
+    report.write("#");
+    report.write_number(i);
+    report.write("\t\t");
 
+    // the symbol's buffer is cleared after the callback, so it is copied
     frame.symbol.as_ref().match(
         [](Ref<backtrace::Symbol> sym) {
-          for (char c : sym.get().raw()) {
-            std::fputc(c, stderr);
-          }
+          thread_report.write(sym.get().raw());
         },
-        print_none);
-
-    std::fputs("\t (ip: ", stderr);
+        write_none);
 
-    frame.ip.as_ref().match(print_ptr, print_none);
+    report.write("\t (ip: ");
+    frame.ip.as_ref().match(write_ptr, write_none);
+    report.write(", sp: ");
+    frame.sp.as_ref().match(write_ptr, write_none);
+    report.write(")\n");
 
-    std::fputs(", sp: ", stderr);
+    return false;
+  });
 
-    frame.sp.as_ref().match(print_ptr, print_none);
+  report.write("\n");
 
-    std::fputs(")\n", stderr);
+#endif
 
-    return false;
-  });
+  report.finish();
+}
 
-  std::fputs("\n", stderr);
+/// Writes the full panic report to the panic sink. The report is assembled in
+/// a per-thread buffer without allocating, and written with one `writev(2)`,
+/// so reports of concurrently panicking threads do not interleave.
+///
+/// If the emergency reserve is set up, the report is written on its stack, so
+/// it does not depend on how much of the panicking thread's stack is left.
+inline void write_panic_report(std::string_view info,
+                               ReportPayload const& payload,
+                               SourceLocation const& location) noexcept {
+  PanicReportTask task{info, &payload, &location, {}};
 
+#if defined(STX_ENABLE_PANIC_BACKTRACE)
+  // the frames can not be walked from the reserve stack, so they are captured
+  // here, this needs little stack
+  task.frames = std::span<void* const>{
+      thread_frames, backtrace::capture(std::span<void*>{thread_frames})};
 #endif
 
-  // other threads will still be able to log for some nanoseconds
-  stderr_lock.unlock();
+  if (!panic_reserve::run(write_report_task, &task)) {
+    write_report_task(&task);
+  }
+}
+
+}  // namespace panic_util
+}  // namespace internal
+
+/// Limits the full reports that `panic_default` writes for panics at distinct
+/// source locations to `max_reports` per `interval`, the others are written as
+/// a one-line summary. A `max_reports` of 0 removes the limit. The default is 8
+/// per second. Setting the limit starts a new window.
+///
+/// The panics at each location are also counted per window, so the first panic
+/// at a location in a window is written in full again.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe.
+inline void set_panic_storm_limit(size_t max_reports,
+                                  std::chrono::nanoseconds interval) noexcept {
+  using namespace internal::panic_util;  // NOLINT
+  panic_storm.interval_ns.store(static_cast<uint64_t>(interval.count()),
+                                std::memory_order_relaxed);
+  panic_storm.max_reports.store(max_reports, std::memory_order_relaxed);
+  panic_storm.window_start_ns.store(steady_timestamp_ns(),
+                                    std::memory_order_relaxed);
+  panic_storm.window_reports.store(0, std::memory_order_relaxed);
+  panic_storm.window.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Writes the panic report to stderr, or to the panic sink set at startup (see
+/// `stx/panic/sink.h`). The report is assembled in a per-thread buffer without
+/// allocating, and written with one `writev(2)`, so reports of concurrently
+/// panicking threads do not interleave.
+///
+/// To keep a storm of panics, i.e. many threads hitting the same bad input,
+/// from delaying the process, only the first panic at a source location in a
+/// window of the rate limit is written in full. Later panics at the same
+/// location in the window are written as a one-line summary with the number of
+/// panics at it, and the full reports for distinct locations are rate-limited
+/// (see `set_panic_storm_limit`).
+inline void panic_default(
+    std::string_view info, ReportPayload const& payload,
+    SourceLocation location = SourceLocation::current()) noexcept {
+  using namespace internal::panic_util;  // NOLINT
+
+  uint64_t const count = count_panic(location, advance_storm_window());
+  if (count > 1 || !take_report_token()) {
+    write_panic_summary(info, location, count);
+  } else {
+    write_panic_report(info, payload, location);
+  }
 }
 }  // namespace stx
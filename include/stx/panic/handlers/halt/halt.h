@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "stx/panic.h"
 
 namespace stx {
@@ -30,4 +32,59 @@ inline void panic_halt(
   while (halt) {
   }
 }
+
+namespace internal {
+namespace thread_park {
+
+/// blocks the calling thread until `release_parked_threads` is called
+STX_EXPORT void park() noexcept;
+
+}  // namespace thread_park
+}  // namespace internal
+
+/// Releases the threads parked by `panic_park`, their panics then proceed as
+/// if the handler returned.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe and async-signal-safe.
+STX_EXPORT void release_parked_threads() noexcept;
+
+/// Number of threads currently parked by `panic_park`.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe.
+[[nodiscard]] STX_EXPORT size_t parked_threads() noexcept;
+
+#if CFG(OS, POSIX)
+/// Installs a handler for `signal` that releases the parked threads, i.e.
+/// `kill -USR1 <pid>` for `SIGUSR1`. Returns `false` if the handler could not
+/// be installed.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe.
+[[nodiscard]] STX_EXPORT bool release_parked_threads_on(int signal) noexcept;
+#endif
+
+/// Causes the current thread to halt like `panic_halt`, but blocks the thread
+/// instead of spinning, so halted threads do not use the CPU while they wait
+/// for someone to inspect them.
+///
+/// The thread stays parked until it is released by:
+/// - an admin API or another thread: `release_parked_threads()`
+/// - a signal: see `release_parked_threads_on`
+/// - a debugger: `call stx::release_parked_threads()`
+///
+/// Once released, the panic proceeds as it would after any handler returns.
+inline void panic_park(
+    std::string_view info, ReportPayload const& payload,
+    SourceLocation location = SourceLocation::current()) noexcept {
+  (void)info;
+  (void)payload;
+  (void)location;
+
+  internal::thread_park::park();
+}
 };  // namespace stx
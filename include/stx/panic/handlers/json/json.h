@@ -0,0 +1,236 @@
+/**
+ * @file json.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-13
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <thread>  // thread::id NOLINT
+
+#include "stx/panic.h"
+#include "stx/panic/handlers/default/default.h"
+
+#if defined(STX_ENABLE_PANIC_BACKTRACE)
+#include "stx/backtrace.h"
+#endif
+
+namespace stx {
+
+namespace internal {
+namespace panic_util {
+
+/// writes text into a JSON string, escaping it. UTF-8 text is written as it
+/// is, and each invalid UTF-8 sequence is written as `\ufffd`, so the string
+/// is valid JSON whatever the bytes written into it. A sequence may be split
+/// across writes, `finish` must be called at the end of the string.
+struct JsonStringWriter final : public ReportWriter {
+  explicit JsonStringWriter(StderrReport& report) noexcept : report{report} {}
+
+  void write(std::string_view text) noexcept override {
+    constexpr char kHexDigits[] = "0123456789abcdef";
+
+    size_t begin = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+      auto c = static_cast<unsigned char>(text[i]);
+
+      if (sequence_size != 0) {
+        // the continuation bytes of a multi-byte sequence are held until it
+        // is complete
+        if (c >= next_min && c <= next_max) {
+          sequence[sequence_size++] = static_cast<char>(c);
+          next_min = 0x80;
+          next_max = 0xBF;
+          if (sequence_size == sequence_length) {
+            report.write(std::string_view{sequence, sequence_size});
+            sequence_size = 0;
+          }
+          begin = i + 1;
+          continue;
+        }
+        // the sequence ends early, `c` is read anew
+        finish();
+      }
+
+      if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\') continue;
+
+      report.write(text.substr(begin, i - begin));
+      begin = i + 1;
+
+      if (c >= 0x80) {
+        start_sequence(c);
+        continue;
+      }
+
+      switch (c) {
+        case '"':
+          report.write("\\\"");
+          break;
+        case '\\':
+          report.write("\\\\");
+          break;
+        case '\n':
+          report.write("\\n");
+          break;
+        case '\r':
+          report.write("\\r");
+          break;
+        case '\t':
+          report.write("\\t");
+          break;
+        default: {
+          char escaped[] = {'\\', 'u', '0', '0', kHexDigits[c >> 4],
+                            kHexDigits[c & 0xF]};
+          report.write(std::string_view(escaped, sizeof(escaped)));
+        }
+      }
+    }
+    report.write(text.substr(begin));
+  }
+
+  /// writes an incomplete sequence at the end of the string as `\ufffd`
+  void finish() noexcept {
+    if (sequence_size != 0) {
+      report.write("\\ufffd");
+      sequence_size = 0;
+    }
+  }
+
+  StderrReport& report;
+
+ private:
+  // starts a sequence with the lead byte `c`, the ranges of the second byte
+  // exclude overlong encodings, surrogates and code points above U+10FFFF
+  void start_sequence(unsigned char c) noexcept {
+    next_min = 0x80;
+    next_max = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+      sequence_length = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+      sequence_length = 3;
+      if (c == 0xE0) next_min = 0xA0;
+      if (c == 0xED) next_max = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+      sequence_length = 4;
+      if (c == 0xF0) next_min = 0x90;
+      if (c == 0xF4) next_max = 0x8F;
+    } else {
+      report.write("\\ufffd");
+      return;
+    }
+    sequence[0] = static_cast<char>(c);
+    sequence_size = 1;
+  }
+
+  char sequence[4] = {};
+  size_t sequence_size = 0;
+  size_t sequence_length = 0;
+  unsigned char next_min = 0x80;
+  unsigned char next_max = 0xBF;
+};
+
+/// whether the next backtrace frame is the first in the `frames` array
+inline thread_local constinit bool json_first_frame = true;
+
+/// writes `text` as a JSON string, or `null` if it is a `nullptr`
+inline void write_json_string(StderrReport& report,
+                              char const* text) noexcept {
+  if (text == nullptr) {
+    report.write("null");
+    return;
+  }
+  JsonStringWriter writer{report};
+  report.write("\"");
+  writer.write(text);
+  writer.finish();
+  report.write("\"");
+}
+
+}  // namespace panic_util
+}  // namespace internal
+
+/// Writes the panic report to stderr as one line of JSON, for log pipelines.
+/// As with `panic_default`, the line is assembled in a per-thread buffer
+/// without allocating and written with `writev(2)`, and the payload is
+/// streamed so it is never truncated.
+///
+/// ``` json
+/// {"thread_id":8569675143510992911,"timestamp_ns":1591999200000000000,
+///  "info":"request failed","payload":"user 42 shard 7",
+///  "function":"void serve()","file":"server.cc","line":42,"column":7,
+///  "frames":[{"ip":"0x401136","symbol":"serve()"}]}
+/// ```
+///
+/// `frames` is empty unless panic backtraces are enabled. `function` and `file`
+/// are `null` if unknown, `line` and `column` are `0`.
+inline void panic_json(
+    std::string_view info, ReportPayload const& payload,
+    SourceLocation location = SourceLocation::current()) noexcept {
+  using namespace internal::panic_util;  // NOLINT
+
+  StderrReport& report = thread_report;
+  JsonStringWriter string_writer{report};
+
+  report.write("{\"thread_id\":");
+  report.write_number(kThreadIdHash(std::this_thread::get_id()));
+  report.write(",\"timestamp_ns\":");
+  report.write_number(unix_timestamp_ns());
+  report.write(",\"info\":\"");
+  string_writer.write(info);
+  string_writer.finish();
+  report.write("\",\"payload\":\"");
+  payload.write_to(string_writer);
+  string_writer.finish();
+  report.write("\",\"function\":");
+  write_json_string(report, location.function_name());
+  report.write(",\"file\":");
+  write_json_string(report, location.file_name());
+  report.write(",\"line\":");
+  report.write_number(location.line());
+  report.write(",\"column\":");
+  report.write_number(location.column());
+  report.write(",\"frames\":[");
+
+#if defined(STX_ENABLE_PANIC_BACKTRACE)
+  json_first_frame = true;
+  stx::backtrace::trace([](backtrace::Frame frame, int) {
+    StderrReport& report = thread_report;
+    JsonStringWriter string_writer{report};
+
+    report.write(json_first_frame ? "{\"ip\":" : ",{\"ip\":");
+    json_first_frame = false;
+    frame.ip.as_ref().match(
+        [](Ref<uintptr_t> ip) {
+          thread_report.write("\"0x");
+          thread_report.write_number(ip.get(), 16);
+          thread_report.write("\"");
+        },
+        []() { thread_report.write("null"); });
+
+    report.write(",\"symbol\":");
+    frame.symbol.as_ref().match(
+        [&](Ref<backtrace::Symbol> sym) {
+          report.write("\"");
+          string_writer.write(sym.get().raw());
+          string_writer.finish();
+          report.write("\"");
+        },
+        [&]() { report.write("null"); });
+    report.write("}");
+
+    return false;
+  });
+#endif
+
+  report.write("]}\n");
+  report.finish();
+}
+
+};  // namespace stx
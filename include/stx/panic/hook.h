@@ -35,6 +35,8 @@
 //! - If hooks are available, attach a panic hook:
 //! `attach_panic_hook(my_handler)` or reset the exisiting panic hook back to
 //! the default: `take_panic_hook()`
+//! - Register hooks that observe panics before they are handled, each with its
+//! own state: `register_panic_hook(my_hook, &my_state)`
 //!
 //!
 
@@ -50,6 +52,15 @@ constexpr bool kVisiblePanicHook = false;
 using PanicHook = decltype(panic_handler)*;
 using AtomicPanicHook = std::atomic<PanicHook>;
 
+/// A hook in the panic hook chain. `context` is the pointer it was registered
+/// with.
+using ChainedPanicHook = void (*)(void* context, std::string_view info,
+                                  ReportPayload const& payload,
+                                  SourceLocation location) noexcept;
+
+/// maximum number of hooks that can be registered in the panic hook chain
+constexpr size_t kMaxChainedPanicHooks = 32;
+
 namespace this_thread {
 
 /// Checks if the current thread is panicking.
@@ -57,6 +68,50 @@ namespace this_thread {
 /// # THREAD-SAFETY
 /// thread-safe.
 [[nodiscard]] STX_EXPORT bool is_panicking() noexcept;
+
+/// Sets the panic hook of the current thread to `hook`, and returns the
+/// previous one. The thread's panic hook is called in place of the global
+/// panic hook (or the default panic hook) when the thread panics. A
+/// `nullptr` hook makes the thread use the global panic hook again.
+///
+/// Unlike `attach_panic_hook`, this does not check whether the thread is
+/// panicking, so it can be used to restore the previous hook while unwinding.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe, it only affects the current thread.
+
+[[nodiscard]]
+#if defined(STX_VISIBLE_PANIC_HOOK)
+STX_EXPORT
+#else
+STX_LOCAL
+#endif
+
+    PanicHook
+    exchange_panic_hook(PanicHook hook) noexcept;
+
+/// Attaches a panic hook for the current thread, as with
+/// `exchange_panic_hook`. Setting a thread's hook does not touch the global
+/// panic hook, so worker threads can set per-job policies without contending
+/// with other threads.
+///
+/// Returns `true` if the thread is not panicking and the panic hook was
+/// successfully attached, else returns `false`.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe, it only affects the current thread.
+
+[[nodiscard]]
+#if defined(STX_VISIBLE_PANIC_HOOK)
+STX_EXPORT
+#else
+STX_LOCAL
+#endif
+
+    bool
+    attach_panic_hook(PanicHook hook) noexcept;
 };  // namespace this_thread
 
 /// Checks if panic hooks are visible to be attached-to when loaded as a dynamic
@@ -109,4 +164,84 @@ STX_LOCAL
     bool
     take_panic_hook(PanicHook* hook) noexcept;
 
+/// Registers `hook` in the panic hook chain. On panic, the hooks in the chain
+/// are called with their `context` before the attached panic hook or the
+/// default panic hook. This allows several components, like metrics, crash
+/// uploaders and loggers, to each observe panics.
+///
+/// Registration is lock-free and hooks can be registered concurrently, a panic
+/// in another thread only reads the chain. The chain holds up to
+/// `kMaxChainedPanicHooks` hooks at once. The slot of a removed hook is reused
+/// once no panic is still calling it, so components can register and remove
+/// hooks as they are loaded and unloaded. Hooks are called in the order they
+/// were registered until a slot is reused, a hook in a reused slot may be
+/// called before older ones.
+///
+/// Returns `true` if the thread is not panicking and the hook was registered,
+/// else returns `false`, which includes when `kMaxChainedPanicHooks` hooks are
+/// registered.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe.
+
+[[nodiscard]]
+#if defined(STX_VISIBLE_PANIC_HOOK)
+STX_EXPORT
+#else
+STX_LOCAL
+#endif
+
+    bool
+    register_panic_hook(ChainedPanicHook hook, void* context) noexcept;
+
+/// Removes the first registered `hook` with `context` from the panic hook
+/// chain. A panic that is already dispatching in another thread may still
+/// call it, so `context` should outlive the program if it can panic
+/// concurrently.
+///
+/// Returns `true` if the thread is not panicking and the hook was removed,
+/// else returns `false`.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe.
+
+[[nodiscard]]
+#if defined(STX_VISIBLE_PANIC_HOOK)
+STX_EXPORT
+#else
+STX_LOCAL
+#endif
+
+    bool
+    unregister_panic_hook(ChainedPanicHook hook, void* context) noexcept;
+
+/// Sets the current thread's panic hook for the lifetime of the guard, and
+/// restores the previous one when it goes out of scope.
+///
+/// # Examples
+///
+/// ``` cpp
+/// void run_job(Job& job) {
+///   ScopedPanicHook guard{fail_job_hook};
+///   job.run();
+/// }
+/// ```
+class [[nodiscard]] ScopedPanicHook {
+ public:
+  explicit ScopedPanicHook(PanicHook hook) noexcept
+      : previous_{this_thread::exchange_panic_hook(hook)} {}
+
+  ScopedPanicHook(ScopedPanicHook const&) = delete;
+  ScopedPanicHook& operator=(ScopedPanicHook const&) = delete;
+
+  ~ScopedPanicHook() noexcept {
+    (void)this_thread::exchange_panic_hook(previous_);
+  }
+
+ private:
+  PanicHook previous_;
+};
+
 };  // namespace stx
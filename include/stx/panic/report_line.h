@@ -0,0 +1,129 @@
+/**
+ * @file report_line.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-23
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <thread>  // thread::id NOLINT
+
+#include "stx/panic.h"
+
+namespace stx {
+namespace internal {
+namespace panic_util {
+
+// The line a panic is reported with, shared by the reports of the default
+// panic handler, the signal-safe panic path and the panic ring file:
+//
+// thread with hash: '<hash>' panicked with: '<info>: <payload>' at function:
+// '<function>' [<file>:<line>:<column>]
+//
+// A writer is a `ReportWriter` with a `write_number(value)`. Strings that
+// outlive the report are written with `write_ref(text)` if the writer has it.
+
+constexpr auto kThreadIdHash = std::hash<std::thread::id>{};
+
+/// nanoseconds since the Unix epoch
+inline uint64_t unix_timestamp_ns() noexcept {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+/// writes `text`, which outlives the report, by reference if `report` can
+template <typename Writer>
+void write_lasting(Writer& report, std::string_view text) noexcept {
+  if constexpr (requires { report.write_ref(text); }) {
+    report.write_ref(text);
+  } else {
+    report.write(text);
+  }
+}
+
+template <typename Writer>
+void write_location(Writer& report, char const* str) noexcept {
+  if (str != nullptr) {
+    write_lasting(report, str);
+  } else {
+    report.write("<unknown>");
+  }
+}
+
+template <typename Writer>
+void write_location(Writer& report, uint_least32_t n) noexcept {
+  if (n != 0) {
+    report.write_number(n);
+  } else {
+    report.write("<unknown>");
+  }
+}
+
+// the payload is preceded by ": " if it is not empty and follows the panic info
+template <typename Writer>
+struct PayloadWriter final : public ReportWriter {
+  PayloadWriter(Writer& report, bool separate) noexcept
+      : report{report}, started{!separate} {}
+
+  void write(std::string_view text) noexcept override {
+    if (text.empty()) return;
+    if (!started) {
+      report.write(": ");
+      started = true;
+    }
+    report.write(text);
+  }
+
+  Writer& report;
+  bool started;
+};
+
+/// writes the end of the panic line, from the panic info on
+template <typename Writer>
+void write_panic_message(Writer& report, std::string_view info,
+                         ReportPayload const& payload,
+                         SourceLocation const& location) noexcept {
+  write_lasting(report, info);
+
+  // a deferred payload calls into the reported type's formatter, a panic from
+  // within it is caught as a recursive panic before reaching the handler
+  // again.
+  PayloadWriter<Writer> payload_writer{report, !info.empty()};
+  payload.write_to(payload_writer);
+
+  report.write("' at function: '");
+  write_location(report, location.function_name());
+  report.write("' [");
+  write_location(report, location.file_name());
+  report.write(":");
+  write_location(report, location.line());
+  report.write(":");
+  write_location(report, location.column());
+  report.write("]\n");
+}
+
+/// writes the panic line of the calling thread
+template <typename Writer>
+void write_panic_line(Writer& report, std::string_view info,
+                      ReportPayload const& payload,
+                      SourceLocation const& location) noexcept {
+  report.write("thread with hash: '");
+  report.write_number(kThreadIdHash(std::this_thread::get_id()));
+  report.write("' panicked with: '");
+  write_panic_message(report, info, payload, location);
+}
+
+}  // namespace panic_util
+}  // namespace internal
+}  // namespace stx
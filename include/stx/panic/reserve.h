@@ -0,0 +1,95 @@
+/**
+ * @file reserve.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "stx/config.h"
+
+//! ### Emergency reserve
+//!
+//! A panic is often reported when the process is short of memory or stack: an
+//! allocation failed, or the stack overflowed into its guard page. The report,
+//! and especially the backtrace, then needs memory that may not be there.
+//!
+//! The emergency reserve is set aside at startup, with `setup_panic_reserve`:
+//! - a panic stack, that the default panic handler switches to for writing the
+//! report, so the report does not depend on how much of the panicking
+//! thread's stack is left.
+//! - an alternate signal stack for the thread that set it up, that the
+//! backtrace signal handler (`backtrace::handle_signal`) runs on, so a stack
+//! overflow is still reported.
+//!
+//! An alternate signal stack only serves the thread that installed it. Every
+//! other thread that may overflow its stack installs its own with
+//! `setup_panic_signal_stack` when it starts. Threads started with `spawn` do
+//! so.
+//!
+//! ``` cpp
+//! std::thread worker{[] {
+//!   (void)setup_panic_signal_stack();
+//!   serve();
+//! }};
+//! ```
+//!
+//! The reports are assembled in buffers that are allocated before any panic.
+
+namespace stx {
+
+/// size of each of the stacks of the emergency reserve
+constexpr size_t kPanicReserveStackSize = 64 * 1024;
+
+/// Sets up the emergency reserve, it should be called once at startup from the
+/// main thread. The alternate signal stack is installed for the calling thread
+/// only, other threads call `setup_panic_signal_stack`. Calling it again does
+/// nothing.
+///
+/// Returns `true` if the reserve is set up, `false` if the platform does not
+/// support it or the signal stack could not be installed.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe.
+STX_EXPORT bool setup_panic_reserve() noexcept;
+
+/// Installs an alternate signal stack for the calling thread, allocated now and
+/// freed when the thread exits, so that a stack overflow on it is reported by
+/// the backtrace signal handler. It should be called when the thread starts,
+/// and does nothing if the thread already has one.
+///
+/// Returns `true` if the thread has an alternate signal stack, `false` if the
+/// platform does not support it or the stack could not be allocated.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe.
+STX_EXPORT bool setup_panic_signal_stack() noexcept;
+
+/// Checks if the emergency reserve is set up.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe.
+[[nodiscard]] STX_EXPORT bool panic_reserve_ready() noexcept;
+
+namespace internal {
+namespace panic_reserve {
+
+/// Runs `fn(context)` on the panic stack. Returns `false` without running it
+/// if the reserve is not set up, or the panic stack is in use by another
+/// panicking thread.
+STX_EXPORT bool run(void (*fn)(void*), void* context) noexcept;
+
+}  // namespace panic_reserve
+}  // namespace internal
+
+};  // namespace stx
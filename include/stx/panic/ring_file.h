@@ -0,0 +1,192 @@
+/**
+ * @file ring_file.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-20
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "stx/panic.h"
+#include "stx/panic/hook.h"
+
+#if !CFG(OS, POSIX)
+#error The panic ring file requires a POSIX operating system.
+#endif
+
+//! ### Panic ring file
+//!
+//! When a supervisor restarts a crashed process, its stderr is often lost. The
+//! panic ring file keeps the reports in a file that is memory-mapped at
+//! startup, so a report written into it is in the page cache as soon as it is
+//! written, and survives the process being killed, without an `msync`. The
+//! reports of the previous runs can be read with the `stx_panic_inspect` tool
+//! (`STX_BUILD_TOOLS`).
+//!
+//! ``` cpp
+//! int main() {
+//!   if (open_panic_ring("/var/run/app/panics.ring")) {
+//!     (void)register_panic_hook(panic_ring_hook, nullptr);
+//!   }
+//!   ...
+//! }
+//! ```
+//!
+//! The file is a header followed by a fixed number of fixed-size slots. Each
+//! report takes the slot of a ticket from an atomic counter in the header, so
+//! writing a report never allocates nor blocks, and the oldest reports are
+//! overwritten once the ring is full. A report that does not fit in its slot
+//! is truncated, and one whose slot is still being written by another report
+//! a ticket around the ring behind is dropped.
+
+namespace stx {
+
+/// "STXRING" and a version byte, in little-endian
+constexpr uint64_t kPanicRingMagic = 0x01474E4952585453;
+
+constexpr uint32_t kPanicRingDefaultSlots = 64;
+constexpr uint32_t kPanicRingDefaultSlotSize = 4096;
+
+/// A report read from a panic ring file.
+struct PanicRingRecord {
+  /// the 1-based ticket of the report, increases with each report written to
+  /// the file, across runs
+  uint64_t sequence;
+  uint64_t timestamp_ns;
+  bool truncated;
+  std::string_view report;
+};
+
+namespace internal {
+namespace panic_ring {
+
+struct FileHeader {
+  uint64_t magic;
+  uint32_t num_slots;
+  uint32_t slot_size;
+  // accessed with `std::atomic_ref`, as it is shared by all writers
+  uint64_t next_ticket;
+};
+
+struct SlotHeader {
+  // the slot's ticket + 1 once the report is written, `kSlotWriting` while it
+  // is being written, or 0 if the slot is empty. Accessed with
+  // `std::atomic_ref`, a writer claims the slot by swapping it for
+  // `kSlotWriting`.
+  uint64_t sequence;
+  uint64_t timestamp_ns;
+  uint32_t size;
+  uint32_t truncated;
+};
+
+/// the sequence of a slot whose report is being written
+constexpr uint64_t kSlotWriting = ~uint64_t{0};
+
+/// the slots start at this offset into the file
+constexpr size_t kSlotsOffset = 64;
+
+static_assert(sizeof(FileHeader) <= kSlotsOffset);
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free);
+
+constexpr size_t file_size(uint32_t num_slots, uint32_t slot_size) noexcept {
+  return kSlotsOffset + static_cast<size_t>(num_slots) * slot_size;
+}
+
+/// checks the geometry of the mapped `file`
+inline FileHeader const* valid_header(std::span<char const> file) noexcept {
+  if (file.size() < kSlotsOffset) return nullptr;
+  auto const* header = reinterpret_cast<FileHeader const*>(file.data());
+  if (header->magic != kPanicRingMagic || header->num_slots == 0 ||
+      header->slot_size <= sizeof(SlotHeader) ||
+      file.size() < file_size(header->num_slots, header->slot_size)) {
+    return nullptr;
+  }
+  return header;
+}
+
+}  // namespace panic_ring
+}  // namespace internal
+
+/// Opens (or creates) the panic ring file at `path`, and maps it. A file of
+/// the same geometry is kept as it is, with the reports of previous runs,
+/// else it is reset. It should be called once at startup.
+///
+/// Returns `true` if the ring is open.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe.
+[[nodiscard]] STX_EXPORT bool open_panic_ring(
+    char const* path, uint32_t num_slots = kPanicRingDefaultSlots,
+    uint32_t slot_size = kPanicRingDefaultSlotSize) noexcept;
+
+/// Unmaps the panic ring file, the reports written stay in the file.
+///
+/// # THREAD-SAFETY
+///
+/// No thread may be writing to the ring.
+STX_EXPORT void close_panic_ring() noexcept;
+
+/// A `ChainedPanicHook` that writes the panic report into the panic ring file,
+/// does nothing if it is not open.
+STX_EXPORT void panic_ring_hook(void* context, std::string_view info,
+                                ReportPayload const& payload,
+                                SourceLocation location) noexcept;
+
+/// Calls `fn` on each complete report in the contents of a panic ring `file`,
+/// oldest first. Returns `false` if `file` is not a panic ring file.
+template <typename Fn>
+bool for_each_panic_ring_record(std::span<char const> file, Fn&& fn) {
+  using namespace internal::panic_ring;  // NOLINT
+
+  FileHeader const* header = valid_header(file);
+  if (header == nullptr) return false;
+
+  auto const slot = [&](uint64_t index) {
+    return file.data() + kSlotsOffset + index * header->slot_size;
+  };
+
+  // the newest report has the largest sequence
+  uint64_t newest = 0;
+  for (uint64_t i = 0; i < header->num_slots; i++) {
+    SlotHeader slot_header;
+    std::memcpy(&slot_header, slot(i), sizeof(SlotHeader));
+    if (slot_header.sequence != kSlotWriting &&
+        slot_header.sequence > newest) {
+      newest = slot_header.sequence;
+    }
+  }
+
+  uint64_t oldest =
+      newest > header->num_slots ? newest - header->num_slots + 1 : 1;
+  for (uint64_t sequence = oldest; sequence <= newest && newest != 0;
+       sequence++) {
+    char const* data = slot((sequence - 1) % header->num_slots);
+    SlotHeader slot_header;
+    std::memcpy(&slot_header, data, sizeof(SlotHeader));
+    // an empty slot, or a report that was not completely written
+    if (slot_header.sequence != sequence) continue;
+
+    size_t size = std::min<size_t>(slot_header.size,
+                                   header->slot_size - sizeof(SlotHeader));
+    fn(PanicRingRecord{
+        sequence, slot_header.timestamp_ns, slot_header.truncated != 0,
+        std::string_view{data + sizeof(SlotHeader), size}});
+  }
+
+  return true;
+}
+
+};  // namespace stx
@@ -0,0 +1,155 @@
+/**
+ * @file signal_safe.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-21
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "stx/panic.h"
+
+#if !CFG(OS, POSIX)
+#error The signal-safe panic path requires a POSIX operating system.
+#endif
+
+//! ### Signal-safe panics
+//!
+//! `panic` calls the panic hooks and the panic handler, which format the
+//! payload with user code and may take locks, so it must not be called from a
+//! signal handler. `panic_signal_safe` only calls async-signal-safe functions:
+//! the report is formatted without `std::to_chars` nor `printf` into a static
+//! buffer and written with `write(2)`, and concurrent reports are serialized by
+//! an atomic ticket instead of a lock, so it can be called from a signal
+//! handler, or while one runs. A report that takes over from one that stalled
+//! writes through, as the stalled report may still hold the buffer.
+//!
+//! ``` cpp
+//! void on_sigterm(int) {
+//!   if (!drained) panic_signal_safe("terminated before draining");
+//! }
+//! ```
+//!
+//! The backtrace signal handler (`backtrace::handle_signal`) writes its report
+//! through the same path.
+
+namespace stx {
+
+namespace internal {
+namespace signal_safe {
+
+/// size of the static buffer signal-safe reports are assembled in
+constexpr size_t kSignalReportBufferSize = 4096;
+
+/// how long a report waits, for each report ahead of it, for the report being
+/// written to finish, before it assumes that report's thread was stopped, i.e.
+/// interrupted by the signal whose handler is reporting, and takes over. A
+/// report on the thread of the report being written takes over at once, as
+/// that report can not finish before it does. The report spins for a while,
+/// then sleeps between checks of the turn.
+constexpr uint64_t kSignalReportWaitNs = 1'000'000'000;
+
+/// Formats `value` in `base` (2 to 16) into the end of `digits`, and returns
+/// the number of characters written, which start at `digits + 24 - size`.
+constexpr size_t format_unsigned(uint64_t value, unsigned base,
+                                 char (&digits)[24]) noexcept {
+  constexpr char kDigits[] = "0123456789abcdef";
+  size_t size = 0;
+  do {
+    digits[sizeof(digits) - 1 - size] = kDigits[value % base];
+    value /= base;
+    size++;
+  } while (value != 0);
+  return size;
+}
+
+/// A report assembled in a fixed buffer and written to the panic sink with
+/// `write(2)`. Only one report is written at a time, the report holds the
+/// ticket it took in `begin_signal_report` until `finish`. If the buffer is
+/// held by a report that stalled, every `write` is written through instead.
+class SignalSafeReport final : public ReportWriter {
+ public:
+  SignalSafeReport(SignalSafeReport const&) = delete;
+  SignalSafeReport& operator=(SignalSafeReport const&) = delete;
+
+  /// copies `text` into the report, writes the buffer out once it is full
+  void write(std::string_view text) noexcept override;
+
+  template <typename T>
+  requires std::is_integral_v<T>
+  void write_number(T value, int base = 10) noexcept {
+    char digits[24];
+    size_t size = 0;
+    if constexpr (std::is_signed_v<T>) {
+      if (value < 0) {
+        write("-");
+        // negating the unsigned value is well-defined for the minimum
+        size = format_unsigned(0 - static_cast<uint64_t>(value),
+                               static_cast<unsigned>(base), digits);
+      } else {
+        size = format_unsigned(static_cast<uint64_t>(value),
+                               static_cast<unsigned>(base), digits);
+      }
+    } else {
+      size = format_unsigned(static_cast<uint64_t>(value),
+                             static_cast<unsigned>(base), digits);
+    }
+    write(std::string_view{digits + sizeof(digits) - size, size});
+  }
+
+  /// writes the rest of the report and gives the next report its turn
+  void finish() noexcept;
+
+  /// if the report is assembled in the static buffer, which only one report
+  /// holds at a time
+  [[nodiscard]] constexpr bool holds_buffer() const noexcept {
+    return buffer_ != nullptr;
+  }
+
+ private:
+  friend SignalSafeReport begin_signal_report() noexcept;
+
+  constexpr SignalSafeReport(uint64_t ticket, char* buffer) noexcept
+      : ticket_{ticket}, buffer_{buffer}, size_{0} {}
+
+  void flush() noexcept;
+
+  uint64_t ticket_;
+  // the static buffer, or nullptr to write through
+  char* buffer_;
+  size_t size_;
+};
+
+/// Waits for the turn of a new report and returns the report to write it into.
+/// `finish` must be called on it once it is written.
+[[nodiscard]] STX_EXPORT SignalSafeReport begin_signal_report() noexcept;
+
+/// Writes the panic report of `panic_signal_safe` into `report`.
+STX_EXPORT void write_signal_safe_panic(
+    SignalSafeReport& report, std::string_view info,
+    SourceLocation const& location) noexcept;
+
+}  // namespace signal_safe
+}  // namespace internal
+
+/// Reports the panic to the panic sink (stderr by default) and aborts, only
+/// calling async-signal-safe functions. The panic hooks and the panic handler
+/// are not called, and the thread does not unwind even in `catch_panic`.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe and async-signal-safe.
+[[noreturn]] STX_EXPORT void panic_signal_safe(
+    std::string_view info,
+    SourceLocation location = SourceLocation::current()) noexcept;
+
+};  // namespace stx
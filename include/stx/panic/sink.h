@@ -0,0 +1,130 @@
+/**
+ * @file sink.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-22
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "stx/config.h"
+
+#if CFG(OS, POSIX)
+#include <sys/uio.h>
+#endif
+
+//! ### Panic sink
+//!
+//! The default panic handler and the signal-safe panic path write their
+//! reports to the panic sink, which is stderr unless another sink is chosen at
+//! startup:
+//!
+//! - `set_panic_sink_fd`: a preopened file descriptor, i.e. a pipe dedicated to
+//! panic reports.
+//! - `open_panic_sink_file`: a file opened with `O_APPEND`, rotated to
+//! `<path>.1` once it grows past a size.
+//! - `connect_panic_sink_socket`: a local UNIX datagram socket, i.e. to a log
+//! collector, with each write of a report sent as a datagram.
+//!
+//! ``` cpp
+//! int main() {
+//!   if (!connect_panic_sink_socket("/run/collector/panics.sock")) {
+//!     (void)open_panic_sink_file("/var/log/app/panics.log", 16 << 20);
+//!   }
+//!   ...
+//! }
+//! ```
+//!
+//! Reports are still assembled in the handler's buffer and written with one
+//! call per buffer. Unlike stderr, the sinks are non-blocking: if the pipe or
+//! the collector's queue is full, the rest of the report is dropped and
+//! counted (`panic_sink_dropped`) instead of blocking the panicking thread.
+
+namespace stx {
+
+#if CFG(OS, POSIX)
+
+enum class PanicSinkKind : uint8_t {
+  /// fd 2, the default, written in blocking mode
+  Stderr,
+  /// a preopened file descriptor
+  Fd,
+  /// a file opened with `O_APPEND`, rotated by size
+  File,
+  /// a connected UNIX datagram socket
+  Socket
+};
+
+/// Writes panic reports to `fd`, which should be dedicated to them. `fd` is
+/// set to non-blocking mode, and is not closed by the sink.
+///
+/// Returns `true` if the sink was set.
+///
+/// # THREAD-SAFETY
+///
+/// thread-safe, but it should be called once at startup, as a report being
+/// written concurrently by the signal-safe panic path may be lost.
+[[nodiscard]] STX_EXPORT bool set_panic_sink_fd(int fd) noexcept;
+
+/// Writes panic reports to the file at `path`, opened (or created) with
+/// `O_APPEND`. Once the file is `max_size` bytes or more, it is renamed to
+/// `<path>.1`, replacing the previous one, before the next report is written
+/// to a new file. A `max_size` of 0 disables rotation.
+///
+/// Returns `true` if the file was opened.
+///
+/// # THREAD-SAFETY
+///
+/// as with `set_panic_sink_fd`.
+[[nodiscard]] STX_EXPORT bool open_panic_sink_file(char const* path,
+                                                   size_t max_size) noexcept;
+
+/// Sends panic reports to the UNIX datagram socket bound at `path`. A report
+/// that does not fit in the handler's buffer is sent as several datagrams.
+///
+/// Returns `true` if the socket was connected.
+///
+/// # THREAD-SAFETY
+///
+/// as with `set_panic_sink_fd`.
+[[nodiscard]] STX_EXPORT bool connect_panic_sink_socket(
+    char const* path) noexcept;
+
+/// Writes panic reports to stderr again, closing the file or socket the sink
+/// opened.
+///
+/// # THREAD-SAFETY
+///
+/// as with `set_panic_sink_fd`.
+STX_EXPORT void reset_panic_sink() noexcept;
+
+/// The kind of the current panic sink.
+[[nodiscard]] STX_EXPORT PanicSinkKind panic_sink_kind() noexcept;
+
+/// Number of report writes cut short because the sink was full.
+[[nodiscard]] STX_EXPORT uint64_t panic_sink_dropped() noexcept;
+
+namespace internal {
+namespace panic_sink {
+
+/// Writes `iov` to the sink, rotating the file first if it is due. The caller
+/// holds the default handler's `stderr_lock`.
+STX_EXPORT void write_segments(iovec* iov, int num) noexcept;
+
+/// Writes `data` to the sink with `write(2)`, without rotating. It is
+/// async-signal-safe.
+STX_EXPORT void write_all(char const* data, size_t size) noexcept;
+
+}  // namespace panic_sink
+}  // namespace internal
+
+#endif
+
+};  // namespace stx
@@ -0,0 +1,171 @@
+/**
+ * @file unwind.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-14
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include "stx/catch.h"
+#include "stx/panic.h"
+#include "stx/result.h"
+
+//! ### Unwinding panics
+//!
+//! By default a panic ends the program once it is handled. When STX is built
+//! with `STX_ENABLE_PANIC_UNWIND` (and exceptions are enabled), a thread can
+//! opt in to unwinding by running code in `catch_panic`: a panic then runs the
+//! panic hooks as usual, and throws `PanicUnwind` instead of aborting. The
+//! stack is unwound up to `catch_panic`, which returns the panic as an `Err`,
+//! and the thread continues.
+//!
+//! ``` cpp
+//! void worker(Queue& queue) {
+//!   for (Task& task : queue) {
+//!     catch_panic([&] { task.run(); }).match(
+//!         [](Unit) {}, [&](PanicInfo info) { task.fail(info.report()); });
+//!   }
+//! }
+//! ```
+//!
+//! A panic outside of `catch_panic`, or while the stack is being unwound from
+//! another panic, still aborts.
+
+namespace stx {
+
+/// maximum size of the info of a `PanicInfo`, longer infos are truncated
+constexpr size_t kPanicInfoSize = 256;
+
+/// maximum size of the report of a `PanicInfo`, longer reports are truncated
+constexpr size_t kPanicReportSize = 1024;
+
+/// maximum number of backtrace frames a `PanicInfo` holds
+constexpr size_t kMaxPanicFrames = 32;
+
+/// A panic caught by `catch_panic`.
+///
+/// The panic is copied into storage held by the `PanicInfo`, so a caught panic
+/// does not allocate: each thread keeps a preallocated `PanicInfo` that the
+/// panic is copied into before the stack is unwound, and `catch_panic` copies
+/// it from there. The info and report are truncated if they do not fit.
+class PanicInfo {
+ public:
+  constexpr PanicInfo() noexcept = default;
+
+  /// copies `info`, the formatted `payload`, `location` and, if panic
+  /// backtraces are enabled, the backtrace of the calling thread.
+  STX_EXPORT PanicInfo(std::string_view info, ReportPayload const& payload,
+                       SourceLocation location) noexcept;
+
+  /// the info the panic was raised with
+  [[nodiscard]] std::string_view info() const noexcept {
+    return std::string_view{info_, info_size_};
+  }
+
+  /// the formatted payload of the panic, if any
+  [[nodiscard]] std::string_view report() const noexcept {
+    return std::string_view{report_, report_size_};
+  }
+
+  /// whether the info or the report was truncated
+  [[nodiscard]] bool truncated() const noexcept { return truncated_; }
+
+  [[nodiscard]] SourceLocation const& location() const noexcept {
+    return location_;
+  }
+
+  /// the instruction pointers of the panicking thread's stack, innermost
+  /// first. empty if panic backtraces are not enabled
+  /// (`STX_ENABLE_PANIC_BACKTRACE`).
+  [[nodiscard]] std::span<uintptr_t const> backtrace() const noexcept {
+    return std::span<uintptr_t const>{frames_, num_frames_};
+  }
+
+ private:
+  char info_[kPanicInfoSize] = {};
+  size_t info_size_ = 0;
+  char report_[kPanicReportSize] = {};
+  size_t report_size_ = 0;
+  bool truncated_ = false;
+  SourceLocation location_;
+  uintptr_t frames_[kMaxPanicFrames] = {};
+  size_t num_frames_ = 0;
+};
+
+/// The exception thrown by a panic within `catch_panic`. It does not derive
+/// from `std::exception`, so that `catch (std::exception const&)` blocks do not
+/// swallow panics. It should not be caught by other code.
+///
+/// It carries no state, the panic is in the thread's `PanicInfo` slot.
+class PanicUnwind {};
+
+namespace internal {
+namespace panic_unwind {
+
+/// marks the thread as running in `catch_panic`
+STX_EXPORT void enter_catch() noexcept;
+
+/// marks the thread as having left `catch_panic`
+STX_EXPORT void leave_catch() noexcept;
+
+/// marks the thread as no longer panicking, once its panic is caught
+STX_EXPORT void recover() noexcept;
+
+/// the thread's preallocated slot that a panic unwinding to `catch_panic` is
+/// copied into
+[[nodiscard]] STX_EXPORT PanicInfo const& thread_panic_info() noexcept;
+
+struct CatchScope {
+  CatchScope() noexcept { enter_catch(); }
+  CatchScope(CatchScope const&) = delete;
+  CatchScope& operator=(CatchScope const&) = delete;
+  ~CatchScope() noexcept { leave_catch(); }
+};
+
+}  // namespace panic_unwind
+}  // namespace internal
+
+/// Invokes `fn` and returns its result as `Ok`. If `fn` panics and panics can
+/// unwind (`kPanicUnwind`), the panic is returned as `Err` once the stack is
+/// unwound, and the thread is no longer panicking. Else the panic aborts as
+/// usual. If `fn` returns `void`, the `Ok` value is `Unit`.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// auto result = catch_panic([] { return Option<int>{None}.unwrap(); });
+/// ASSERT_TRUE(result.is_err());
+/// ```
+template <typename Fn>
+requires invocable<Fn&> [[nodiscard]] auto catch_panic(Fn&& fn)
+    -> Result<internal::catch_result::value_type<Fn>, PanicInfo> {
+  using result_type =
+      Result<internal::catch_result::value_type<Fn>, PanicInfo>;
+
+#if defined(STX_ENABLE_PANIC_UNWIND) && defined(__cpp_exceptions)
+  internal::panic_unwind::CatchScope scope;
+  try {
+    return internal::catch_result::invoke_ok<result_type>(fn);
+  } catch (PanicUnwind const&) {
+    internal::panic_unwind::recover();
+    return Err(PanicInfo{internal::panic_unwind::thread_panic_info()});
+  }
+#else
+  return internal::catch_result::invoke_ok<result_type>(fn);
+#endif
+}
+
+};  // namespace stx
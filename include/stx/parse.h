@@ -0,0 +1,274 @@
+/**
+ * @file parse.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-09
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "stx/report.h"
+#include "stx/result.h"
+
+//! ### Number parsing
+//!
+//! `parse<T>` parses the whole of a string as a number, and returns the reason
+//! for failure instead of throwing (as `std::stoi` does) or returning a
+//! sentinel (as `std::atoi` does). It is built on `std::from_chars`, so it
+//! does not allocate and is not affected by the locale.
+//!
+//! ``` cpp
+//! ASSERT_EQ(parse<int32_t>("-42"), Ok(-42));
+//! ASSERT_EQ(parse<uint8_t>("256").unwrap_err().kind, ParseErrorKind::OutOfRange);
+//! ASSERT_EQ(parse<double>("1.5e3"), Ok(1500.0));
+//! ```
+//!
+//! `parse_column` parses a delimited run of fields (i.e. a CSV column). For
+//! integer columns, the text is first validated with SIMD, after which short
+//! fields are converted without per-character checks.
+
+namespace stx {
+
+/// the reason a number could not be parsed
+enum class ParseErrorKind : uint8_t {
+  /// the input is empty
+  Empty,
+  /// the input contains a character that is not part of the number
+  InvalidDigit,
+  /// the number is not representable in the target type
+  OutOfRange
+};
+
+/// Error type for `parse<T>`.
+///
+/// `input` refers to the string passed to `parse`, the error is meant to be
+/// reported or handled while that string is still alive.
+struct ParseError {
+  ParseErrorKind kind;
+  /// offset of the first character that could not be parsed
+  size_t offset;
+  /// the input that failed to parse
+  std::string_view input;
+
+  [[nodiscard]] constexpr bool operator==(ParseError const&) const = default;
+};
+
+/// Error type for `parse_column`, `index` is the index of the field that
+/// failed to parse.
+struct ParseErrorAt {
+  ParseError error;
+  size_t index;
+
+  [[nodiscard]] constexpr bool operator==(ParseErrorAt const&) const = default;
+};
+
+/// types that can be parsed by `parse<T>`: integral types (except `bool` and
+/// the character types) and floating-point types.
+template <typename T>
+concept Parseable =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+     !std::is_same_v<T, char> && !std::is_same_v<T, wchar_t> &&
+     !std::is_same_v<T, char8_t> && !std::is_same_v<T, char16_t> &&
+     !std::is_same_v<T, char32_t>) ||
+    std::is_floating_point_v<T>;
+
+/// Parses the whole of `input` as a decimal number.
+///
+/// The accepted syntax is that of `std::from_chars`: no leading whitespace or
+/// `+` sign, and a leading `-` only for signed and floating-point types.
+/// Floating-point numbers may be in fixed or scientific notation, or one of
+/// `inf` and `nan`.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// ASSERT_EQ(parse<int32_t>("-42"), Ok(-42));
+/// ASSERT_EQ(parse<int32_t>("4x2").unwrap_err(),
+///           (ParseError{ParseErrorKind::InvalidDigit, 1, "4x2"}));
+/// ASSERT_EQ(parse<int32_t>("").unwrap_err().kind, ParseErrorKind::Empty);
+/// ```
+template <Parseable T>
+[[nodiscard]] auto parse(std::string_view input) noexcept
+    -> Result<T, ParseError> {
+  if (input.empty()) return Err(ParseError{ParseErrorKind::Empty, 0, input});
+
+  T value{};
+  char const* const first = input.data();
+  char const* const last = first + input.size();
+  std::from_chars_result result = std::from_chars(first, last, value);
+
+  if (result.ec == std::errc::result_out_of_range) [[unlikely]] {
+    return Err(ParseError{ParseErrorKind::OutOfRange, 0, input});
+  }
+
+  if (result.ec != std::errc{} || result.ptr != last) [[unlikely]] {
+    return Err(ParseError{ParseErrorKind::InvalidDigit,
+                          static_cast<size_t>(result.ptr - first), input});
+  }
+
+  return Ok(std::move(value));
+}
+
+namespace internal {
+namespace parse {
+
+/// checks that `text` only consists of decimal digits and `delimiter`s, and
+/// if `allow_minus` is true, `-` signs at the start of a field.
+/// uses AVX2 (selected at runtime) or NEON where available.
+[[nodiscard]] bool is_integer_column(std::string_view text, char delimiter,
+                                     bool allow_minus) noexcept;
+
+/// converts a field that has been validated by `is_integer_column`, returns
+/// false if the field is empty or too long to be converted without overflow
+/// checks.
+template <typename T>
+[[nodiscard]] STX_FORCE_INLINE constexpr bool convert_digits(
+    std::string_view field, T& value) noexcept {
+  using U = std::make_unsigned_t<T>;
+  bool negative = false;
+  if constexpr (std::is_signed_v<T>) {
+    if (!field.empty() && field[0] == '-') {
+      negative = true;
+      field.remove_prefix(1);
+    }
+  }
+
+  if (field.empty() ||
+      field.size() > static_cast<size_t>(std::numeric_limits<T>::digits10))
+    return false;
+
+  U magnitude = 0;
+  for (char digit : field) {
+    magnitude = static_cast<U>(magnitude * 10 + static_cast<U>(digit - '0'));
+  }
+
+  value = negative ? static_cast<T>(U{0} - magnitude)
+                   : static_cast<T>(magnitude);
+  return true;
+}
+
+}  // namespace parse
+}  // namespace internal
+
+/// Parses the `delimiter`-separated fields of `text` into `out` with
+/// `parse<T>`, returns the written part of `out`, else an error with the index
+/// of the first field that failed to parse. Only the first `out.size()` fields
+/// are parsed, and an empty `text` has no fields.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// std::array<int64_t, 8> out;
+/// ASSERT_EQ(parse_column<int64_t>("1,-2,3", ',', out).unwrap().size(), 3);
+///
+/// ASSERT_EQ(parse_column<int64_t>("1,,3", ',', out).unwrap_err().index, 1);
+/// ```
+template <Parseable T>
+[[nodiscard]] auto parse_column(std::string_view text, char delimiter,
+                                std::span<T> out) noexcept
+    -> Result<std::span<T>, ParseErrorAt> {
+  bool fast = false;
+  if constexpr (std::is_integral_v<T>) {
+    fast = internal::parse::is_integer_column(text, delimiter,
+                                              std::is_signed_v<T>);
+  }
+
+  size_t index = 0;
+  std::string_view rest = text;
+
+  while (!text.empty() && index < out.size()) {
+    size_t end = rest.find(delimiter);
+    std::string_view field = rest.substr(0, end);
+
+    bool converted = false;
+    if constexpr (std::is_integral_v<T>) {
+      converted = fast && internal::parse::convert_digits(field, out[index]);
+    }
+
+    if (!converted) {
+      Result<T, ParseError> value = parse<T>(field);
+      if (value.is_err()) [[unlikely]] {
+        return Err(ParseErrorAt{std::move(value).unwrap_err(), index});
+      }
+      out[index] = std::move(value).unwrap();
+    }
+
+    index++;
+    if (end == std::string_view::npos) break;
+    rest.remove_prefix(end + 1);
+  }
+
+  return Ok(out.first(index));
+}
+
+/// longest part of the input printed in a parse error's report
+constexpr int kMaxReportedParseInput = 64;
+
+/// reports the kind of error and the offending input, i.e.
+/// `invalid digit at offset 2 in "12x4"`
+[[nodiscard]] inline Report operator>>(ReportQuery,
+                                       ParseError const& error) noexcept {
+  char buffer[128 + kMaxReportedParseInput];
+  int input_size = error.input.size() > kMaxReportedParseInput
+                       ? kMaxReportedParseInput
+                       : static_cast<int>(error.input.size());
+  char const* ellipsis =
+      error.input.size() > kMaxReportedParseInput ? "..." : "";
+  int written = 0;
+
+  switch (error.kind) {
+    case ParseErrorKind::Empty:
+      written = std::snprintf(buffer, sizeof(buffer),
+                              "cannot parse number from empty string");
+      break;
+    case ParseErrorKind::InvalidDigit:
+      written = std::snprintf(
+          buffer, sizeof(buffer), "invalid digit at offset %zu in \"%.*s%s\"",
+          error.offset, input_size, error.input.data(), ellipsis);
+      break;
+    case ParseErrorKind::OutOfRange:
+      written = std::snprintf(buffer, sizeof(buffer),
+                              "number out of range in \"%.*s%s\"", input_size,
+                              error.input.data(), ellipsis);
+      break;
+  }
+
+  if (written <= 0) internal::report::write_unknown(buffer);
+
+  return Report(buffer);
+}
+
+/// reports the field index and its parse error, i.e.
+/// `field 3: number out of range in "300"`
+[[nodiscard]] inline Report operator>>(ReportQuery query,
+                                       ParseErrorAt const& error) noexcept {
+  Report report = query >> error.error;
+  char buffer[kMaxReportSize];
+  int written = std::snprintf(buffer, sizeof(buffer), "field %zu: %.*s",
+                              error.index,
+                              static_cast<int>(report.what().size()),
+                              report.what().data());
+  if (written <= 0) internal::report::write_unknown(buffer);
+
+  return Report(buffer);
+}
+
+};  // namespace stx
@@ -0,0 +1,508 @@
+/**
+ * @file ranges.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-02
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "stx/option.h"
+#include "stx/result.h"
+
+//! @file
+//!
+//! `std::ranges` integration for `Option` and `Result`.
+//!
+//! `Option<T>` is itself a sized, contiguous range of at most one element.
+//! This file provides views for working with ranges of `Option`s and
+//! `Result`s. Every view here is fused: filtering and projecting happen in the
+//! view's iterator, so a pipeline compiles down to a single loop over the
+//! underlying range, without materializing intermediate ranges nor
+//! `Option`s.
+//!
+//! ``` cpp
+//! vector<Option<int>> v;
+//! v.push_back(Some(1));
+//! v.push_back(None);
+//! v.push_back(Some(3));
+//!
+//! int sum = 0;
+//! for (int& x : v | views::flatten_options) sum += x;
+//! ASSERT_EQ(sum, 4);
+//! ```
+//!
+//! `flatten_options`, `ok_values`, `err_values` and `transpose` yield
+//! references into the underlying range's elements and therefore require it
+//! to yield l-value references.
+//!
+
+namespace stx {
+
+namespace internal {
+namespace ranges {
+
+template <typename T>
+struct is_option : std::false_type {};
+
+template <typename T>
+struct is_option<Option<T>> : std::true_type {};
+
+template <typename T>
+struct is_result : std::false_type {};
+
+template <typename T, typename E>
+struct is_result<Result<T, E>> : std::true_type {};
+
+template <typename R>
+concept LValueRange =
+    std::ranges::input_range<R> &&
+    std::is_lvalue_reference_v<std::ranges::range_reference_t<R>>;
+
+template <typename R>
+concept OptionRange =
+    LValueRange<R> &&
+    is_option<std::remove_cvref_t<std::ranges::range_reference_t<R>>>::value;
+
+template <typename R>
+concept ResultRange =
+    LValueRange<R> &&
+    is_result<std::remove_cvref_t<std::ranges::range_reference_t<R>>>::value;
+
+/// Wraps a function object so that it is always move-assignable, as
+/// required of views. Lambdas with captures are not assignable.
+template <typename Fn>
+requires std::is_object_v<Fn>&& std::move_constructible<Fn>  //
+    class MovableBox {
+ public:
+  constexpr explicit MovableBox(Fn fn) : fn_(std::move(fn)) {}
+
+  constexpr MovableBox(MovableBox const& rhs) requires copy_constructible<Fn>
+      : fn_(rhs.fn_) {}
+
+  constexpr MovableBox(MovableBox&& rhs) : fn_(std::move(rhs.fn_)) {}
+
+  constexpr MovableBox& operator=(MovableBox const& rhs) requires
+      copy_constructible<Fn> {
+    if (this != &rhs) {
+      std::destroy_at(std::addressof(fn_));
+      std::construct_at(std::addressof(fn_), rhs.fn_);
+    }
+    return *this;
+  }
+
+  constexpr MovableBox& operator=(MovableBox&& rhs) {
+    if (this != &rhs) {
+      std::destroy_at(std::addressof(fn_));
+      std::construct_at(std::addressof(fn_), std::move(rhs.fn_));
+    }
+    return *this;
+  }
+
+  constexpr ~MovableBox() { std::destroy_at(std::addressof(fn_)); }
+
+  [[nodiscard]] constexpr Fn& get() noexcept { return fn_; }
+  [[nodiscard]] constexpr Fn const& get() const noexcept { return fn_; }
+
+ private:
+  union {
+    Fn fn_;
+  };
+};
+
+/// selects the value of the `Some` elements
+struct SelectSome {
+  static constexpr bool keep(auto const& option) noexcept {
+    return option.is_some();
+  }
+
+  static constexpr auto& get(auto& option) noexcept { return *option.begin(); }
+};
+
+/// selects the value of the `Ok` elements
+struct SelectOk {
+  static constexpr bool keep(auto const& result) noexcept {
+    return result.is_ok();
+  }
+
+  static constexpr auto& get(auto& result) noexcept { return result.value(); }
+};
+
+/// selects the error of the `Err` elements
+struct SelectErr {
+  static constexpr bool keep(auto const& result) noexcept {
+    return result.is_err();
+  }
+
+  static constexpr auto& get(auto& result) noexcept {
+    return result.err_value();
+  }
+};
+
+/// Yields `Selector::get(element)` for each element of `Base` for which
+/// `Selector::keep(element)` is true.
+template <std::ranges::view Base, typename Selector>
+requires LValueRange<Base>  //
+    class SelectView
+    : public std::ranges::view_interface<SelectView<Base, Selector>> {
+  using base_iterator = std::ranges::iterator_t<Base>;
+  using base_sentinel = std::ranges::sentinel_t<Base>;
+
+ public:
+  class Sentinel;
+
+  class Iterator {
+   public:
+    using reference = decltype(Selector::get(*std::declval<base_iterator>()));
+    using value_type = std::remove_cvref_t<reference>;
+    using difference_type = std::ranges::range_difference_t<Base>;
+    using iterator_concept =
+        std::conditional_t<std::ranges::forward_range<Base>,
+                           std::forward_iterator_tag, std::input_iterator_tag>;
+
+    constexpr Iterator() = default;
+
+    constexpr Iterator(base_iterator current, base_sentinel end)
+        : current_(std::move(current)), end_(std::move(end)) {
+      satisfy();
+    }
+
+    [[nodiscard]] constexpr reference operator*() const {
+      return Selector::get(*current_);
+    }
+
+    constexpr Iterator& operator++() {
+      ++current_;
+      satisfy();
+      return *this;
+    }
+
+    constexpr void operator++(int) { ++*this; }
+
+    constexpr Iterator operator++(int) requires
+        std::ranges::forward_range<Base> {
+      Iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    [[nodiscard]] friend constexpr bool operator==(
+        Iterator const& a,
+        Iterator const& b) requires std::equality_comparable<base_iterator> {
+      return a.current_ == b.current_;
+    }
+
+    [[nodiscard]] friend constexpr bool operator==(Iterator const& it,
+                                                   Sentinel const&) {
+      return it.current_ == it.end_;
+    }
+
+   private:
+    constexpr void satisfy() {
+      while (current_ != end_ && !Selector::keep(*current_)) ++current_;
+    }
+
+    base_iterator current_{};
+    base_sentinel end_{};
+  };
+
+  class Sentinel {};
+
+  constexpr SelectView() = default;
+
+  constexpr explicit SelectView(Base base) : base_(std::move(base)) {}
+
+  [[nodiscard]] constexpr Base base() const& requires
+      std::copy_constructible<Base> {
+    return base_;
+  }
+
+  [[nodiscard]] constexpr Base base() && { return std::move(base_); }
+
+  [[nodiscard]] constexpr Iterator begin() {
+    return Iterator(std::ranges::begin(base_), std::ranges::end(base_));
+  }
+
+  [[nodiscard]] constexpr Sentinel end() { return Sentinel{}; }
+
+ private:
+  Base base_{};
+};
+
+/// Yields the contained value of the `Option`s returned by invoking `Fn` on
+/// each element of `Base`, skipping the `None`s.
+template <std::ranges::view Base, typename Fn>
+requires std::ranges::input_range<Base>&&
+    invocable<Fn&, std::ranges::range_reference_t<Base>>&&
+        is_option<invoke_result<Fn&, std::ranges::range_reference_t<Base>>>::
+            value  //
+    class FilterMapView
+    : public std::ranges::view_interface<FilterMapView<Base, Fn>> {
+  using base_iterator = std::ranges::iterator_t<Base>;
+  using base_sentinel = std::ranges::sentinel_t<Base>;
+  using option_type = invoke_result<Fn&, std::ranges::range_reference_t<Base>>;
+
+ public:
+  class Sentinel;
+
+  /// The mapped value is kept in the iterator until it is advanced, so the
+  /// iterator is move-only and the view is single-pass.
+  class Iterator {
+   public:
+    using value_type = typename option_type::value_type;
+    using reference = value_type&;
+    using difference_type = std::ranges::range_difference_t<Base>;
+    using iterator_concept = std::input_iterator_tag;
+
+    constexpr Iterator(FilterMapView& parent, base_iterator current)
+        : parent_(std::addressof(parent)),
+          current_(std::move(current)),
+          cache_(None) {
+      satisfy();
+    }
+
+    constexpr Iterator(Iterator&&) = default;
+    constexpr Iterator& operator=(Iterator&&) = default;
+
+    [[nodiscard]] constexpr reference operator*() const {
+      return *cache_.begin();
+    }
+
+    [[nodiscard]] constexpr base_iterator const& base() const& noexcept {
+      return current_;
+    }
+
+    constexpr Iterator& operator++() {
+      ++current_;
+      satisfy();
+      return *this;
+    }
+
+    constexpr void operator++(int) { ++*this; }
+
+   private:
+    constexpr void satisfy() {
+      base_sentinel end = std::ranges::end(parent_->base_);
+      for (; current_ != end; ++current_) {
+        if constexpr (std::is_nothrow_invocable_v<
+                          Fn&, std::ranges::range_reference_t<Base>>) {
+          // construct the mapped `Option` directly in the cache, this can't
+          // leave the cache destroyed since the invocation can't throw
+          std::destroy_at(std::addressof(cache_));
+          new (std::addressof(cache_))
+              option_type(std::invoke(parent_->fn_.get(), *current_));
+        } else {
+          cache_ = std::invoke(parent_->fn_.get(), *current_);
+        }
+        if (cache_.is_some()) return;
+      }
+    }
+
+    FilterMapView* parent_;
+    base_iterator current_;
+    mutable option_type cache_;
+  };
+
+  class Sentinel {
+   public:
+    constexpr Sentinel() = default;
+    constexpr explicit Sentinel(base_sentinel end) : end_(std::move(end)) {}
+
+    [[nodiscard]] friend constexpr bool operator==(Iterator const& it,
+                                                   Sentinel const& end) {
+      return it.base() == end.end_;
+    }
+
+   private:
+    base_sentinel end_{};
+  };
+
+  constexpr FilterMapView(Base base, Fn fn)
+      : base_(std::move(base)), fn_(std::move(fn)) {}
+
+  [[nodiscard]] constexpr Base base() const& requires
+      std::copy_constructible<Base> {
+    return base_;
+  }
+
+  [[nodiscard]] constexpr Base base() && { return std::move(base_); }
+
+  [[nodiscard]] constexpr Iterator begin() {
+    return Iterator(*this, std::ranges::begin(base_));
+  }
+
+  [[nodiscard]] constexpr Sentinel end() {
+    return Sentinel(std::ranges::end(base_));
+  }
+
+ private:
+  Base base_;
+  MovableBox<Fn> fn_;
+};
+
+/// Transposes an `Option<Result<T, E>>` element into a
+/// `Result<Option<Ref<T>>, Ref<E>>`. `None` maps to `Ok(None)`, `Some(Ok(v))`
+/// to `Ok(Some(v))` and `Some(Err(e))` to `Err(e)`.
+struct TransposeFn {
+  template <typename T, typename E>
+  [[nodiscard]] constexpr auto operator()(Option<Result<T, E>>& option) const
+      -> Result<Option<MutRef<T>>, MutRef<E>> {
+    if (option.is_none()) {
+      return Ok(Option<MutRef<T>>(None));
+    }
+
+    Result<T, E>& result = *option.begin();
+
+    if (result.is_ok()) {
+      return Ok(Option<MutRef<T>>(Some(MutRef<T>(result.value()))));
+    } else {
+      return Err(MutRef<E>(result.err_value()));
+    }
+  }
+
+  template <typename T, typename E>
+  [[nodiscard]] constexpr auto operator()(
+      Option<Result<T, E>> const& option) const
+      -> Result<Option<ConstRef<T>>, ConstRef<E>> {
+    if (option.is_none()) {
+      return Ok(Option<ConstRef<T>>(None));
+    }
+
+    Result<T, E> const& result = *option.begin();
+
+    if (result.is_ok()) {
+      return Ok(Option<ConstRef<T>>(Some(ConstRef<T>(result.value()))));
+    } else {
+      return Err(ConstRef<E>(result.err_value()));
+    }
+  }
+};
+
+/// Makes `Fn` usable both as `fn(range)` and as `range | fn`.
+template <typename Fn>
+struct RangeAdaptorClosure {
+  Fn fn;
+
+  template <std::ranges::viewable_range R>
+  requires invocable<Fn const&, R&&>  //
+      [[nodiscard]] constexpr auto operator()(R&& range) const {
+    return fn(std::forward<R>(range));
+  }
+
+  template <std::ranges::viewable_range R>
+  requires invocable<Fn const&, R&&>  //
+      [[nodiscard]] friend constexpr auto operator|(
+          R&& range, RangeAdaptorClosure const& closure) {
+    return closure.fn(std::forward<R>(range));
+  }
+};
+
+template <typename Selector, template <typename> typename Requirement>
+struct SelectFn {
+  template <std::ranges::viewable_range R>
+  requires Requirement<std::views::all_t<R>>::value  //
+      [[nodiscard]] constexpr auto operator()(R&& range) const {
+    return SelectView<std::views::all_t<R>, Selector>(
+        std::views::all(std::forward<R>(range)));
+  }
+};
+
+template <typename R>
+struct is_option_range : std::bool_constant<OptionRange<R>> {};
+
+template <typename R>
+struct is_result_range : std::bool_constant<ResultRange<R>> {};
+
+template <typename R>
+struct is_option_of_result_range
+    : std::bool_constant<LValueRange<R> &&
+                         is_option<std::remove_cvref_t<
+                             std::ranges::range_reference_t<R>>>::value> {};
+
+struct TransposeViewFn {
+  template <std::ranges::viewable_range R>
+  requires is_option_of_result_range<std::views::all_t<R>>::value  //
+      [[nodiscard]] constexpr auto operator()(R&& range) const {
+    return std::views::transform(std::forward<R>(range), TransposeFn{});
+  }
+};
+
+}  // namespace ranges
+}  // namespace internal
+
+namespace views {
+
+/// Maps each element of a range with `fn`, which returns an `Option`, and
+/// yields the values of the `Some`s, skipping the `None`s.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// vector<string_view> v{"1"sv, "x"sv, "3"sv};
+/// auto digit = [](string_view s) -> Option<int> {
+///   if (s[0] >= '0' && s[0] <= '9') return Some(s[0] - '0');
+///   return None;
+/// };
+///
+/// int sum = 0;
+/// for (int x : v | views::filter_map(digit)) sum += x;
+/// ASSERT_EQ(sum, 4);
+/// ```
+template <std::ranges::viewable_range R, typename Fn>
+[[nodiscard]] constexpr auto filter_map(R&& range, Fn&& fn) {
+  return internal::ranges::FilterMapView<std::views::all_t<R>,
+                                         std::decay_t<Fn>>(
+      std::views::all(std::forward<R>(range)), std::forward<Fn>(fn));
+}
+
+template <typename Fn>
+[[nodiscard]] constexpr auto filter_map(Fn&& fn) {
+  auto closure = [fn = std::forward<Fn>(fn)](auto&& range) {
+    return filter_map(std::forward<decltype(range)>(range), fn);
+  };
+  return internal::ranges::RangeAdaptorClosure<decltype(closure)>{
+      std::move(closure)};
+}
+
+/// Yields a reference to the value of each `Some` element of a range of
+/// `Option`s, skipping the `None`s.
+inline constexpr internal::ranges::RangeAdaptorClosure<
+    internal::ranges::SelectFn<internal::ranges::SelectSome,
+                               internal::ranges::is_option_range>>
+    flatten_options{};
+
+/// Yields a reference to the value of each `Ok` element of a range of
+/// `Result`s, skipping the `Err`s.
+inline constexpr internal::ranges::RangeAdaptorClosure<
+    internal::ranges::SelectFn<internal::ranges::SelectOk,
+                               internal::ranges::is_result_range>>
+    ok_values{};
+
+/// Yields a reference to the error of each `Err` element of a range of
+/// `Result`s, skipping the `Ok`s.
+inline constexpr internal::ranges::RangeAdaptorClosure<
+    internal::ranges::SelectFn<internal::ranges::SelectErr,
+                               internal::ranges::is_result_range>>
+    err_values{};
+
+/// Transposes each `Option<Result<T, E>>` element of a range into a
+/// `Result<Option<Ref<T>>, Ref<E>>` referring to the element's contents.
+inline constexpr internal::ranges::RangeAdaptorClosure<
+    internal::ranges::TransposeViewFn>
+    transpose{};
+
+}  // namespace views
+}  // namespace stx
@@ -12,10 +12,20 @@
 #pragma once
 
 #include <array>
+#include <bit>
+#include <charconv>
 #include <cinttypes>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <limits>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include "stx/common.h"
 
@@ -81,22 +91,391 @@ class [[nodiscard]] Report {
   template <typename T>
   friend Report operator>>(ReportQuery, T const&) noexcept;
 
+  friend class ReportBuilder;
+
  private:
+  constexpr Report() noexcept : report_{}, used_size_{0} {}
+
   storage_type report_;
   size_t used_size_;
 };
 
+template <typename T>
+concept Reportable = requires(ReportQuery const query, T const& v) {
+  { query >> v }
+  ->same_as<Report>;
+};
+
+#ifndef STX_REPORT_ENUM_MIN
+/// smallest enum value whose name is looked up at compile-time for reporting
+constexpr int64_t kReportEnumMin = -128;
+#else
+constexpr int64_t kReportEnumMin = STX_REPORT_ENUM_MIN;
+#endif
+
+#ifndef STX_REPORT_ENUM_MAX
+/// largest enum value whose name is looked up at compile-time for reporting
+constexpr int64_t kReportEnumMax = 127;
+#else
+constexpr int64_t kReportEnumMax = STX_REPORT_ENUM_MAX;
+#endif
+
+static_assert(kReportEnumMin <= 0 && kReportEnumMax >= 0 &&
+                  kReportEnumMax - kReportEnumMin < 4096,
+              "STX_REPORT_ENUM_MIN and STX_REPORT_ENUM_MAX must contain 0 "
+              "and span less than 4096 values");
+
+namespace internal {
+namespace report {
+// this allows tolerance for platforms without snprintf.
+constexpr inline void write_unknown(char* buffer) noexcept {
+  buffer[0] = '<';
+  buffer[1] = '?';
+  buffer[2] = '>';
+  buffer[3] = '\0';
+}
+
+constexpr auto query = ReportQuery{};
+
+/// the library's overloads for open-ended categories of types (enums and
+/// pointers) take a `FallbackQuery`, which requires a conversion from
+/// `ReportQuery`. A user-provided overload taking a `ReportQuery` is thus
+/// always a better match.
+struct FallbackQuery {
+  constexpr FallbackQuery(ReportQuery) noexcept {}  // NOLINT
+};
+
+/// integral types formatted with `std::to_chars`
+template <typename T>
+concept Integer =
+    std::is_integral_v<T> && (sizeof(T) <= sizeof(uint64_t)) &&
+    !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+    !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> &&
+    !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>;
+
+/// makes a report from the characters `[first, last)` of `buffer`. the size
+/// is clamped to the size of `buffer`, which also tells the compiler how much
+/// of it is copied.
+template <size_t N>
+inline Report make(char const (&buffer)[N], char const* first,
+                   char const* last) noexcept {
+  (void)buffer;
+  auto size = static_cast<size_t>(last - first);
+  return Report(std::string_view(first, size < N ? size : N));
+}
+
+template <Integer T>
+inline Report format_integer(T value) noexcept {
+  // sign and 20 digits of a 64-bit integer
+  char buffer[24];
+  std::to_chars_result result =
+      std::to_chars(buffer, buffer + sizeof(buffer), value);
+  return make(buffer, buffer, result.ptr);
+}
+
+#if defined(__SIZEOF_INT128__)
+// `__extension__` silences `-Wpedantic` for the non-standard 128-bit types
+__extension__ typedef __int128 int128;
+__extension__ typedef unsigned __int128 uint128;
+
+/// formats `value` backwards from `last`, as `std::to_chars` is not required
+/// to support 128-bit integers. returns the start of the formatted digits.
+inline char* format_uint128(uint128 value, char* last) noexcept {
+  constexpr uint64_t kChunk = 10'000'000'000'000'000'000ULL;  // 10^19
+  while (value > UINT64_MAX) {
+    auto chunk = static_cast<uint64_t>(value % kChunk);
+    value /= kChunk;
+    for (int i = 0; i < 19; i++) {
+      *--last = static_cast<char>('0' + chunk % 10);
+      chunk /= 10;
+    }
+  }
+  auto head = static_cast<uint64_t>(value);
+  do {
+    *--last = static_cast<char>('0' + head % 10);
+    head /= 10;
+  } while (head != 0);
+  return last;
+}
+#endif
+
+/// extracts the name of the enumerator `Value` from the compiler's pretty
+/// function signature, returns an empty string if `Value` is not a named
+/// enumerator.
+template <auto Value>
+constexpr std::string_view enum_value_name() noexcept {
+#if CFG(COMPILER, GNUC) || CFG(COMPILER, CLANG)
+  // GCC: "... [with auto Value = ns::Color::Red; ...]"
+  // Clang: "... [Value = ns::Color::Red]"
+  std::string_view signature = __PRETTY_FUNCTION__;
+  constexpr std::string_view kPrefix = "Value = ";
+  size_t begin = signature.find(kPrefix);
+  if (begin == std::string_view::npos) return {};
+  begin += kPrefix.size();
+  size_t end = signature.find_first_of(";]", begin);
+  std::string_view name = signature.substr(begin, end - begin);
+
+  // unnamed values are printed as a cast or an integer, i.e. `(Color)5`
+  if (name.empty() || name[0] == '(' || name[0] == '-' ||
+      (name[0] >= '0' && name[0] <= '9'))
+    return {};
+
+  size_t scope = name.rfind("::");
+  if (scope != std::string_view::npos) name.remove_prefix(scope + 2);
+  return name;
+#else
+  return {};
+#endif
+}
+
+template <typename E>
+struct EnumNameRange {
+  using underlying = std::underlying_type_t<E>;
+  static constexpr int64_t kMin =
+      std::is_signed_v<underlying>
+          ? (static_cast<int64_t>(std::numeric_limits<underlying>::min()) >
+                     kReportEnumMin
+                 ? static_cast<int64_t>(
+                       std::numeric_limits<underlying>::min())
+                 : kReportEnumMin)
+          : 0;
+  static constexpr int64_t kMax =
+      static_cast<uint64_t>(std::numeric_limits<underlying>::max()) <
+              static_cast<uint64_t>(kReportEnumMax)
+          ? static_cast<int64_t>(std::numeric_limits<underlying>::max())
+          : kReportEnumMax;
+};
+
+template <typename E, size_t... Indices>
+constexpr auto enum_names(std::index_sequence<Indices...>) noexcept {
+  using underlying = std::underlying_type_t<E>;
+  // `bit_cast` as a `static_cast` to a value outside the range of an enum
+  // without a fixed underlying type is not a constant expression
+  return std::array<std::string_view, sizeof...(Indices)>{
+      enum_value_name<std::bit_cast<E>(static_cast<underlying>(
+          EnumNameRange<E>::kMin + static_cast<int64_t>(Indices)))>()...};
+}
+
+template <typename E>
+inline constexpr auto kEnumNames = enum_names<E>(std::make_index_sequence<
+    static_cast<size_t>(EnumNameRange<E>::kMax - EnumNameRange<E>::kMin + 1)>{});
+
+/// the name of the enumerator with value `value`, or an empty string if it is
+/// not a named enumerator or is outside of `[STX_REPORT_ENUM_MIN,
+/// STX_REPORT_ENUM_MAX]`
+template <typename E>
+constexpr std::string_view enum_name(E value) noexcept {
+  using underlying = std::underlying_type_t<E>;
+  auto integer = static_cast<underlying>(value);
+  if constexpr (std::is_signed_v<underlying>) {
+    if (integer < EnumNameRange<E>::kMin || integer > EnumNameRange<E>::kMax)
+      return {};
+  } else {
+    if (static_cast<uint64_t>(integer) >
+        static_cast<uint64_t>(EnumNameRange<E>::kMax))
+      return {};
+  }
+  return kEnumNames<E>[static_cast<size_t>(static_cast<int64_t>(integer) -
+                                           EnumNameRange<E>::kMin)];
+}
+
+}  // namespace report
+
+};  // namespace internal
+
+/// A sink that reports are streamed into, piece by piece. Reporting into a
+/// `ReportWriter` is not limited by `kMaxReportSize` and uses constant stack
+/// space regardless of the size of the report, as the sink decides where the
+/// characters go.
+///
+/// Types can be reported into a writer by overloading `operator<<`:
+///
+/// ``` cpp
+/// ReportWriter& operator<<(ReportWriter& writer, Manifest const& manifest) {
+///   writer << "missing files: ";
+///   for (std::string const& path : manifest.missing) writer << path << ", ";
+///   return writer;
+/// }
+/// ```
+///
+/// Such types are also `Reportable`, their `Report` then holds the first
+/// `kMaxReportSize` characters.
+class ReportWriter {
+ public:
+  /// appends `text` to the sink
+  virtual void write(std::string_view text) noexcept = 0;
+
+ protected:
+  constexpr ReportWriter() noexcept = default;
+  constexpr ReportWriter(ReportWriter const&) noexcept = default;
+  constexpr ReportWriter& operator=(ReportWriter const&) noexcept = default;
+  ~ReportWriter() noexcept = default;
+};
+
+/// A `ReportWriter` that writes into a fixed buffer, and drops the characters
+/// that do not fit.
+class SpanReportWriter final : public ReportWriter {
+ public:
+  explicit constexpr SpanReportWriter(std::span<char> buffer) noexcept
+      : buffer_{buffer}, size_{0}, truncated_{false} {}
+
+  void write(std::string_view text) noexcept override {
+    size_t available = buffer_.size() - size_;
+    size_t size = text.size();
+    if (size > available) {
+      size = available;
+      truncated_ = true;
+    }
+    std::memcpy(buffer_.data() + size_, text.data(), size);
+    size_ += size;
+  }
+
+  /// number of characters written
+  [[nodiscard]] constexpr size_t size() const noexcept { return size_; }
+
+  /// the characters written
+  [[nodiscard]] constexpr std::string_view view() const noexcept {
+    return std::string_view(buffer_.data(), size_);
+  }
+
+  /// whether any characters were dropped
+  [[nodiscard]] constexpr bool truncated() const noexcept {
+    return truncated_;
+  }
+
+ private:
+  std::span<char> buffer_;
+  size_t size_;
+  bool truncated_;
+};
+
+/// A `ReportWriter` that builds a `Report`. As with `Report(std::string_view)`,
+/// a report longer than `kMaxReportSize` ends with `kReportTruncationMessage`.
+class ReportBuilder final : public ReportWriter {
+ public:
+  constexpr ReportBuilder() noexcept : report_{}, truncated_{false} {}
+
+  void write(std::string_view text) noexcept override {
+    if (truncated_) return;
+
+    constexpr size_t kLimit =
+        kMaxReportSize - kReportTruncationMessage.size();
+    size_t& used = report_.used_size_;
+
+    if (text.size() <= kMaxReportSize - used) {
+      std::memcpy(report_.report_.data() + used, text.data(), text.size());
+      used += text.size();
+      return;
+    }
+
+    // keep as much of the report as fits before the truncation message
+    if (used < kLimit) {
+      std::memcpy(report_.report_.data() + used, text.data(), kLimit - used);
+    }
+    used = kLimit;
+    std::memcpy(report_.report_.data() + used,
+                kReportTruncationMessage.data(),
+                kReportTruncationMessage.size());
+    used = kMaxReportSize;
+    truncated_ = true;
+  }
+
+  [[nodiscard]] Report build() && noexcept { return std::move(report_); }
+
+ private:
+  Report report_;
+  bool truncated_;
+};
+
+inline ReportWriter& operator<<(ReportWriter& writer,
+                                std::string_view text) noexcept {
+  writer.write(text);
+  return writer;
+}
+
+inline ReportWriter& operator<<(ReportWriter& writer,
+                                exact<char> auto const& c) noexcept {
+  writer.write(std::string_view(&c, 1));
+  return writer;
+}
+
+inline ReportWriter& operator<<(ReportWriter& writer,
+                                exact<bool> auto const& v) noexcept {
+  writer.write(v ? std::string_view("true") : std::string_view("false"));
+  return writer;
+}
+
+template <internal::report::Integer T>
+inline ReportWriter& operator<<(ReportWriter& writer, T const& v) noexcept {
+  char buffer[24];
+  std::to_chars_result result =
+      std::to_chars(buffer, buffer + sizeof(buffer), v);
+  writer.write(
+      std::string_view(buffer, static_cast<size_t>(result.ptr - buffer)));
+  return writer;
+}
+
+template <std::floating_point T>
+inline ReportWriter& operator<<(ReportWriter& writer, T const& v) noexcept {
+  char buffer[64];
+  std::to_chars_result result =
+      std::to_chars(buffer, buffer + sizeof(buffer), v);
+  writer.write(
+      std::string_view(buffer, static_cast<size_t>(result.ptr - buffer)));
+  return writer;
+}
+
+/// types that can be streamed into a `ReportWriter`
+template <typename T>
+concept ReportWritable = requires(ReportWriter& writer, T const& v) {
+  writer << v;
+};
+
+/// streams `value` into `writer`, with its `operator<<` overload if it has one,
+/// else with its `Report`.
+template <typename T>
+requires ReportWritable<T> || Reportable<T> void write_report(
+    ReportWriter& writer, T const& value) noexcept {
+  if constexpr (ReportWritable<T>) {
+    writer << value;
+  } else {
+    writer.write((ReportQuery{} >> value).what());
+  }
+}
+
 /// `ReportPayload` holds a reference to the report's data and is used accross
 /// ABI-boundaries as `Report` can vary accross configurations.
 /// `ReportPayload` is essentially a type-erased view of `Report` (as in
 /// `std::span`).
 ///
+/// A payload is either eager, referring to already formatted content, or
+/// deferred, referring to the reported value and a formatter for it. A deferred
+/// payload is only formatted when the handler asks for it, streamed directly
+/// into the handler's `ReportWriter`, so the code that panics does not need to
+/// build a `Report` on its stack, and the report is not limited by
+/// `kMaxReportSize`. The referred-to value must outlive the payload, which is
+/// the case for the payload passed to `panic_handler`, as panicking does not
+/// return.
+///
 /// `ReportPayload` is the type of the second argument to
 /// `panic_handler`.
 class [[nodiscard]] ReportPayload {
  public:
+  /// writes the report of the value at `value` into `writer`
+  using Formatter = void (*)(void const* value, ReportWriter& writer) noexcept;
+
+  /// an empty payload
+  [[nodiscard]] constexpr ReportPayload() noexcept
+      : content_{}, value_{nullptr}, formatter_{nullptr} {}
+
   [[nodiscard]] explicit constexpr ReportPayload(Report const& report) noexcept
-      : content_{report.what()} {}
+      : content_{report.what()}, value_{nullptr}, formatter_{nullptr} {}
+
+  /// a deferred payload, `formatter` is called with `value` when the payload
+  /// is written.
+  [[nodiscard]] constexpr ReportPayload(void const* value,
+                                        Formatter formatter) noexcept
+      : content_{}, value_{value}, formatter_{formatter} {}
 
   [[nodiscard]] constexpr ReportPayload(ReportPayload const&) noexcept =
       default;
@@ -105,89 +484,136 @@ class [[nodiscard]] ReportPayload {
   constexpr ReportPayload& operator=(ReportPayload&&) noexcept = default;
   constexpr ~ReportPayload() noexcept = default;
 
-  [[nodiscard]] constexpr std::string_view const& data() const noexcept {
-    return content_;
+  /// a deferred payload that reports `value` with `write_report`
+  template <typename T>
+  requires ReportWritable<T> || Reportable<T>
+  [[nodiscard]] static constexpr ReportPayload deferred(
+      T const& value) noexcept {
+    return ReportPayload(static_cast<void const*>(&value), format<T>);
   }
 
- private:
-  std::string_view content_;
-};
-
-template <typename T>
-concept Reportable = requires(ReportQuery const query, T const& v) {
-  { query >> v }
-  ->same_as<Report>;
-};
+  [[nodiscard]] constexpr bool is_deferred() const noexcept {
+    return formatter_ != nullptr;
+  }
 
-namespace internal {
-namespace report {
-// this allows tolerance for platforms without snprintf.
-constexpr inline void write_unknown(char* buffer) noexcept {
-  buffer[0] = '<';
-  buffer[1] = '?';
-  buffer[2] = '>';
-  buffer[3] = '\0';
-}
+  /// streams the report into `writer`. A deferred payload is written
+  /// incrementally, so it is not limited by `kMaxReportSize`.
+  void write_to(ReportWriter& writer) const noexcept {
+    if (formatter_ != nullptr) {
+      formatter_(value_, writer);
+    } else {
+      writer.write(content_);
+    }
+  }
 
-constexpr auto query = ReportQuery{};
-}  // namespace report
+  /// writes the report into `buffer`, returns the number of characters
+  /// written. The report is truncated to the size of `buffer`.
+  size_t write(std::span<char> buffer) const noexcept {
+    SpanReportWriter writer{buffer};
+    write_to(writer);
+    return writer.size();
+  }
 
-};  // namespace internal
+  /// returns the report. A deferred payload is formatted into a thread-local
+  /// buffer, which is valid until the next call to `data()` on the same
+  /// thread.
+  [[nodiscard]] std::string_view data() const noexcept {
+    if (formatter_ == nullptr) return content_;
+    thread_local std::array<char, kMaxReportSize> buffer;
+    return std::string_view(buffer.data(), write(buffer));
+  }
 
-// consider integral concept
+ private:
+  template <typename T>
+  static void format(void const* value, ReportWriter& writer) noexcept {
+    write_report(writer, *static_cast<T const*>(value));
+  }
 
-[[nodiscard]] inline Report operator>>(ReportQuery,
-                                       exact<int8_t> auto const& v) noexcept {
-  char buffer[5];
-  auto written = std::snprintf(buffer, sizeof(buffer), "%" PRIi8, v);
-  if (written == 0) internal::report::write_unknown(buffer);
+  std::string_view content_;
+  void const* value_;
+  Formatter formatter_;
+};
 
-  return Report(buffer);
+/// integers are formatted in decimal.
+template <internal::report::Integer T>
+[[nodiscard]] inline Report operator>>(ReportQuery, T const& v) noexcept {
+  return internal::report::format_integer(v);
 }
 
-[[nodiscard]] inline Report operator>>(ReportQuery,
-                                       exact<uint8_t> auto const& v) noexcept {
-  char buffer[4];
-  auto written = std::snprintf(buffer, sizeof(buffer), "%" PRIu8, v);
-  if (written == 0) internal::report::write_unknown(buffer);
+#if defined(__SIZEOF_INT128__)
 
-  return Report(buffer);
+[[nodiscard]] inline Report operator>>(
+    ReportQuery, exact<internal::report::uint128> auto const& v) noexcept {
+  char buffer[40];
+  char* const last = buffer + sizeof(buffer);
+  return internal::report::make(
+      buffer, internal::report::format_uint128(v, last), last);
 }
 
-[[nodiscard]] inline Report operator>>(ReportQuery,
-                                       exact<int16_t> auto const& v) noexcept {
-  char buffer[7];
-  auto written = std::snprintf(buffer, sizeof(buffer), "%" PRId16, v);
-  if (written == 0) internal::report::write_unknown(buffer);
-
-  return Report(buffer);
+[[nodiscard]] inline Report operator>>(
+    ReportQuery, exact<internal::report::int128> auto const& v) noexcept {
+  char buffer[41];
+  char* const last = buffer + sizeof(buffer);
+  auto magnitude = static_cast<internal::report::uint128>(v);
+  if (v < 0) magnitude = 0 - magnitude;
+  char* first = internal::report::format_uint128(magnitude, last);
+  if (v < 0) *--first = '-';
+  return internal::report::make(buffer, first, last);
 }
 
-[[nodiscard]] inline Report operator>>(ReportQuery,
-                                       exact<uint16_t> auto const& v) noexcept {
-  char buffer[7];
-  auto written = std::snprintf(buffer, sizeof(buffer), "%" PRIu16, v);
-  if (written == 0) internal::report::write_unknown(buffer);
+#endif
 
-  return Report(buffer);
+/// floating-point numbers are formatted in the shortest form that round-trips
+/// to the same value, i.e. `0.1`, `1e+100`, `inf`, `nan`.
+template <std::floating_point T>
+[[nodiscard]] inline Report operator>>(ReportQuery, T const& v) noexcept {
+  // shortest round-trip form of a `long double` is at most 48 characters
+  char buffer[64];
+  std::to_chars_result result =
+      std::to_chars(buffer, buffer + sizeof(buffer), v);
+  return internal::report::make(buffer, buffer, result.ptr);
 }
 
 [[nodiscard]] inline Report operator>>(ReportQuery,
-                                       exact<int32_t> auto const& v) noexcept {
-  char buffer[12];
-  auto written = std::snprintf(buffer, sizeof(buffer), "%" PRId32, v);
-  if (written == 0) internal::report::write_unknown(buffer);
+                                       exact<bool> auto const& v) noexcept {
+  return v ? Report("true") : Report("false");
+}
 
-  return Report(buffer);
+[[nodiscard]] inline Report operator>>(
+    ReportQuery, exact<std::nullptr_t> auto const&) noexcept {
+  return Report("nullptr");
 }
 
-[[nodiscard]] inline Report operator>>(ReportQuery,
-                                       exact<uint32_t> auto const& v) noexcept {
-  char buffer[11];
-  auto written = std::snprintf(buffer, sizeof(buffer), "%" PRIu32, v);
-  if (written == 0) internal::report::write_unknown(buffer);
+/// pointers are formatted as hexadecimal addresses, i.e. `0x7ffd5e8c`.
+/// character pointers are not treated as strings.
+template <typename T>
+[[nodiscard]] inline Report operator>>(internal::report::FallbackQuery,
+                                       T* const& v) noexcept {
+  char buffer[2 + 16];
+  buffer[0] = '0';
+  buffer[1] = 'x';
+  std::to_chars_result result =
+      std::to_chars(buffer + 2, buffer + sizeof(buffer),
+                    reinterpret_cast<uintptr_t>(v), 16);
+  return internal::report::make(buffer, buffer, result.ptr);
+}
 
-  return Report(buffer);
+/// enums are formatted as the name of the enumerator, or the underlying
+/// integer if the value has no name. The names are looked up at compile-time
+/// for values in the range `[STX_REPORT_ENUM_MIN, STX_REPORT_ENUM_MAX]`
+/// (default: `[-128, 127]`).
+template <typename T>
+requires std::is_enum_v<T> [[nodiscard]] inline Report operator>>(
+    internal::report::FallbackQuery, T const& v) noexcept {
+  std::string_view name = internal::report::enum_name(v);
+  if (!name.empty()) return Report(name);
+
+  using underlying = std::underlying_type_t<T>;
+  if constexpr (std::is_signed_v<underlying>) {
+    return internal::report::format_integer(static_cast<int64_t>(v));
+  } else {
+    return internal::report::format_integer(static_cast<uint64_t>(v));
+  }
 }
 
 [[nodiscard]] inline Report operator>>(
@@ -200,4 +626,20 @@ constexpr auto query = ReportQuery{};
   return Report(v);
 }
 
+/// a `Report` reports itself, i.e. for `Result<T, Report>`
+[[nodiscard]] inline Report operator>>(ReportQuery,
+                                       Report const& report) noexcept {
+  return report;
+}
+
+/// types that are only reported by streaming into a `ReportWriter` are
+/// reported with their first `kMaxReportSize` characters.
+template <typename T>
+requires std::is_class_v<T> && ReportWritable<T> [[nodiscard]] inline Report
+operator>>(internal::report::FallbackQuery, T const& v) noexcept {
+  ReportBuilder builder;
+  builder << v;
+  return std::move(builder).build();
+}
+
 };  // namespace stx
\ No newline at end of file
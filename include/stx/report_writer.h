@@ -0,0 +1,102 @@
+/**
+ * @file report_writer.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-11
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "stx/report.h"
+
+//! ### Report sinks
+//!
+//! `ReportWriter` implementations for reports that do not fit in a `Report`:
+//!
+//! - `SpanReportWriter` (in `stx/report.h`) writes into a fixed buffer.
+//! - `ReportBuilder` (in `stx/report.h`) builds a `Report`.
+//! - `FdReportWriter` writes to a file descriptor.
+//! - `ArenaReportWriter` writes into a growable heap buffer.
+//!
+//! ``` cpp
+//! FdReportWriter writer{2};
+//! write_report(writer, manifest);
+//! ```
+
+namespace stx {
+
+#if CFG(OS, POSIX)
+
+/// A `ReportWriter` that writes to a file descriptor with `write(2)`. Writes
+/// are buffered in the writer and flushed when the buffer is full, on `flush()`
+/// and on destruction. Write errors other than interruptions are ignored, as
+/// there is no one to report them to.
+class FdReportWriter final : public ReportWriter {
+ public:
+  static constexpr size_t kBufferSize = 256;
+
+  explicit constexpr FdReportWriter(int fd) noexcept
+      : fd_{fd}, buffer_{}, size_{0} {}
+
+  FdReportWriter(FdReportWriter const&) = delete;
+  FdReportWriter& operator=(FdReportWriter const&) = delete;
+
+  ~FdReportWriter() noexcept { flush(); }
+
+  void write(std::string_view text) noexcept override;
+
+  /// writes the buffered characters to the file descriptor
+  void flush() noexcept;
+
+ private:
+  int fd_;
+  char buffer_[kBufferSize];
+  size_t size_;
+};
+
+#endif
+
+/// A `ReportWriter` that writes into a heap buffer that grows as needed. If the
+/// buffer can not be grown, the characters that do not fit are dropped and
+/// `truncated()` is set, so writing never throws.
+class ArenaReportWriter final : public ReportWriter {
+ public:
+  constexpr ArenaReportWriter() noexcept
+      : data_{nullptr}, size_{0}, capacity_{0}, truncated_{false} {}
+
+  ArenaReportWriter(ArenaReportWriter const&) = delete;
+  ArenaReportWriter& operator=(ArenaReportWriter const&) = delete;
+
+  ~ArenaReportWriter() noexcept;
+
+  void write(std::string_view text) noexcept override;
+
+  /// the characters written, valid until the next write
+  [[nodiscard]] std::string_view view() const noexcept {
+    return std::string_view(data_, size_);
+  }
+
+  /// whether any characters were dropped for lack of memory
+  [[nodiscard]] bool truncated() const noexcept { return truncated_; }
+
+  /// empties the buffer, keeping its memory for reuse
+  void clear() noexcept {
+    size_ = 0;
+    truncated_ = false;
+  }
+
+ private:
+  char* data_;
+  size_t size_;
+  size_t capacity_;
+  bool truncated_;
+};
+
+};  // namespace stx
@@ -11,6 +11,411 @@
 
 #pragma once
 
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+#include "stx/enum.h"
 #include "stx/internal/option_result.h"
 
-namespace stx {};  // namespace stx
+namespace stx {
+
+//! ### Results with several error types
+//!
+//! `Result<T, E1, E2, ...>` is a `Result` whose error is one of several
+//! distinct error types. Unlike nesting results (i.e.
+//! `Result<Result<T, ParseError>, IoError>`), the value and all of the errors
+//! share a single union and a single tag, so checking for success is one
+//! branch no matter how many error types there are.
+//!
+//! A `Result<T, Es...>` implicitly converts to a `Result<T, Fs...>` whose
+//! error types are a superset of `Es...`, so `TRY_OK` and `and_then` widen the
+//! error set at compile-time as errors propagate up the call chain:
+//!
+//! ``` cpp
+//! enum class IoError { Eof };
+//! enum class ParseError { BadDigit };
+//!
+//! auto read = []() -> Result<string, IoError> { return Ok("42"s); };
+//! auto parse = [](string s) -> Result<int, ParseError> {
+//!   if (s.empty()) return Err(ParseError::BadDigit);
+//!   return Ok(stoi(s));
+//! };
+//!
+//! auto read_int = [&]() -> Result<int, IoError, ParseError> {
+//!   TRY_OK(text, read());
+//!   TRY_OK(value, parse(move(text)));
+//!   return Ok(move(value));
+//! };
+//!
+//! ASSERT_EQ(read_int(), Ok(42));
+//! ASSERT_EQ(read().and_then(parse), Ok(42));
+//! ```
+//!
+//! The error types must be distinct and nothrow move-constructible, and
+//! `error_type` is the `Enum<E1, E2, ...>` of all of them.
+//!
+template <Swappable T, Swappable E, Swappable... Es>
+class [[nodiscard]] Result {
+  static_assert(!std::is_reference_v<T>,
+                "Cannot use T& nor T&& for type, To prevent subtleties use "
+                "type wrappers like std::reference_wrapper or any of the "
+                "`stx::ConstRef` or `stx::MutRef` specialized aliases instead");
+
+  static_assert((internal::enum_::count_of<E, E, Es...> == 1) &&
+                    ((internal::enum_::count_of<Es, E, Es...> == 1) && ...),
+                "the error types of a Result must be distinct");
+
+  using storage_type = Enum<T, E, Es...>;
+
+  template <typename F>
+  static constexpr bool kIsErr = internal::enum_::count_of<F, E, Es...> == 1;
+
+  // index of the error type `F` in `storage_type`
+  template <typename F>
+  static constexpr size_t kErrIndex =
+      1 + internal::enum_::IndexOf<F, E, Es...>::value;
+
+  static constexpr size_t kErrors = 1 + sizeof...(Es);
+
+ public:
+  using value_type = T;
+  using error_type = Enum<E, Es...>;
+
+  [[nodiscard]] constexpr Result(Ok<T>&& result)
+      : alternatives_(std::in_place_index<0>, std::move(result.value_)) {}
+
+  template <typename F>
+  requires kIsErr<F>  //
+      [[nodiscard]] constexpr Result(Err<F>&& err)
+      : alternatives_(std::in_place_index<kErrIndex<F>>,
+                      std::move(err.value_)) {}
+
+  /// widens an error, i.e. from `TRY_OK` on a result with a subset of the
+  /// error types.
+  template <typename... Fs>
+  requires(kIsErr<Fs>&&...)  //
+      [[nodiscard]] constexpr Result(Err<Enum<Fs...>>&& err)
+      : alternatives_(widen_(std::move(err.value_))) {}
+
+  /// widens a result with a subset of the error types.
+  template <typename F, typename... Fs>
+  requires(kIsErr<F> && ... && kIsErr<Fs>)  //
+      [[nodiscard]] constexpr Result(Result<T, F, Fs...>&& result)
+      : alternatives_(widen_(std::move(result))) {}
+
+  [[nodiscard]] constexpr Result(Result&&) = default;
+  constexpr Result& operator=(Result&&) = default;
+
+  Result() = delete;
+  Result(Result const&) = delete;
+  Result& operator=(Result const&) = delete;
+
+  constexpr ~Result() = default;
+
+  [[nodiscard]] constexpr bool operator==(Ok<T> const& cmp) const
+      requires equality_comparable<T> {
+    return is_ok() && value_cref_() == cmp.value();
+  }
+
+  template <typename F>
+  requires kIsErr<F>&& equality_comparable<F>  //
+      [[nodiscard]] constexpr bool
+      operator==(Err<F> const& cmp) const {
+    return alternatives_.index() == kErrIndex<F> &&
+           internal::enum_::get<kErrIndex<F>>(alternatives_.storage_) ==
+               cmp.value();
+  }
+
+  [[nodiscard]] constexpr bool operator==(Result const& cmp) const
+      requires equality_comparable<T> &&
+      (equality_comparable<E> && ... && equality_comparable<Es>) {
+    return alternatives_ == cmp.alternatives_;
+  }
+
+  /// Returns `true` if the result is an `Ok<T>` variant.
+  [[nodiscard]] constexpr bool is_ok() const noexcept {
+    return alternatives_.index() == 0;
+  }
+
+  /// Returns `true` if the result is an `Err` variant, of any of the error
+  /// types.
+  [[nodiscard]] constexpr bool is_err() const noexcept { return !is_ok(); }
+
+  /// Returns `true` if the result is an `Err<F>` variant.
+  ///
+  /// # Examples
+  ///
+  /// Basic usage:
+  ///
+  /// ``` cpp
+  /// Result<int, IoError, ParseError> x = Err(ParseError::BadDigit);
+  /// ASSERT_TRUE(x.is_err<ParseError>());
+  /// ASSERT_FALSE(x.is_err<IoError>());
+  /// ```
+  template <typename F>
+  requires kIsErr<F>  //
+      [[nodiscard]] constexpr bool is_err() const noexcept {
+    return alternatives_.index() == kErrIndex<F>;
+  }
+
+  /// Converts from `Result<T, Es...>` to `Option<T>`, discarding the error,
+  /// if any.
+  [[nodiscard]] constexpr auto ok() && -> Option<T> {
+    if (is_ok()) {
+      return Some<T>(std::move(value_ref_()));
+    } else {
+      return None;
+    }
+  }
+
+  /// Converts from `Result<T, Es...>` to `Option<Enum<Es...>>`, discarding
+  /// the success value, if any.
+  [[nodiscard]] constexpr auto err() && -> Option<error_type> {
+    if (is_ok()) {
+      return None;
+    } else {
+      return Some<error_type>(std::move(*this).take_err_());
+    }
+  }
+
+  /// Maps a `Result<T, Es...>` to `Result<U, Es...>` by applying the function
+  /// `op` to the contained `Ok<T>` value, leaving the error untouched.
+  template <typename Fn>
+  requires invocable<Fn&&, T&&>  //
+      [[nodiscard]] constexpr auto map(
+          Fn&& op) && -> Result<invoke_result<Fn&&, T&&>, E, Es...> {
+    using output = Result<invoke_result<Fn&&, T&&>, E, Es...>;
+    if (is_ok()) {
+      return Ok<invoke_result<Fn&&, T&&>>(
+          std::forward<Fn&&>(op)(std::move(value_ref_())));
+    } else {
+      return std::move(*this).template err_into_<output>();
+    }
+  }
+
+  /// Calls `op` if the result is `Ok`, otherwise returns the error of itself.
+  ///
+  /// If `op` returns a `Result<U, Fs...>`, the error types are merged
+  /// into a flat `Result<U, E, Es..., Fs...>` (without duplicates).
+  ///
+  /// # Examples
+  ///
+  /// Basic usage:
+  ///
+  /// ``` cpp
+  /// Result<string, IoError> text = Ok("42"s);
+  /// Result<int, IoError, ParseError> value = move(text).and_then(parse);
+  /// ```
+  template <typename Fn>
+  requires invocable<Fn&&, T&&>  //
+      [[nodiscard]] constexpr auto and_then(Fn&& op) && -> internal::result::
+          and_then_result<invoke_result<Fn&&, T&&>, E, Es...> {
+    using fn_output = invoke_result<Fn&&, T&&>;
+    using output =
+        internal::result::and_then_result<invoke_result<Fn&&, T&&>, E, Es...>;
+    if (is_ok()) {
+      if constexpr (internal::result::IsResult<fn_output>::value) {
+        return std::forward<Fn&&>(op)(std::move(value_ref_()));
+      } else {
+        return Ok<fn_output>(std::forward<Fn&&>(op)(std::move(value_ref_())));
+      }
+    } else {
+      return std::move(*this).template err_into_<output>();
+    }
+  }
+
+  /// Unwraps a result, yielding the content of an `Ok`, else returns `alt`.
+  [[nodiscard]] constexpr auto unwrap_or(T&& alt) && -> T {
+    if (is_ok()) {
+      return std::move(value_ref_());
+    } else {
+      return std::forward<T&&>(alt);
+    }
+  }
+
+  /// Unwraps a result, yielding the content of an `Ok<T>` variant.
+  ///
+  /// # Panics
+  ///
+  /// Panics if the value is an `Err`, with a panic message provided by the
+  /// `Err`'s value.
+  [[nodiscard]] auto unwrap() && -> T {
+    if (is_err()) {
+      visit_err_([](auto const& err) { internal::result::no_value(err); });
+    }
+    return std::move(value_ref_());
+  }
+
+  /// Unwraps a result, yielding the content of an `Ok`.
+  ///
+  /// # Panics
+  ///
+  /// Panics if the value is an `Err`, with a panic message including the
+  /// passed message, and the content of the `Err`.
+  [[nodiscard]] auto expect(std::string_view msg) && -> T {
+    if (is_err()) {
+      visit_err_([&msg](auto const& err) {
+        internal::result::expect_value_failed(std::move(msg), err);
+      });
+    }
+    return std::move(value_ref_());
+  }
+
+  /// Unwraps a result, yielding the content of an `Ok`.
+  ///
+  /// # Panics
+  ///
+  /// Panics if the value is an `Err`, with a panic message formatted from
+  /// `format` and `args`, and the content of the `Err`. The arguments are
+  /// only formatted if the result is an `Err`.
+  template <typename... Args>
+  [[nodiscard]] auto expect_fmt(
+      FormatString<std::type_identity_t<Args>...> format,
+      Args const&... args) && -> T {
+    if (is_err()) {
+      FormatArgs<Args...> const message{format.str, args...};
+      visit_err_([&](auto const& err) {
+        internal::result::expect_value_failed_fmt(message, err,
+                                                  std::move(format.location));
+      });
+    }
+    return std::move(value_ref_());
+  }
+
+  /// Unwraps a result, yielding the error, as an `Enum` of the error types.
+  ///
+  /// # Panics
+  ///
+  /// Panics if the value is an `Ok`, with a custom panic message provided
+  /// by the `Ok`'s value.
+  [[nodiscard]] auto unwrap_err() && -> error_type {
+    if (is_ok()) {
+      internal::result::no_err(value_cref_());
+    }
+    return std::move(*this).take_err_();
+  }
+
+  /// Calls `ok_fn` with the value if the result is `Ok`, otherwise calls the
+  /// `err_fns` function matching the error's type. One function must be
+  /// provided for each error type.
+  ///
+  /// # Examples
+  ///
+  /// Basic usage:
+  ///
+  /// ``` cpp
+  /// Result<int, IoError, ParseError> x = Err(IoError::Eof);
+  /// auto message = move(x).match([](int) { return "ok"sv; },
+  ///                              [](IoError) { return "io error"sv; },
+  ///                              [](ParseError) { return "parse error"sv; });
+  /// ASSERT_EQ(message, "io error"sv);
+  /// ```
+  template <typename OkFn, typename... ErrFns>
+  [[nodiscard]] constexpr auto match(OkFn&& ok_fn, ErrFns&&... err_fns) && {
+    static_assert(sizeof...(ErrFns) == kErrors,
+                  "Result::match must be given one function per error type");
+    return std::move(alternatives_)
+        .match(std::forward<OkFn>(ok_fn), std::forward<ErrFns>(err_fns)...);
+  }
+
+  [[nodiscard]] constexpr auto clone() const -> Result
+      requires copy_constructible<T> &&
+      (copy_constructible<E> && ... && copy_constructible<Es>) {
+    return Result(alternatives_.clone());
+  }
+
+ private:
+  storage_type alternatives_;
+
+  [[nodiscard]] constexpr explicit Result(storage_type&& alternatives)
+      : alternatives_(std::move(alternatives)) {}
+
+  [[nodiscard]] constexpr T& value_ref_() noexcept {
+    return internal::enum_::get<0>(alternatives_.storage_);
+  }
+
+  [[nodiscard]] constexpr T const& value_cref_() const noexcept {
+    return internal::enum_::get<0>(alternatives_.storage_);
+  }
+
+  // calls `fn` with the contained error. requires that the result is an `Err`.
+  template <typename Fn>
+  constexpr void visit_err_(Fn&& fn) const {
+    internal::enum_::dispatch<kErrors, void>(
+        alternatives_.index() - 1, [&](auto i) {
+          constexpr size_t I = decltype(i)::value;
+          fn(internal::enum_::get<I + 1>(alternatives_.storage_));
+        });
+  }
+
+  // requires that the result is an `Err`.
+  constexpr auto take_err_() && -> error_type {
+    return internal::enum_::dispatch<kErrors, error_type>(
+        alternatives_.index() - 1, [&](auto i) -> error_type {
+          constexpr size_t I = decltype(i)::value;
+          return error_type(
+              std::in_place_index<I>,
+              std::move(internal::enum_::get<I + 1>(alternatives_.storage_)));
+        });
+  }
+
+  // moves the contained error into a `Target` result with a superset of the
+  // error types. requires that the result is an `Err`.
+  template <typename Target>
+  constexpr auto err_into_() && -> Target {
+    return internal::enum_::dispatch<kErrors, Target>(
+        alternatives_.index() - 1, [&](auto i) -> Target {
+          constexpr size_t I = decltype(i)::value;
+          using F = internal::enum_::TypeAt<I, E, Es...>;
+          return Err<F>(
+              std::move(internal::enum_::get<I + 1>(alternatives_.storage_)));
+        });
+  }
+
+  template <typename... Fs>
+  static constexpr auto widen_(Enum<Fs...>&& err) noexcept -> storage_type {
+    return internal::enum_::dispatch<sizeof...(Fs), storage_type>(
+        err.index(), [&](auto i) -> storage_type {
+          constexpr size_t I = decltype(i)::value;
+          using F = internal::enum_::TypeAt<I, Fs...>;
+          return storage_type(std::in_place_index<kErrIndex<F>>,
+                              std::move(internal::enum_::get<I>(err.storage_)));
+        });
+  }
+
+  template <typename F>
+  static constexpr auto widen_(Result<T, F>&& result) noexcept
+      -> storage_type {
+    if (result.is_ok()) {
+      return storage_type(std::in_place_index<0>,
+                          std::move(result.value_ref_()));
+    } else {
+      return storage_type(std::in_place_index<kErrIndex<F>>,
+                          std::move(result.err_ref_()));
+    }
+  }
+
+  template <typename F, typename F1, typename... Fs>
+  static constexpr auto widen_(Result<T, F, F1, Fs...>&& result) noexcept
+      -> storage_type {
+    return internal::enum_::dispatch<3 + sizeof...(Fs), storage_type>(
+        result.alternatives_.index(), [&](auto i) -> storage_type {
+          constexpr size_t I = decltype(i)::value;
+          auto& alternative =
+              internal::enum_::get<I>(result.alternatives_.storage_);
+          if constexpr (I == 0) {
+            return storage_type(std::in_place_index<0>, std::move(alternative));
+          } else {
+            using Fi = internal::enum_::TypeAt<I - 1, F, F1, Fs...>;
+            return storage_type(std::in_place_index<kErrIndex<Fi>>,
+                                std::move(alternative));
+          }
+        });
+  }
+
+  template <Swappable Tp, Swappable Er, Swappable... Ers>
+  friend class Result;
+};
+
+};  // namespace stx
@@ -0,0 +1,136 @@
+/**
+ * @file spawn.h
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-15
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "stx/option.h"
+#include "stx/panic/reserve.h"
+#include "stx/panic/unwind.h"
+#include "stx/result.h"
+
+//! ### Spawning threads
+//!
+//! `spawn` runs a function on a new thread within `catch_panic`, and returns a
+//! `JoinHandle` whose `join()` returns the function's result, or the panic the
+//! thread ended with. A worker's panic is then a value the spawning thread can
+//! handle, rather than the end of the program.
+//!
+//! ``` cpp
+//! auto handle = spawn([] { return parse_config(path).unwrap(); });
+//! std::move(handle).join().match(
+//!     [](Config config) { run(config); },
+//!     [](PanicInfo info) { log_failure(info.info(), info.report()); });
+//! ```
+//!
+//! The panic is carried from the panicking thread through its preallocated
+//! `PanicInfo` slot into storage allocated with the thread, so a panic does not
+//! allocate on its way to `join()`. This requires panics to unwind
+//! (`kPanicUnwind`), else a panic in a spawned thread aborts the program.
+//!
+//! A spawned thread installs its own alternate signal stack
+//! (`setup_panic_signal_stack`), so a stack overflow on it is reported by the
+//! backtrace signal handler.
+
+namespace stx {
+
+template <typename T>
+class JoinHandle;
+
+/// Runs `fn` on a new thread and returns a `JoinHandle` to wait for its result.
+/// If `fn` panics and panics can unwind (`kPanicUnwind`), the panic is
+/// returned by `join()`, else the panic aborts as usual. If `fn` returns
+/// `void`, the result is `Unit`.
+///
+/// # Examples
+///
+/// Basic usage:
+///
+/// ``` cpp
+/// auto handle = spawn([] { return 42; });
+/// ASSERT_EQ(std::move(handle).join(), Ok(42));
+/// ```
+template <typename Fn>
+requires invocable<std::decay_t<Fn>&> &&
+    std::move_constructible<std::decay_t<Fn>> [[nodiscard]] auto
+    spawn(Fn&& fn)
+        -> JoinHandle<internal::catch_result::value_type<std::decay_t<Fn>>>;
+
+/// A handle to a thread started by `spawn`. The thread is joined when the
+/// handle is destroyed if `join()` was not called.
+template <typename T>
+class [[nodiscard]] JoinHandle {
+ public:
+  using result_type = Result<T, PanicInfo>;
+
+  JoinHandle(JoinHandle&&) noexcept = default;
+  JoinHandle(JoinHandle const&) = delete;
+  JoinHandle& operator=(JoinHandle&&) = delete;
+  JoinHandle& operator=(JoinHandle const&) = delete;
+
+  ~JoinHandle() noexcept {
+    if (thread_.joinable()) thread_.join();
+  }
+
+  /// Waits for the thread to finish, and returns the result of its function,
+  /// or the panic it ended with.
+  [[nodiscard]] result_type join() && {
+    thread_.join();
+    return std::move(*slot_).unwrap();
+  }
+
+  [[nodiscard]] std::thread::id id() const noexcept {
+    return thread_.get_id();
+  }
+
+ private:
+  template <typename Fn>
+  requires invocable<std::decay_t<Fn>&> &&
+      std::move_constructible<std::decay_t<Fn>>
+  friend auto spawn(Fn&& fn)
+      -> JoinHandle<internal::catch_result::value_type<std::decay_t<Fn>>>;
+
+  explicit JoinHandle(std::unique_ptr<Option<result_type>> slot)
+      : slot_{std::move(slot)}, thread_{} {}
+
+  // written by the thread before it exits, allocated when the thread is
+  // spawned
+  std::unique_ptr<Option<result_type>> slot_;
+  std::thread thread_;
+};
+
+template <typename Fn>
+requires invocable<std::decay_t<Fn>&> &&
+    std::move_constructible<std::decay_t<Fn>> [[nodiscard]] auto
+    spawn(Fn&& fn)
+        -> JoinHandle<internal::catch_result::value_type<std::decay_t<Fn>>> {
+  using value_type = internal::catch_result::value_type<std::decay_t<Fn>>;
+  using result_type = typename JoinHandle<value_type>::result_type;
+
+  JoinHandle<value_type> handle{
+      std::make_unique<Option<result_type>>(None)};
+
+  handle.thread_ = std::thread{
+      [slot = handle.slot_.get()](std::decay_t<Fn> fn) {
+        // so a stack overflow in `fn` is reported
+        (void)setup_panic_signal_stack();
+        *slot = Some(catch_panic(fn));
+      },
+      std::forward<Fn>(fn)};
+
+  return handle;
+}
+
+};  // namespace stx
@@ -41,7 +41,9 @@ using namespace std::literals;
 #define ASSERT_EQ(a, b) (void)0
 #endif
 
+#include <signal.h>
 #include <stdio.h>
+#include <ucontext.h>
 
 #include <array>
 #include <csignal>
@@ -51,6 +53,9 @@ using namespace std::literals;
 #include "absl/debugging/stacktrace.h"
 #include "absl/debugging/symbolize.h"
 #include "stx/backtrace.h"
+#include "stx/flight_recorder.h"
+#include "stx/panic/reserve.h"
+#include "stx/panic/signal_safe.h"
 
 namespace stx {
 
@@ -97,70 +102,143 @@ size_t backtrace::trace(Callback callback) {
   return depth;
 }
 
-namespace {
-
-void print_backtrace() {
-  fputs(
-      "\n\nBacktrace:\nip: Instruction Pointer,  sp: Stack "
-      "Pointer\n\n",
-      stderr);
+size_t backtrace::capture(std::span<void*> ips) noexcept {
+  // skips this function's frame
+  int depth = absl::GetStackTrace(ips.data(), static_cast<int>(ips.size()), 1);
+  return static_cast<size_t>(depth);
+}
 
-  backtrace::trace([](backtrace::Frame frame, int i) {
-    auto const print_none = []() { fputs("<unknown>", stderr); };
-    auto const print_ptr = [](Ref<uintptr_t> ptr) {
-      fprintf(stderr, "0x%" PRIxPTR, ptr.get());
-    };
+size_t backtrace::trace(std::span<void* const> ips, Callback callback) {
+  char symbol[STX_SYMBOL_BUFFER_SIZE] = {};
+  auto max_len = sizeof(symbol) / sizeof(symbol[0]);
+  int depth = static_cast<int>(ips.size());
 
-    fprintf(stderr, "#%d\t\t", i);
+  for (int i = 0; i < depth; i++) {
+    std::memset(symbol, 0, max_len);
+    Frame frame{};
+    if (absl::Symbolize(ips[i], symbol, max_len)) {
+      auto span = backtrace::CharSpan(symbol, max_len);
+      frame.symbol = Some(backtrace::Symbol(std::move(span)));
+    }
 
-    frame.symbol.as_ref().match(
-        [](Ref<backtrace::Symbol> sym) {
-          for (char c : sym.get().raw()) {
-            fputc(c, stderr);
-          }
-        },
-        print_none);
+    frame.ip = Some(reinterpret_cast<uintptr_t>(ips[i]));
 
-    fputs("\t (ip: ", stderr);
+    if (callback(std::move(frame), depth - i)) break;
+  }
 
-    frame.ip.as_ref().match(print_ptr, print_none);
+  return ips.size();
+}
 
-    fputs(", sp: ", stderr);
+namespace {
 
-    frame.sp.as_ref().match(print_ptr, print_none);
+using internal::signal_safe::SignalSafeReport;
+
+// the report being written by the thread's handler. The frames are assembled
+// in preallocated buffers, as the handler may run when memory is exhausted:
+// the static one is held with the report's buffer, a report that found that
+// held assembles them on the stack instead.
+thread_local constinit SignalSafeReport* signal_report = nullptr;
+void* signal_frames[STX_MAX_STACK_FRAME_DEPTH] = {};
+
+// the instruction that faulted. The unwinder only finds the return addresses
+// of the frames above it, so the faulting function would be missing.
+void* context_pc(void const* context) noexcept {
+  auto const* ucontext = static_cast<ucontext_t const*>(context);
+#if CFG(OS, LINUX) && CFG(ARCH, X86_64)
+  return reinterpret_cast<void*>(ucontext->uc_mcontext.gregs[REG_RIP]);
+#elif CFG(OS, LINUX) && CFG(ARCH, ARM64)
+  return reinterpret_cast<void*>(ucontext->uc_mcontext.pc);
+#else
+  (void)ucontext;
+  return nullptr;
+#endif
+}
 
-    fputs(")\n", stderr);
+void write_backtrace(void const* context, std::span<void*> frames) {
+  SignalSafeReport& report = *signal_report;
 
-    return false;
-  });
+  report.write(
+      "\n\nBacktrace:\nip: Instruction Pointer,  sp: Stack "
+      "Pointer\n\n");
 
-  fputs("\n", stderr);
+  // unwinds from the interrupted context, as the handler may be running on
+  // the alternate signal stack
+  int depth = 0;
+  if (void* pc = context_pc(context); pc != nullptr) {
+    frames[depth++] = pc;
+  }
+  depth += absl::GetStackTraceWithContext(
+      frames.data() + depth, static_cast<int>(frames.size()) - depth, 1,
+      context, nullptr);
+
+  backtrace::trace(
+      std::span<void* const>{frames.data(), static_cast<size_t>(depth)},
+      [](backtrace::Frame frame, int i) {
+        SignalSafeReport& report = *signal_report;
+
+        auto const write_none = []() { signal_report->write("<unknown>"); };
+        auto const write_ptr = [](Ref<uintptr_t> ptr) {
+          signal_report->write("0x");
+          signal_report->write_number(ptr.get(), 16);
+        };
+
+        report.write("#");
+        report.write_number(i);
+        report.write("\t\t");
+
+        frame.symbol.as_ref().match(
+            [](Ref<backtrace::Symbol> sym) {
+              signal_report->write(sym.get().raw());
+            },
+            write_none);
+
+        report.write("\t (ip: ");
+        frame.ip.as_ref().match(write_ptr, write_none);
+        report.write(", sp: ");
+        frame.sp.as_ref().match(write_ptr, write_none);
+        report.write(")\n");
+
+        return false;
+      });
+
+  report.write("\n");
 }
 
-[[noreturn]] void signal_handler(int signal) {
-  fputs("\n\n", stderr);
+// only calls async-signal-safe functions, the report takes its turn with the
+// other signal-safe panics, see `panic_signal_safe`
+[[noreturn]] void signal_handler(int signal, siginfo_t*, void* context) {
+  SignalSafeReport report = internal::signal_safe::begin_signal_report();
+  signal_report = &report;
+
+  report.write("\n\n");
   switch (signal) {
     case SIGSEGV:
-      fputs(
+      report.write(
           "Received 'SIGSEGV' signal. Invalid memory access occurred "
-          "(segmentation fault).",
-          stderr);
+          "(segmentation fault).");
       break;
     case SIGILL:
-      fputs(
+      report.write(
           "Received 'SIGILL' signal. Invalid program image (illegal/invalid "
-          "instruction, i.e. nullptr dereferencing).",
-          stderr);
+          "instruction, i.e. nullptr dereferencing).");
       break;
     case SIGFPE:
-      fputs(
+      report.write(
           "Received 'SIGFPE' signal. Erroneous arithmetic operation (i.e. "
-          "divide by zero).",
-          stderr);
+          "divide by zero).");
       break;
   }
 
-  print_backtrace();
+  report.write("\n");
+  internal::flight_recorder::write_recent_events(report);
+
+  if (report.holds_buffer()) {
+    write_backtrace(context, signal_frames);
+  } else {
+    void* frames[STX_MAX_STACK_FRAME_DEPTH];
+    write_backtrace(context, frames);
+  }
+  report.finish();
   std::abort();
 }
 }  // namespace
@@ -170,11 +248,24 @@ auto backtrace::handle_signal(int signal) noexcept
   if (signal != SIGSEGV && signal != SIGILL && signal != SIGFPE)
     return Err(SignalError::Unknown);
 
-  auto err = std::signal(signal, signal_handler);
+  // the handler runs on the reserve's signal stack if it can be set up, else
+  // on the faulting thread's stack
+  (void)setup_panic_reserve();
+
+  struct sigaction action {};
+  struct sigaction previous {};
+  action.sa_sigaction = signal_handler;
+  action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+  sigemptyset(&action.sa_mask);
+
+  if (sigaction(signal, &action, &previous) != 0)
+    return Err(SignalError::SigErr);
 
-  if (err == SIG_ERR) return Err(SignalError::SigErr);
+  // a previous `SA_SIGINFO` handler is a `sa_sigaction`, which can not be
+  // returned as a `void (*)(int)`
+  if ((previous.sa_flags & SA_SIGINFO) != 0) return Ok(SIG_DFL);
 
-  return Ok(std::move(err));
+  return Ok(std::move(previous.sa_handler));
 }
 
 };  // namespace stx
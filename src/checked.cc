@@ -0,0 +1,546 @@
+/**
+ * @file checked.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/checked.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if CFG(ARCH, X86_64)
+#include <immintrin.h>
+#define STX_CHECKED_AVX2 1
+#else
+#define STX_CHECKED_AVX2 0
+#endif
+
+#if CFG(ARCH, ARM64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define STX_CHECKED_NEON 1
+#else
+#define STX_CHECKED_NEON 0
+#endif
+
+// The span-level operations process the elements in blocks. A block is first
+// scanned with SIMD for the largest magnitude of its elements (as a power of
+// two) and summed with wrapping arithmetic. If the bound proves that no
+// partial sum within the block can overflow, the wrapped sum is exact and is
+// used as is, else the block is re-run with the scalar overflow checks to find
+// the exact index at which the sequential operation overflows.
+
+namespace stx {
+namespace {
+
+constexpr size_t kBlockSize = 64;
+
+template <typename T>
+struct BlockScan {
+  /// wrapping sum of the elements (or products)
+  T sum;
+  /// every element's magnitude is at most `2^magnitude_bits`
+  uint32_t magnitude_bits;
+};
+
+template <typename T>
+using unsigned_t = std::make_unsigned_t<T>;
+
+template <typename T>
+STX_FORCE_INLINE uint32_t bit_width(T value) noexcept {
+  return static_cast<uint32_t>(std::bit_width(value));
+}
+
+// `x ^ sign(x)` is `|x| - 1` for negative `x` and `|x|` otherwise, its bit
+// width `w` thus bounds `|x| <= 2^w`.
+template <typename T>
+STX_FORCE_INLINE unsigned_t<T> ones_magnitude(T x) noexcept {
+  return static_cast<unsigned_t<T>>(x ^ (x >> (sizeof(T) * 8 - 1)));
+}
+
+// checks that adding `n` terms, each with a magnitude of at most
+// `2^magnitude_bits`, to `acc` can not overflow at any step.
+template <typename T>
+STX_FORCE_INLINE bool block_cannot_overflow(T acc, size_t n,
+                                            uint32_t magnitude_bits) noexcept {
+  if (magnitude_bits + bit_width(n) > 62) return false;
+  uint64_t bound = static_cast<uint64_t>(n) << magnitude_bits;
+  uint64_t acc_magnitude = acc < 0 ? static_cast<uint64_t>(-(acc + 1)) + 1
+                                   : static_cast<uint64_t>(acc);
+  return acc_magnitude + bound <=
+         static_cast<uint64_t>(std::numeric_limits<T>::max());
+}
+
+template <typename T>
+STX_FORCE_INLINE bool is_invalid_division(T numerator,
+                                          T denominator) noexcept {
+  if constexpr (std::is_floating_point_v<T>) {
+    return denominator == 0;
+  } else {
+    return denominator == 0 ||
+           (numerator == std::numeric_limits<T>::min() && denominator == -1);
+  }
+}
+
+struct ScalarKernel {
+  template <typename T>
+  static BlockScan<T> scan(T const* values, size_t n) noexcept {
+    unsigned_t<T> bits = 0;
+    unsigned_t<T> sum = 0;
+    for (size_t i = 0; i < n; i++) {
+      bits |= ones_magnitude(values[i]);
+      sum += static_cast<unsigned_t<T>>(values[i]);
+    }
+    return BlockScan<T>{static_cast<T>(sum), bit_width(bits)};
+  }
+
+  template <typename T>
+  static BlockScan<T> dot_scan(T const* a, T const* b, size_t n) noexcept {
+    unsigned_t<T> a_bits = 0;
+    unsigned_t<T> b_bits = 0;
+    unsigned_t<T> sum = 0;
+    for (size_t i = 0; i < n; i++) {
+      a_bits |= ones_magnitude(a[i]);
+      b_bits |= ones_magnitude(b[i]);
+      sum += static_cast<unsigned_t<T>>(a[i]) *
+             static_cast<unsigned_t<T>>(b[i]);
+    }
+    return BlockScan<T>{static_cast<T>(sum),
+                        bit_width(a_bits) + bit_width(b_bits)};
+  }
+
+  template <typename T>
+  static size_t first_invalid_division(T const* numerators,
+                                       T const* denominators,
+                                       size_t n) noexcept {
+    for (size_t i = 0; i < n; i++) {
+      if (is_invalid_division(numerators[i], denominators[i])) return i;
+    }
+    return n;
+  }
+
+  template <typename T>
+  static void divide(T const* numerators, T const* denominators, T* out,
+                     size_t n) noexcept {
+    for (size_t i = 0; i < n; i++) out[i] = numerators[i] / denominators[i];
+  }
+};
+
+#if STX_CHECKED_AVX2
+
+#define STX_TARGET_AVX2 __attribute__((target("avx2")))
+
+bool has_avx2() noexcept {
+  static bool const supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+template <typename T>
+STX_TARGET_AVX2 T reduce_add(__m256i lanes) noexcept {
+  alignas(32) unsigned_t<T> values[32 / sizeof(T)];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(values), lanes);
+  unsigned_t<T> sum = 0;
+  for (unsigned_t<T> value : values) sum += value;
+  return static_cast<T>(sum);
+}
+
+template <typename T>
+STX_TARGET_AVX2 unsigned_t<T> reduce_or(__m256i lanes) noexcept {
+  alignas(32) unsigned_t<T> values[32 / sizeof(T)];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(values), lanes);
+  unsigned_t<T> bits = 0;
+  for (unsigned_t<T> value : values) bits |= value;
+  return bits;
+}
+
+STX_TARGET_AVX2 inline __m256i load(void const* address) noexcept {
+  return _mm256_loadu_si256(static_cast<__m256i const*>(address));
+}
+
+// `x ^ sign(x)` for each 64-bit lane
+STX_TARGET_AVX2 inline __m256i ones_magnitude_epi64(__m256i x) noexcept {
+  return _mm256_xor_si256(x, _mm256_cmpgt_epi64(_mm256_setzero_si256(), x));
+}
+
+// wrapping 64-bit multiplication, AVX2 only has 32x32->64
+STX_TARGET_AVX2 inline __m256i mullo_epi64(__m256i a, __m256i b) noexcept {
+  __m256i low = _mm256_mul_epu32(a, b);
+  __m256i a_high_b = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+  __m256i a_b_high = _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32));
+  return _mm256_add_epi64(
+      low, _mm256_slli_epi64(_mm256_add_epi64(a_high_b, a_b_high), 32));
+}
+
+struct Avx2Kernel : ScalarKernel {
+  using ScalarKernel::divide;
+  using ScalarKernel::dot_scan;
+  using ScalarKernel::first_invalid_division;
+  using ScalarKernel::scan;
+
+  STX_TARGET_AVX2 static BlockScan<int32_t> scan(int32_t const* values,
+                                                 size_t n) noexcept {
+    __m256i bits = _mm256_setzero_si256();
+    __m256i sum = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256i x = load(values + i);
+      bits = _mm256_or_si256(bits,
+                             _mm256_xor_si256(x, _mm256_srai_epi32(x, 31)));
+      sum = _mm256_add_epi32(sum, x);
+    }
+    BlockScan<int32_t> tail = ScalarKernel::scan(values + i, n - i);
+    return BlockScan<int32_t>{
+        static_cast<int32_t>(static_cast<uint32_t>(reduce_add<int32_t>(sum)) +
+                             static_cast<uint32_t>(tail.sum)),
+        std::max(bit_width(reduce_or<int32_t>(bits)), tail.magnitude_bits)};
+  }
+
+  STX_TARGET_AVX2 static BlockScan<int64_t> scan(int64_t const* values,
+                                                 size_t n) noexcept {
+    __m256i bits = _mm256_setzero_si256();
+    __m256i sum = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      __m256i x = load(values + i);
+      bits = _mm256_or_si256(bits, ones_magnitude_epi64(x));
+      sum = _mm256_add_epi64(sum, x);
+    }
+    BlockScan<int64_t> tail = ScalarKernel::scan(values + i, n - i);
+    return BlockScan<int64_t>{
+        static_cast<int64_t>(static_cast<uint64_t>(reduce_add<int64_t>(sum)) +
+                             static_cast<uint64_t>(tail.sum)),
+        std::max(bit_width(reduce_or<int64_t>(bits)), tail.magnitude_bits)};
+  }
+
+  STX_TARGET_AVX2 static BlockScan<int32_t> dot_scan(int32_t const* a,
+                                                     int32_t const* b,
+                                                     size_t n) noexcept {
+    __m256i a_bits = _mm256_setzero_si256();
+    __m256i b_bits = _mm256_setzero_si256();
+    __m256i sum = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256i x = load(a + i);
+      __m256i y = load(b + i);
+      a_bits = _mm256_or_si256(a_bits,
+                               _mm256_xor_si256(x, _mm256_srai_epi32(x, 31)));
+      b_bits = _mm256_or_si256(b_bits,
+                               _mm256_xor_si256(y, _mm256_srai_epi32(y, 31)));
+      sum = _mm256_add_epi32(sum, _mm256_mullo_epi32(x, y));
+    }
+    BlockScan<int32_t> tail = ScalarKernel::dot_scan(a + i, b + i, n - i);
+    uint32_t bits = bit_width(reduce_or<int32_t>(a_bits)) +
+                    bit_width(reduce_or<int32_t>(b_bits));
+    return BlockScan<int32_t>{
+        static_cast<int32_t>(static_cast<uint32_t>(reduce_add<int32_t>(sum)) +
+                             static_cast<uint32_t>(tail.sum)),
+        std::max(bits, tail.magnitude_bits)};
+  }
+
+  STX_TARGET_AVX2 static BlockScan<int64_t> dot_scan(int64_t const* a,
+                                                     int64_t const* b,
+                                                     size_t n) noexcept {
+    __m256i a_bits = _mm256_setzero_si256();
+    __m256i b_bits = _mm256_setzero_si256();
+    __m256i sum = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      __m256i x = load(a + i);
+      __m256i y = load(b + i);
+      a_bits = _mm256_or_si256(a_bits, ones_magnitude_epi64(x));
+      b_bits = _mm256_or_si256(b_bits, ones_magnitude_epi64(y));
+      sum = _mm256_add_epi64(sum, mullo_epi64(x, y));
+    }
+    BlockScan<int64_t> tail = ScalarKernel::dot_scan(a + i, b + i, n - i);
+    uint32_t bits = bit_width(reduce_or<int64_t>(a_bits)) +
+                    bit_width(reduce_or<int64_t>(b_bits));
+    return BlockScan<int64_t>{
+        static_cast<int64_t>(static_cast<uint64_t>(reduce_add<int64_t>(sum)) +
+                             static_cast<uint64_t>(tail.sum)),
+        std::max(bits, tail.magnitude_bits)};
+  }
+
+  STX_TARGET_AVX2 static size_t first_invalid_division(
+      int32_t const* numerators, int32_t const* denominators,
+      size_t n) noexcept {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i min = _mm256_set1_epi32(std::numeric_limits<int32_t>::min());
+    __m256i minus_one = _mm256_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256i num = load(numerators + i);
+      __m256i den = load(denominators + i);
+      __m256i invalid = _mm256_or_si256(
+          _mm256_cmpeq_epi32(den, zero),
+          _mm256_and_si256(_mm256_cmpeq_epi32(num, min),
+                           _mm256_cmpeq_epi32(den, minus_one)));
+      auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(invalid));
+      if (mask != 0) return i + std::countr_zero(mask) / sizeof(int32_t);
+    }
+    return i + ScalarKernel::first_invalid_division(numerators + i,
+                                                    denominators + i, n - i);
+  }
+
+  STX_TARGET_AVX2 static size_t first_invalid_division(
+      int64_t const* numerators, int64_t const* denominators,
+      size_t n) noexcept {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i min = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+    __m256i minus_one = _mm256_set1_epi64x(-1);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      __m256i num = load(numerators + i);
+      __m256i den = load(denominators + i);
+      __m256i invalid = _mm256_or_si256(
+          _mm256_cmpeq_epi64(den, zero),
+          _mm256_and_si256(_mm256_cmpeq_epi64(num, min),
+                           _mm256_cmpeq_epi64(den, minus_one)));
+      auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(invalid));
+      if (mask != 0) return i + std::countr_zero(mask) / sizeof(int64_t);
+    }
+    return i + ScalarKernel::first_invalid_division(numerators + i,
+                                                    denominators + i, n - i);
+  }
+
+  STX_TARGET_AVX2 static size_t first_invalid_division(
+      double const* numerators, double const* denominators,
+      size_t n) noexcept {
+    __m256d zero = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      __m256d den = _mm256_loadu_pd(denominators + i);
+      auto mask = static_cast<uint32_t>(
+          _mm256_movemask_pd(_mm256_cmp_pd(den, zero, _CMP_EQ_OQ)));
+      if (mask != 0) return i + std::countr_zero(mask);
+    }
+    return i + ScalarKernel::first_invalid_division(numerators + i,
+                                                    denominators + i, n - i);
+  }
+
+  STX_TARGET_AVX2 static void divide(double const* numerators,
+                                     double const* denominators, double* out,
+                                     size_t n) noexcept {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_loadu_pd(numerators + i),
+                                              _mm256_loadu_pd(denominators + i)));
+    }
+    ScalarKernel::divide(numerators + i, denominators + i, out + i, n - i);
+  }
+};
+
+#endif
+
+#if STX_CHECKED_NEON
+
+template <typename T, typename Lanes>
+T reduce_add(Lanes lanes) noexcept {
+  unsigned_t<T> values[16 / sizeof(T)];
+  std::memcpy(values, &lanes, sizeof(values));
+  unsigned_t<T> sum = 0;
+  for (unsigned_t<T> value : values) sum += value;
+  return static_cast<T>(sum);
+}
+
+template <typename T, typename Lanes>
+unsigned_t<T> reduce_or(Lanes lanes) noexcept {
+  unsigned_t<T> values[16 / sizeof(T)];
+  std::memcpy(values, &lanes, sizeof(values));
+  unsigned_t<T> bits = 0;
+  for (unsigned_t<T> value : values) bits |= value;
+  return bits;
+}
+
+struct NeonKernel : ScalarKernel {
+  using ScalarKernel::dot_scan;
+  using ScalarKernel::scan;
+
+  static BlockScan<int32_t> scan(int32_t const* values, size_t n) noexcept {
+    int32x4_t bits = vdupq_n_s32(0);
+    int32x4_t sum = vdupq_n_s32(0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      int32x4_t x = vld1q_s32(values + i);
+      bits = vorrq_s32(bits, veorq_s32(x, vshrq_n_s32(x, 31)));
+      sum = vaddq_s32(sum, x);
+    }
+    BlockScan<int32_t> tail = ScalarKernel::scan(values + i, n - i);
+    return BlockScan<int32_t>{
+        static_cast<int32_t>(static_cast<uint32_t>(reduce_add<int32_t>(sum)) +
+                             static_cast<uint32_t>(tail.sum)),
+        std::max(bit_width(reduce_or<int32_t>(bits)), tail.magnitude_bits)};
+  }
+
+  static BlockScan<int64_t> scan(int64_t const* values, size_t n) noexcept {
+    int64x2_t bits = vdupq_n_s64(0);
+    int64x2_t sum = vdupq_n_s64(0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+      int64x2_t x = vld1q_s64(values + i);
+      bits = vorrq_s64(bits, veorq_s64(x, vshrq_n_s64(x, 63)));
+      sum = vaddq_s64(sum, x);
+    }
+    BlockScan<int64_t> tail = ScalarKernel::scan(values + i, n - i);
+    return BlockScan<int64_t>{
+        static_cast<int64_t>(static_cast<uint64_t>(reduce_add<int64_t>(sum)) +
+                             static_cast<uint64_t>(tail.sum)),
+        std::max(bit_width(reduce_or<int64_t>(bits)), tail.magnitude_bits)};
+  }
+
+  static BlockScan<int32_t> dot_scan(int32_t const* a, int32_t const* b,
+                                     size_t n) noexcept {
+    int32x4_t a_bits = vdupq_n_s32(0);
+    int32x4_t b_bits = vdupq_n_s32(0);
+    int32x4_t sum = vdupq_n_s32(0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      int32x4_t x = vld1q_s32(a + i);
+      int32x4_t y = vld1q_s32(b + i);
+      a_bits = vorrq_s32(a_bits, veorq_s32(x, vshrq_n_s32(x, 31)));
+      b_bits = vorrq_s32(b_bits, veorq_s32(y, vshrq_n_s32(y, 31)));
+      sum = vmlaq_s32(sum, x, y);
+    }
+    BlockScan<int32_t> tail = ScalarKernel::dot_scan(a + i, b + i, n - i);
+    uint32_t bits = bit_width(reduce_or<int32_t>(a_bits)) +
+                    bit_width(reduce_or<int32_t>(b_bits));
+    return BlockScan<int32_t>{
+        static_cast<int32_t>(static_cast<uint32_t>(reduce_add<int32_t>(sum)) +
+                             static_cast<uint32_t>(tail.sum)),
+        std::max(bits, tail.magnitude_bits)};
+  }
+};
+
+using DefaultKernel = NeonKernel;
+
+#else
+
+using DefaultKernel = ScalarKernel;
+
+#endif
+
+template <typename Kernel, typename T>
+auto sum_impl(std::span<T const> values) noexcept -> Result<T, ArithErrorAt> {
+  T acc = 0;
+  for (size_t begin = 0; begin < values.size(); begin += kBlockSize) {
+    size_t n = std::min(kBlockSize, values.size() - begin);
+    T const* block = values.data() + begin;
+    BlockScan<T> scan = Kernel::scan(block, n);
+    if (block_cannot_overflow(acc, n, scan.magnitude_bits)) {
+      acc = static_cast<T>(acc + scan.sum);
+      continue;
+    }
+    for (size_t i = 0; i < n; i++) {
+      if (__builtin_add_overflow(acc, block[i], &acc))
+        return Err(ArithErrorAt{ArithError::Overflow, begin + i});
+    }
+  }
+  return Ok(std::move(acc));
+}
+
+template <typename Kernel, typename T>
+auto dot_impl(std::span<T const> a, std::span<T const> b) noexcept
+    -> Result<T, ArithErrorAt> {
+  size_t size = std::min(a.size(), b.size());
+  T acc = 0;
+  for (size_t begin = 0; begin < size; begin += kBlockSize) {
+    size_t n = std::min(kBlockSize, size - begin);
+    T const* a_block = a.data() + begin;
+    T const* b_block = b.data() + begin;
+    BlockScan<T> scan = Kernel::dot_scan(a_block, b_block, n);
+    if (block_cannot_overflow(acc, n, scan.magnitude_bits)) {
+      acc = static_cast<T>(acc + scan.sum);
+      continue;
+    }
+    for (size_t i = 0; i < n; i++) {
+      T product;
+      if (__builtin_mul_overflow(a_block[i], b_block[i], &product) ||
+          __builtin_add_overflow(acc, product, &acc))
+        return Err(ArithErrorAt{ArithError::Overflow, begin + i});
+    }
+  }
+  return Ok(std::move(acc));
+}
+
+template <typename Kernel, typename T>
+auto divide_each_impl(std::span<T const> numerators,
+                      std::span<T const> denominators,
+                      std::span<T> out) noexcept
+    -> Result<std::span<T>, ArithErrorAt> {
+  size_t size =
+      std::min({numerators.size(), denominators.size(), out.size()});
+  for (size_t begin = 0; begin < size; begin += kBlockSize) {
+    size_t n = std::min(kBlockSize, size - begin);
+    T const* num = numerators.data() + begin;
+    T const* den = denominators.data() + begin;
+    size_t valid = Kernel::first_invalid_division(num, den, n);
+    Kernel::divide(num, den, out.data() + begin, valid);
+    if (valid != n) {
+      ArithError error =
+          den[valid] == 0 ? ArithError::DivisionByZero : ArithError::Overflow;
+      return Err(ArithErrorAt{error, begin + valid});
+    }
+  }
+  return Ok(out.first(size));
+}
+
+}  // namespace
+
+#if STX_CHECKED_AVX2
+#define STX_CHECKED_DISPATCH(impl, ...)                 \
+  if (has_avx2()) return impl<Avx2Kernel>(__VA_ARGS__); \
+  return impl<DefaultKernel>(__VA_ARGS__)
+#else
+#define STX_CHECKED_DISPATCH(impl, ...) \
+  return impl<DefaultKernel>(__VA_ARGS__)
+#endif
+
+auto checked_sum(std::span<int32_t const> values) noexcept
+    -> Result<int32_t, ArithErrorAt> {
+  STX_CHECKED_DISPATCH(sum_impl, values);
+}
+
+auto checked_sum(std::span<int64_t const> values) noexcept
+    -> Result<int64_t, ArithErrorAt> {
+  STX_CHECKED_DISPATCH(sum_impl, values);
+}
+
+auto checked_dot(std::span<int32_t const> a,
+                 std::span<int32_t const> b) noexcept
+    -> Result<int32_t, ArithErrorAt> {
+  STX_CHECKED_DISPATCH(dot_impl, a, b);
+}
+
+auto checked_dot(std::span<int64_t const> a,
+                 std::span<int64_t const> b) noexcept
+    -> Result<int64_t, ArithErrorAt> {
+  STX_CHECKED_DISPATCH(dot_impl, a, b);
+}
+
+auto checked_divide_each(std::span<int32_t const> numerators,
+                         std::span<int32_t const> denominators,
+                         std::span<int32_t> out) noexcept
+    -> Result<std::span<int32_t>, ArithErrorAt> {
+  STX_CHECKED_DISPATCH(divide_each_impl, numerators, denominators, out);
+}
+
+auto checked_divide_each(std::span<int64_t const> numerators,
+                         std::span<int64_t const> denominators,
+                         std::span<int64_t> out) noexcept
+    -> Result<std::span<int64_t>, ArithErrorAt> {
+  STX_CHECKED_DISPATCH(divide_each_impl, numerators, denominators, out);
+}
+
+auto checked_divide_each(std::span<double const> numerators,
+                         std::span<double const> denominators,
+                         std::span<double> out) noexcept
+    -> Result<std::span<double>, ArithErrorAt> {
+  STX_CHECKED_DISPATCH(divide_each_impl, numerators, denominators, out);
+}
+
+}  // namespace stx
@@ -0,0 +1,112 @@
+/**
+ * @file halt.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-16
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/panic/handlers/halt/halt.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if CFG(OS, POSIX)
+#include <signal.h>
+#endif
+
+#if CFG(OS, LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace stx {
+namespace {
+
+// incremented to release the parked threads, a parked thread waits for it to
+// change from the value it parked at
+std::atomic<uint32_t> release_epoch{0};
+
+std::atomic<size_t> num_parked{0};
+
+// a parked thread wakes up this often to check `release_epoch` even if it was
+// not woken, i.e. if the epoch was changed by a debugger or the platform has
+// no futex
+constexpr std::chrono::milliseconds kParkRecheckInterval{250};
+
+#if CFG(OS, LINUX)
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+              std::atomic<uint32_t>::is_always_lock_free);
+
+uint32_t* epoch_word() noexcept {
+  return reinterpret_cast<uint32_t*>(&release_epoch);
+}
+#endif
+
+void wait_for_release(uint32_t epoch) noexcept {
+#if CFG(OS, LINUX)
+  constexpr auto seconds =
+      std::chrono::duration_cast<std::chrono::seconds>(kParkRecheckInterval);
+  timespec timeout{};
+  timeout.tv_sec = static_cast<time_t>(seconds.count());
+  timeout.tv_nsec = static_cast<long>(
+      std::chrono::nanoseconds{kParkRecheckInterval - seconds}.count());
+  // returns immediately if the epoch is no longer `epoch`
+  ::syscall(SYS_futex, epoch_word(), FUTEX_WAIT_PRIVATE, epoch, &timeout,
+            nullptr, 0);
+#else
+  (void)epoch;
+  std::this_thread::sleep_for(kParkRecheckInterval);
+#endif
+}
+
+void wake_parked() noexcept {
+#if CFG(OS, LINUX)
+  ::syscall(SYS_futex, epoch_word(), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr,
+            nullptr, 0);
+#endif
+}
+
+#if CFG(OS, POSIX)
+void release_signal_handler(int) { release_parked_threads(); }
+#endif
+
+}  // namespace
+}  // namespace stx
+
+STX_EXPORT void stx::internal::thread_park::park() noexcept {
+  uint32_t const epoch = release_epoch.load(std::memory_order::acquire);
+  num_parked.fetch_add(1, std::memory_order::relaxed);
+
+  while (release_epoch.load(std::memory_order::acquire) == epoch) {
+    wait_for_release(epoch);
+  }
+
+  num_parked.fetch_sub(1, std::memory_order::relaxed);
+}
+
+STX_EXPORT void stx::release_parked_threads() noexcept {
+  release_epoch.fetch_add(1, std::memory_order::release);
+  wake_parked();
+}
+
+STX_EXPORT size_t stx::parked_threads() noexcept {
+  return num_parked.load(std::memory_order::relaxed);
+}
+
+#if CFG(OS, POSIX)
+STX_EXPORT bool stx::release_parked_threads_on(int signal) noexcept {
+  struct sigaction action {};
+  action.sa_handler = release_signal_handler;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  return ::sigaction(signal, &action, nullptr) == 0;
+}
+#endif
@@ -1,18 +1,43 @@
 
 #include "stx/panic/hook.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <memory>
+#include <utility>
+
+#include "stx/panic/unwind.h"
+
+#if CFG(OS, POSIX)
+#include <unistd.h>
+#endif
+
+#if defined(STX_ENABLE_PANIC_BACKTRACE)
+#include "stx/backtrace.h"
+#endif
 
 namespace stx {
 namespace this_thread {
 namespace {
 
+thread_local constinit size_t panic_count = 0;
+
+/// number of `catch_panic` calls the thread is running in
+thread_local constinit size_t catch_depth = 0;
+
 /// increases the panic count for this thread by `step`
 STX_LOCAL size_t step_panic_count(size_t step) noexcept {
-  thread_local static size_t panic_count = 0;
   panic_count += step;
   return panic_count;
 }
+
+/// the panic hook of this thread, `nullptr` if it uses the global hook
+thread_local constinit PanicHook thread_panic_hook = nullptr;
+
+/// the panic that is unwinding to `catch_panic`, preallocated so that
+/// unwinding does not allocate
+thread_local constinit PanicInfo panic_info{};
 }  // namespace
 }  // namespace this_thread
 
@@ -21,6 +46,84 @@ STX_LOCAL AtomicPanicHook& panic_hook_ref() noexcept {
   return hook;
 }
 
+namespace {
+
+enum class HookState : uint8_t { Empty, Claimed, Ready, Removed };
+
+// `hook` and `context` are written while the slot is `Claimed`, before `state`
+// is set to `Ready` with release ordering, so a reader that sees `Ready` reads
+// them without locking.
+//
+// A removed slot is reused once no reader is in it, which is the grace period
+// of the chain: a reader announces itself in `readers` before it loads
+// `state`, and a registrant claims a `Removed` slot before it checks that
+// `readers` is 0, so a reader that is still reading the old hook keeps the slot
+// from being rewritten, and a later reader sees it `Claimed` and skips it.
+struct HookSlot {
+  std::atomic<HookState> state{HookState::Empty};
+  std::atomic<uint32_t> readers{0};
+  ChainedPanicHook hook{nullptr};
+  void* context{nullptr};
+};
+
+struct HookChain {
+  HookSlot slots[kMaxChainedPanicHooks];
+};
+
+STX_LOCAL HookChain& hook_chain_ref() noexcept {
+  static HookChain chain;
+  return chain;
+}
+
+/// calls `fn` on `slot` if it is `Ready`, keeping the slot from being reused
+/// until it returns
+template <typename Fn>
+STX_LOCAL bool read_hook_slot(HookSlot& slot, Fn&& fn) noexcept {
+  if (slot.state.load(std::memory_order::relaxed) == HookState::Empty) {
+    return false;
+  }
+
+  slot.readers.fetch_add(1, std::memory_order::seq_cst);
+  bool ready = slot.state.load(std::memory_order::seq_cst) == HookState::Ready;
+  bool result = ready && fn(slot);
+  slot.readers.fetch_sub(1, std::memory_order::release);
+  return result;
+}
+
+/// claims `slot` if it is in state `from` and no reader is in it
+STX_LOCAL bool claim_hook_slot(HookSlot& slot, HookState from) noexcept {
+  HookState expected = from;
+  if (!slot.state.compare_exchange_strong(expected, HookState::Claimed,
+                                          std::memory_order::seq_cst)) {
+    return false;
+  }
+
+  // a reader may still be calling the hook that was removed from the slot
+  if (from == HookState::Removed &&
+      slot.readers.load(std::memory_order::seq_cst) != 0) {
+    slot.state.store(HookState::Removed, std::memory_order::release);
+    return false;
+  }
+
+  return true;
+}
+
+STX_LOCAL void dispatch_hook_chain(std::string_view info,
+                                   ReportPayload const& payload,
+                                   SourceLocation location) noexcept {
+  HookChain& chain = hook_chain_ref();
+
+  // a slot that is claimed but not yet `Ready` is skipped
+  for (HookSlot& slot : chain.slots) {
+    (void)read_hook_slot(slot, [&](HookSlot const& ready) {
+      ready.hook(ready.context, info, payload, location);
+      return true;
+    });
+  }
+}
+
+}  // namespace
+
 }  // namespace stx
 
 STX_EXPORT bool stx::panic_hook_visible() noexcept { return kVisiblePanicHook; }
@@ -68,28 +171,176 @@ bool stx::take_panic_hook(PanicHook* out) noexcept {
   return true;
 }
 
-[[noreturn]] STX_LOCAL void stx::begin_panic(std::string_view info,
-                                             ReportPayload const& payload,
-                                             SourceLocation location) noexcept {
-  // TODO(lamarrr): We probably need a method for stack unwinding, So we can
-  // free held resources
+#if defined(STX_VISIBLE_PANIC_HOOK)
+STX_EXPORT
+#else
+STX_LOCAL
+#endif
+
+bool stx::register_panic_hook(ChainedPanicHook hook, void* context) noexcept {
+  if (stx::this_thread::is_panicking() || hook == nullptr) return false;
+
+  HookChain& chain = hook_chain_ref();
+
+  // unused slots are taken first, so removed slots have time to drain
+  for (HookState from : {HookState::Empty, HookState::Removed}) {
+    for (HookSlot& slot : chain.slots) {
+      if (!claim_hook_slot(slot, from)) continue;
+
+      slot.hook = hook;
+      slot.context = context;
+      slot.state.store(HookState::Ready, std::memory_order::release);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+#if defined(STX_VISIBLE_PANIC_HOOK)
+STX_EXPORT
+#else
+STX_LOCAL
+#endif
 
-  // detecting recursive panics
+bool stx::unregister_panic_hook(ChainedPanicHook hook, void* context) noexcept {
+  if (stx::this_thread::is_panicking()) return false;
+
+  HookChain& chain = hook_chain_ref();
+
+  for (HookSlot& slot : chain.slots) {
+    bool removed = read_hook_slot(slot, [&](HookSlot& ready) {
+      HookState expected = HookState::Ready;
+      return ready.hook == hook && ready.context == context &&
+             ready.state.compare_exchange_strong(expected, HookState::Removed,
+                                                 std::memory_order::acq_rel);
+    });
+    if (removed) return true;
+  }
+  return false;
+}
+
+#if defined(STX_VISIBLE_PANIC_HOOK)
+STX_EXPORT
+#else
+STX_LOCAL
+#endif
+
+stx::PanicHook stx::this_thread::exchange_panic_hook(PanicHook hook) noexcept {
+  return std::exchange(thread_panic_hook, hook);
+}
+
+#if defined(STX_VISIBLE_PANIC_HOOK)
+STX_EXPORT
+#else
+STX_LOCAL
+#endif
+
+bool stx::this_thread::attach_panic_hook(PanicHook hook) noexcept {
+  if (is_panicking()) return false;
+  thread_panic_hook = hook;
+  return true;
+}
+
+STX_EXPORT void stx::internal::panic_unwind::enter_catch() noexcept {
+  this_thread::catch_depth++;
+}
+
+STX_EXPORT void stx::internal::panic_unwind::leave_catch() noexcept {
+  this_thread::catch_depth--;
+}
+
+STX_EXPORT void stx::internal::panic_unwind::recover() noexcept {
+  // the panic has been unwound up to `catch_panic`, the thread can panic again
+  this_thread::panic_count = 0;
+}
+
+STX_EXPORT stx::PanicInfo const&
+stx::internal::panic_unwind::thread_panic_info() noexcept {
+  return this_thread::panic_info;
+}
+
+STX_EXPORT stx::PanicInfo::PanicInfo(std::string_view info,
+                                     ReportPayload const& payload,
+                                     SourceLocation location) noexcept
+    : location_{std::move(location)} {
+  info_size_ = std::min(info.size(), kPanicInfoSize);
+  std::copy_n(info.data(), info_size_, info_);
+
+  SpanReportWriter report{std::span<char>{report_, kPanicReportSize}};
+  payload.write_to(report);
+  report_size_ = report.size();
+  truncated_ = info.size() > kPanicInfoSize || report.truncated();
+
+#if defined(STX_ENABLE_PANIC_BACKTRACE)
+  // only the instruction pointers are kept, they are symbolized when the
+  // backtrace is read, not while unwinding
+  void* ips[kMaxPanicFrames];
+  num_frames_ = backtrace::capture(std::span<void*>{ips});
+  for (size_t i = 0; i < num_frames_; i++) {
+    frames_[i] = reinterpret_cast<uintptr_t>(ips[i]);
+  }
+#endif
+}
+
+#if defined(STX_ENABLE_PANIC_UNWIND) && defined(__cpp_exceptions)
+namespace stx {
+namespace {
+
+[[noreturn]] void throw_panic_unwind(std::string_view info,
+                                     ReportPayload const& payload,
+                                     SourceLocation location) {
+  // the payload may refer to values on the stack that is about to be
+  // unwound, so it is formatted into the thread's slot before unwinding
+  std::destroy_at(&this_thread::panic_info);
+  std::construct_at(&this_thread::panic_info, info, payload,
+                    std::move(location));
+  throw PanicUnwind{};
+}
+
+}  // namespace
+}  // namespace stx
+#endif
+
+[[noreturn]] STX_LOCAL void stx::begin_panic(
+    std::string_view info, ReportPayload const& payload,
+    SourceLocation location) STX_PANIC_NOEXCEPT {
+  // detecting recursive panics, this includes panics while the stack is being
+  // unwound from a panic
   if (this_thread::step_panic_count(1) > 1) {
+#if CFG(OS, POSIX)
+    // the first panic may have been interrupted while holding stdio's lock
+    constexpr std::string_view kMessage =
+        "thread panicked while processing a panic. aborting...\n";
+    if (::write(STDERR_FILENO, kMessage.data(), kMessage.size()) < 0) {
+    }
+#else
     std::fputs("thread panicked while processing a panic. aborting...\n",
                stderr);
     std::fflush(stderr);
+#endif
     std::abort();
   }
 
-  // panic hooks, all threads use the same panic hook
-  PanicHook hook = panic_hook_ref().load(std::memory_order::seq_cst);
+  // the hook chain observes the panic before it is handled
+  dispatch_hook_chain(info, payload, location);
+
+  // the thread's hook takes precedence over the hook shared by all threads
+  PanicHook hook = this_thread::thread_panic_hook;
+  if (hook == nullptr) hook = panic_hook_ref().load(std::memory_order::seq_cst);
 
   if (hook != nullptr) {
-    hook(std::move(info), payload, std::move(location));
+    hook(info, payload, location);
   } else {
-    default_panic_hook(std::move(info), payload, std::move(location));
+    default_panic_hook(info, payload, location);
   }
 
+#if defined(STX_ENABLE_PANIC_UNWIND) && defined(__cpp_exceptions)
+  // only unwind if there is a `catch_panic` to stop at
+  if (this_thread::catch_depth != 0) {
+    throw_panic_unwind(info, payload, std::move(location));
+  }
+#endif
+
   std::abort();
 }
@@ -0,0 +1,171 @@
+/**
+ * @file reserve.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/panic/reserve.h"
+
+#include <atomic>
+
+#if CFG(OS, GNU_LINUX)
+#include <signal.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+namespace stx {
+namespace {
+
+std::atomic<bool> reserve_ready{false};
+
+#if CFG(OS, GNU_LINUX)
+
+// statically allocated, so that they are there even if memory is exhausted
+alignas(16) char signal_stack[kPanicReserveStackSize];
+alignas(16) char panic_stack[kPanicReserveStackSize];
+
+// guards the panic stack and the task state below
+std::atomic_flag panic_stack_in_use = ATOMIC_FLAG_INIT;
+
+ucontext_t caller_context;
+ucontext_t task_context;
+void (*task_fn)(void*) = nullptr;
+void* task_arg = nullptr;
+
+void run_task() { task_fn(task_arg); }
+
+// a thread's own signal stack, below a guard page, uninstalled and unmapped
+// when the thread exits
+class ThreadSignalStack {
+ public:
+  constexpr ThreadSignalStack() noexcept = default;
+
+  ThreadSignalStack(ThreadSignalStack const&) = delete;
+  ThreadSignalStack& operator=(ThreadSignalStack const&) = delete;
+
+  ~ThreadSignalStack() noexcept {
+    if (mapping_ == nullptr) return;
+
+    stack_t current{};
+    if (sigaltstack(nullptr, &current) == 0 && current.ss_sp == base()) {
+      stack_t disabled{};
+      disabled.ss_flags = SS_DISABLE;
+      sigaltstack(&disabled, nullptr);
+    }
+    munmap(mapping_, mapping_size());
+  }
+
+  bool install() noexcept {
+    if (mapping_ == nullptr) {
+      void* mapping = mmap(nullptr, mapping_size(), PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (mapping == MAP_FAILED) return false;
+      mapping_ = static_cast<char*>(mapping);
+      // an overflow of the signal stack faults instead of corrupting memory
+      mprotect(mapping_, page_size(), PROT_NONE);
+    }
+
+    stack_t stack{};
+    stack.ss_sp = base();
+    stack.ss_size = kPanicReserveStackSize;
+    stack.ss_flags = 0;
+    return sigaltstack(&stack, nullptr) == 0;
+  }
+
+ private:
+  static size_t page_size() noexcept {
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+
+  static size_t mapping_size() noexcept {
+    return page_size() + kPanicReserveStackSize;
+  }
+
+  char* base() const noexcept { return mapping_ + page_size(); }
+
+  char* mapping_ = nullptr;
+};
+
+thread_local ThreadSignalStack thread_signal_stack;
+
+#endif
+
+}  // namespace
+}  // namespace stx
+
+STX_EXPORT bool stx::setup_panic_reserve() noexcept {
+#if CFG(OS, GNU_LINUX)
+  static std::atomic_flag claimed = ATOMIC_FLAG_INIT;
+  if (claimed.test_and_set(std::memory_order_acq_rel)) {
+    return reserve_ready.load(std::memory_order_acquire);
+  }
+
+  stack_t stack{};
+  stack.ss_sp = signal_stack;
+  stack.ss_size = kPanicReserveStackSize;
+  stack.ss_flags = 0;
+  if (sigaltstack(&stack, nullptr) != 0) return false;
+
+  reserve_ready.store(true, std::memory_order_release);
+  return true;
+#else
+  return false;
+#endif
+}
+
+STX_EXPORT bool stx::setup_panic_signal_stack() noexcept {
+#if CFG(OS, GNU_LINUX)
+  // i.e. the main thread's, installed by `setup_panic_reserve`
+  stack_t current{};
+  if (sigaltstack(nullptr, &current) != 0) return false;
+  if ((current.ss_flags & SS_DISABLE) == 0) return true;
+
+  return thread_signal_stack.install();
+#else
+  return false;
+#endif
+}
+
+STX_EXPORT bool stx::panic_reserve_ready() noexcept {
+  return reserve_ready.load(std::memory_order_acquire);
+}
+
+STX_EXPORT bool stx::internal::panic_reserve::run(void (*fn)(void*),
+                                                  void* context) noexcept {
+#if CFG(OS, GNU_LINUX)
+  if (!reserve_ready.load(std::memory_order_acquire) ||
+      panic_stack_in_use.test_and_set(std::memory_order_acquire)) {
+    return false;
+  }
+
+  task_fn = fn;
+  task_arg = context;
+
+  if (getcontext(&task_context) != 0) {
+    panic_stack_in_use.clear(std::memory_order_release);
+    return false;
+  }
+
+  task_context.uc_stack.ss_sp = panic_stack;
+  task_context.uc_stack.ss_size = kPanicReserveStackSize;
+  task_context.uc_link = &caller_context;
+  makecontext(&task_context, run_task, 0);
+
+  // returns once `run_task` returns, through `uc_link`
+  int swapped = swapcontext(&caller_context, &task_context);
+
+  panic_stack_in_use.clear(std::memory_order_release);
+  return swapped == 0;
+#else
+  (void)fn;
+  (void)context;
+  return false;
+#endif
+}
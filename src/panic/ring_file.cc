@@ -0,0 +1,188 @@
+/**
+ * @file ring_file.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-20
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/panic/ring_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <charconv>
+#include <mutex>
+
+#include "stx/flight_recorder.h"
+#include "stx/panic/report_line.h"
+
+namespace stx {
+namespace {
+
+using internal::panic_ring::FileHeader;
+using internal::panic_ring::file_size;
+using internal::panic_ring::kSlotsOffset;
+using internal::panic_ring::kSlotWriting;
+using internal::panic_ring::SlotHeader;
+
+// the mapping is published once it is initialized, writers only load it
+std::atomic<char*> ring_data{nullptr};
+size_t ring_size = 0;
+
+// serializes opening and closing, never taken by writers
+std::mutex ring_mutex;
+
+// writes into the report area of a slot, dropping what does not fit
+class SlotWriter final : public ReportWriter {
+ public:
+  explicit SlotWriter(std::span<char> buffer) noexcept : writer_{buffer} {}
+
+  void write(std::string_view text) noexcept override { writer_.write(text); }
+
+  template <typename T>
+  void write_number(T value, int base = 10) noexcept {
+    char digits[24];
+    std::to_chars_result result =
+        std::to_chars(digits, digits + sizeof(digits), value, base);
+    write(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+  }
+
+  [[nodiscard]] size_t size() const noexcept { return writer_.size(); }
+
+  [[nodiscard]] bool truncated() const noexcept { return writer_.truncated(); }
+
+ private:
+  SpanReportWriter writer_;
+};
+
+void unmap_ring() noexcept {
+  char* data = ring_data.exchange(nullptr, std::memory_order_acq_rel);
+  if (data != nullptr) munmap(data, ring_size);
+  ring_size = 0;
+}
+
+}  // namespace
+}  // namespace stx
+
+STX_EXPORT bool stx::open_panic_ring(char const* path, uint32_t num_slots,
+                                     uint32_t slot_size) noexcept {
+  if (path == nullptr || num_slots == 0 || slot_size <= sizeof(SlotHeader) ||
+      slot_size % alignof(SlotHeader) != 0) {
+    return false;
+  }
+
+  std::lock_guard lock{ring_mutex};
+  unmap_ring();
+
+  int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) return false;
+
+  size_t size = file_size(num_slots, slot_size);
+  struct stat status {};
+  if (fstat(fd, &status) != 0 ||
+      (static_cast<size_t>(status.st_size) != size &&
+       ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+    ::close(fd);
+    return false;
+  }
+
+#if CFG(OS, LINUX)
+  // the blocks are allocated now, so writing a report into a hole can not
+  // fail with a `SIGBUS` once the disk is full
+  if (posix_fallocate(fd, 0, static_cast<off_t>(size)) != 0) {
+    ::close(fd);
+    return false;
+  }
+#endif
+
+  void* mapping =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) return false;
+
+  char* data = static_cast<char*>(mapping);
+  auto* header = reinterpret_cast<FileHeader*>(data);
+
+  // a ring of another geometry, or not a ring, is reset. The magic is written
+  // last, so an interrupted reset leaves an invalid file.
+  if (internal::panic_ring::valid_header(std::span<char const>{data, size}) ==
+          nullptr ||
+      header->num_slots != num_slots || header->slot_size != slot_size) {
+    header->magic = 0;
+    std::memset(data + kSlotsOffset, 0, size - kSlotsOffset);
+    header->num_slots = num_slots;
+    header->slot_size = slot_size;
+    header->next_ticket = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = kPanicRingMagic;
+  } else {
+    // frees the slots of reports that a process died while writing. A ring is
+    // only written by the process that opened it last.
+    for (uint32_t i = 0; i < num_slots; i++) {
+      auto* slot_header = reinterpret_cast<SlotHeader*>(
+          data + kSlotsOffset + static_cast<size_t>(i) * slot_size);
+      if (slot_header->sequence == kSlotWriting) slot_header->sequence = 0;
+    }
+  }
+
+  ring_size = size;
+  ring_data.store(data, std::memory_order_release);
+  return true;
+}
+
+STX_EXPORT void stx::close_panic_ring() noexcept {
+  std::lock_guard lock{ring_mutex};
+  unmap_ring();
+}
+
+STX_EXPORT void stx::panic_ring_hook(void*, std::string_view info,
+                                     ReportPayload const& payload,
+                                     SourceLocation location) noexcept {
+  char* data = ring_data.load(std::memory_order_acquire);
+  if (data == nullptr) return;
+
+  auto* header = reinterpret_cast<FileHeader*>(data);
+  uint64_t ticket = std::atomic_ref<uint64_t>{header->next_ticket}.fetch_add(
+      1, std::memory_order_relaxed);
+
+  char* slot = data + kSlotsOffset +
+               (ticket % header->num_slots) * header->slot_size;
+  auto* slot_header = reinterpret_cast<SlotHeader*>(slot);
+  std::atomic_ref<uint64_t> sequence{slot_header->sequence};
+
+  // once the ring wraps, a slot is shared by tickets `num_slots` apart. The
+  // writer claims it from the older report it replaces, so a reader does not
+  // take a partly overwritten report for the previous one. If another writer
+  // holds the slot, or a newer report is already in it, the report is dropped
+  // rather than torn.
+  uint64_t previous = sequence.load(std::memory_order_relaxed);
+  if (previous == kSlotWriting || previous > ticket ||
+      !sequence.compare_exchange_strong(previous, kSlotWriting,
+                                        std::memory_order_relaxed)) {
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  SlotWriter report{std::span<char>{slot + sizeof(SlotHeader),
+                                    header->slot_size - sizeof(SlotHeader)}};
+
+  internal::panic_util::write_panic_line(report, info, payload, location);
+
+  internal::flight_recorder::write_recent_events(report);
+
+  slot_header->timestamp_ns = internal::panic_util::unix_timestamp_ns();
+  slot_header->size = static_cast<uint32_t>(report.size());
+  slot_header->truncated = report.truncated() ? 1 : 0;
+
+  // the report is in the shared mapping, and so in the page cache, once the
+  // sequence is published. It reaches the disk with the kernel's writeback,
+  // even if the process dies right after.
+  sequence.store(ticket + 1, std::memory_order_release);
+}
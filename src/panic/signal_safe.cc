@@ -0,0 +1,191 @@
+/**
+ * @file signal_safe.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-21
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/panic/signal_safe.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "stx/flight_recorder.h"
+#include "stx/panic/handlers/default/default.h"
+#include "stx/panic/report_line.h"
+#include "stx/panic/sink.h"
+
+namespace stx {
+namespace internal {
+namespace signal_safe {
+namespace {
+
+using panic_util::spin_pause;
+
+// a ticket lock: a report takes the next ticket and is written once
+// `now_serving` reaches it. Unlike a spin lock, the reports are written in
+// the order they started, and a report can take over from one that stalls.
+// A report only advances `now_serving` from its own ticket, so a stalled
+// report that resumes does not give away the turn of the one that took over.
+std::atomic<uint64_t> next_ticket{0};
+std::atomic<uint64_t> now_serving{0};
+
+// statically allocated, so reporting does not depend on the heap or on how
+// much of the stack is left. It is held by one report at a time, a report
+// that took over may find it still held by the one that stalled.
+char report_buffer[kSignalReportBufferSize] = {};
+std::atomic<bool> report_buffer_held{false};
+
+// the thread whose report has the turn, so a signal handler that interrupted
+// it takes over at once instead of waiting for a report that can not finish
+std::atomic<uintptr_t> turn_owner{0};
+
+// spins before the waiting report sleeps between checks of the turn
+constexpr uint32_t kSignalReportSpins = 256;
+constexpr long kSignalReportSleepNs = 100'000;
+
+// an id of the calling thread that is async-signal-safe to read
+thread_local constinit char thread_marker = 0;
+
+uintptr_t thread_id() noexcept {
+  return reinterpret_cast<uintptr_t>(&thread_marker);
+}
+
+uint64_t monotonic_ns() noexcept {
+  timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000ULL +
+         static_cast<uint64_t>(now.tv_nsec);
+}
+
+}  // namespace
+
+void SignalSafeReport::write(std::string_view text) noexcept {
+  if (buffer_ == nullptr) [[unlikely]] {
+    panic_sink::write_all(text.data(), text.size());
+    return;
+  }
+
+  while (!text.empty()) {
+    if (size_ == kSignalReportBufferSize) flush();
+    size_t size = std::min(text.size(), kSignalReportBufferSize - size_);
+    std::memcpy(buffer_ + size_, text.data(), size);
+    size_ += size;
+    text.remove_prefix(size);
+  }
+}
+
+void SignalSafeReport::flush() noexcept {
+  panic_sink::write_all(buffer_, size_);
+  size_ = 0;
+}
+
+void SignalSafeReport::finish() noexcept {
+  if (buffer_ != nullptr) {
+    flush();
+    buffer_ = nullptr;
+    report_buffer_held.store(false, std::memory_order_release);
+  }
+
+  // fails if a report took over from this one, the turn is already past it
+  uint64_t ticket = ticket_;
+  if (now_serving.load(std::memory_order_relaxed) == ticket) {
+    uintptr_t owner = thread_id();
+    turn_owner.compare_exchange_strong(owner, 0, std::memory_order_relaxed);
+  }
+  now_serving.compare_exchange_strong(ticket, ticket + 1,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed);
+}
+
+STX_EXPORT SignalSafeReport begin_signal_report() noexcept {
+  uint64_t const ticket = next_ticket.fetch_add(1, std::memory_order_relaxed);
+  uintptr_t const self = thread_id();
+
+  // the report being written may never finish, i.e. if its thread is the one
+  // interrupted by this signal handler, so it is taken over once it made no
+  // progress for the wait, or at once if it is this thread's. The wait is
+  // longer the further back in line the report is, so that the next report
+  // is the one that takes over.
+  uint64_t serving = now_serving.load(std::memory_order_acquire);
+  uint64_t deadline = 0;
+  uint32_t spins = 0;
+  bool has_turn = true;
+  while (serving != ticket) {
+    if (serving > ticket) {
+      // a report behind this one took over, this one is written out of turn
+      has_turn = false;
+      break;
+    }
+
+    bool const interrupted =
+        turn_owner.load(std::memory_order_relaxed) == self;
+    if (!interrupted && spins < kSignalReportSpins) {
+      spin_pause();
+      spins++;
+    } else {
+      uint64_t now = monotonic_ns();
+      if (deadline == 0) {
+        deadline = now + kSignalReportWaitNs * (ticket - serving);
+      }
+      if (interrupted || now >= deadline) {
+        if (now_serving.compare_exchange_strong(serving, ticket,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_acquire)) {
+          break;
+        }
+        // the turn moved on, `serving` is the new one
+        deadline = 0;
+        spins = 0;
+        continue;
+      }
+      timespec sleep{0, kSignalReportSleepNs};
+      nanosleep(&sleep, nullptr);
+    }
+
+    uint64_t current = now_serving.load(std::memory_order_acquire);
+    if (current != serving) {
+      serving = current;
+      deadline = 0;
+      spins = 0;
+    }
+  }
+
+  if (has_turn) turn_owner.store(self, std::memory_order_relaxed);
+
+  bool held = false;
+  bool const buffered = report_buffer_held.compare_exchange_strong(
+      held, true, std::memory_order_acquire, std::memory_order_relaxed);
+  return SignalSafeReport{ticket, buffered ? report_buffer : nullptr};
+}
+
+STX_EXPORT void write_signal_safe_panic(
+    SignalSafeReport& report, std::string_view info,
+    SourceLocation const& location) noexcept {
+  report.write("\nthread panicked in a signal-safe context with: '");
+  panic_util::write_panic_message(report, info, ReportPayload(), location);
+
+  // reading the thread's own ring is async-signal-safe
+  flight_recorder::write_recent_events(report);
+}
+
+}  // namespace signal_safe
+}  // namespace internal
+}  // namespace stx
+
+[[noreturn]] STX_EXPORT void stx::panic_signal_safe(
+    std::string_view info, SourceLocation location) noexcept {
+  using namespace internal::signal_safe;  // NOLINT
+
+  SignalSafeReport report = begin_signal_report();
+  write_signal_safe_panic(report, info, location);
+  report.finish();
+  std::abort();
+}
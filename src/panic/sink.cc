@@ -0,0 +1,215 @@
+/**
+ * @file sink.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-22
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/panic/sink.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include "stx/panic/handlers/default/default.h"
+
+namespace stx {
+namespace {
+
+using internal::panic_util::stderr_lock;
+
+// the sink is configured with `stderr_lock` held, so a report is never written
+// to a half-configured sink. The fd is also read by the signal-safe panic
+// path, which does not take the lock.
+std::atomic<int> sink_fd{STDERR_FILENO};
+std::atomic<PanicSinkKind> sink_kind{PanicSinkKind::Stderr};
+std::atomic<uint64_t> dropped_writes{0};
+
+// the rotated file, only accessed with `stderr_lock` held
+char file_path[PATH_MAX] = {};
+char rotated_path[PATH_MAX] = {};
+size_t file_max_size = 0;
+uint64_t file_size = 0;
+
+class ConfigLock {
+ public:
+  ConfigLock() noexcept { internal::panic_util::lock_stderr(); }
+
+  ConfigLock(ConfigLock const&) = delete;
+  ConfigLock& operator=(ConfigLock const&) = delete;
+
+  ~ConfigLock() noexcept { stderr_lock.clear(std::memory_order_release); }
+};
+
+bool set_nonblocking(int fd) noexcept {
+  int flags = fcntl(fd, F_GETFL);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// closes the fd of the current sink if the sink opened it, the lock is held
+void release_sink() noexcept {
+  PanicSinkKind kind = sink_kind.load(std::memory_order_relaxed);
+  if (kind == PanicSinkKind::File || kind == PanicSinkKind::Socket) {
+    ::close(sink_fd.load(std::memory_order_relaxed));
+  }
+  sink_fd.store(STDERR_FILENO, std::memory_order_release);
+  sink_kind.store(PanicSinkKind::Stderr, std::memory_order_release);
+  file_max_size = 0;
+}
+
+void install_sink(int fd, PanicSinkKind kind) noexcept {
+  release_sink();
+  sink_fd.store(fd, std::memory_order_release);
+  sink_kind.store(kind, std::memory_order_release);
+}
+
+int open_file(char const* path) noexcept {
+  return ::open(path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC | O_NONBLOCK,
+                0644);
+}
+
+// renames the full file and continues in a new one. The new file replaces the
+// sink's fd with `dup2`, so the signal-safe path never sees a closed fd.
+void rotate_file() noexcept {
+  file_size = 0;
+  if (::rename(file_path, rotated_path) != 0) return;
+  int fd = open_file(file_path);
+  if (fd < 0) return;
+  ::dup2(fd, sink_fd.load(std::memory_order_relaxed));
+  ::close(fd);
+}
+
+void count_dropped() noexcept {
+  dropped_writes.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace
+}  // namespace stx
+
+STX_EXPORT bool stx::set_panic_sink_fd(int fd) noexcept {
+  if (fd < 0 || !set_nonblocking(fd)) return false;
+
+  ConfigLock lock;
+  install_sink(fd, PanicSinkKind::Fd);
+  return true;
+}
+
+STX_EXPORT bool stx::open_panic_sink_file(char const* path,
+                                          size_t max_size) noexcept {
+  if (path == nullptr) return false;
+  size_t length = std::strlen(path);
+  // room for the rotated file's ".1" suffix
+  if (length + 3 > PATH_MAX) return false;
+
+  int fd = open_file(path);
+  if (fd < 0) return false;
+
+  struct stat status {};
+  if (fstat(fd, &status) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  ConfigLock lock;
+  install_sink(fd, PanicSinkKind::File);
+  std::memcpy(file_path, path, length + 1);
+  std::memcpy(rotated_path, path, length);
+  std::memcpy(rotated_path + length, ".1", 3);
+  file_max_size = max_size;
+  file_size = static_cast<uint64_t>(status.st_size);
+  return true;
+}
+
+STX_EXPORT bool stx::connect_panic_sink_socket(char const* path) noexcept {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path == nullptr || std::strlen(path) >= sizeof(address.sun_path)) {
+    return false;
+  }
+  std::strcpy(address.sun_path, path);
+
+  int fd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+  if (fd < 0) return false;
+
+  if (fcntl(fd, F_SETFD, FD_CLOEXEC) != 0 || !set_nonblocking(fd) ||
+      ::connect(fd, reinterpret_cast<sockaddr const*>(&address),
+                sizeof(address)) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  ConfigLock lock;
+  install_sink(fd, PanicSinkKind::Socket);
+  return true;
+}
+
+STX_EXPORT void stx::reset_panic_sink() noexcept {
+  ConfigLock lock;
+  release_sink();
+}
+
+STX_EXPORT stx::PanicSinkKind stx::panic_sink_kind() noexcept {
+  return sink_kind.load(std::memory_order_acquire);
+}
+
+STX_EXPORT uint64_t stx::panic_sink_dropped() noexcept {
+  return dropped_writes.load(std::memory_order_relaxed);
+}
+
+STX_EXPORT void stx::internal::panic_sink::write_segments(iovec* iov,
+                                                          int num) noexcept {
+  if (file_max_size != 0 && file_size >= file_max_size) rotate_file();
+
+  int fd = sink_fd.load(std::memory_order_acquire);
+  iovec* next = iov;
+  int left = num;
+  while (left > 0) {
+    ssize_t written = ::writev(fd, next, left);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      // the sink is full (`EAGAIN`) or gone, the rest of the report is
+      // dropped rather than waited for
+      count_dropped();
+      return;
+    }
+    file_size += static_cast<uint64_t>(written);
+
+    // resume after a partial write
+    auto size = static_cast<size_t>(written);
+    while (left > 0 && size >= next->iov_len) {
+      size -= next->iov_len;
+      next++;
+      left--;
+    }
+    if (left > 0) {
+      next->iov_base = static_cast<char*>(next->iov_base) + size;
+      next->iov_len -= size;
+    }
+  }
+}
+
+STX_EXPORT void stx::internal::panic_sink::write_all(char const* data,
+                                                     size_t size) noexcept {
+  int fd = sink_fd.load(std::memory_order_acquire);
+  while (size != 0) {
+    ssize_t written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      count_dropped();
+      return;
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+}
@@ -0,0 +1,144 @@
+/**
+ * @file parse.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-09
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/parse.h"
+
+#if CFG(ARCH, X86_64)
+#include <immintrin.h>
+#define STX_PARSE_AVX2 1
+#else
+#define STX_PARSE_AVX2 0
+#endif
+
+#if CFG(ARCH, ARM64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define STX_PARSE_NEON 1
+#else
+#define STX_PARSE_NEON 0
+#endif
+
+namespace stx {
+namespace internal {
+namespace parse {
+namespace {
+
+// `field_start` is true if the character before `text` is a delimiter or
+// `text` is at the start of the column.
+bool is_integer_column_scalar(std::string_view text, char delimiter,
+                              bool allow_minus, bool field_start) noexcept {
+  for (char c : text) {
+    if (c == delimiter) {
+      field_start = true;
+      continue;
+    }
+    if (!((c >= '0' && c <= '9') || (allow_minus && field_start && c == '-')))
+      return false;
+    field_start = false;
+  }
+  return true;
+}
+
+#if STX_PARSE_AVX2
+
+bool has_avx2() noexcept {
+  static bool const supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+// classifies 32 bytes at a time into bitmasks of delimiters, digits and minus
+// signs. a minus sign is only valid if the previous byte is a delimiter, which
+// is checked by shifting the delimiter mask and carrying its top bit over to
+// the next block.
+__attribute__((target("avx2"))) bool is_integer_column_avx2(
+    std::string_view text, char delimiter, bool allow_minus) noexcept {
+  __m256i const delimiters = _mm256_set1_epi8(delimiter);
+  __m256i const zeros = _mm256_set1_epi8('0');
+  __m256i const nines = _mm256_set1_epi8(9);
+  __m256i const minuses = _mm256_set1_epi8('-');
+
+  uint32_t carry = 1;
+  size_t i = 0;
+  for (; i + 32 <= text.size(); i += 32) {
+    __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(text.data() + i));
+    __m256i offset = _mm256_sub_epi8(x, zeros);
+    auto delimiter_mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, delimiters)));
+    auto digit_mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_min_epu8(offset, nines), offset)));
+    uint32_t valid = delimiter_mask | digit_mask;
+
+    if (allow_minus) {
+      auto minus_mask = static_cast<uint32_t>(
+          _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, minuses)));
+      uint32_t field_starts = (delimiter_mask << 1) | carry;
+      valid |= minus_mask & field_starts;
+    }
+
+    if (valid != UINT32_MAX) return false;
+    carry = delimiter_mask >> 31;
+  }
+
+  return is_integer_column_scalar(text.substr(i), delimiter, allow_minus,
+                                  carry != 0);
+}
+
+#endif
+
+#if STX_PARSE_NEON
+
+// compares each byte with the byte before it (via `vextq_u8`) to check that
+// minus signs only appear at the start of a field.
+bool is_integer_column_neon(std::string_view text, char delimiter,
+                            bool allow_minus) noexcept {
+  uint8x16_t const delimiters = vdupq_n_u8(static_cast<uint8_t>(delimiter));
+  uint8x16_t const zeros = vdupq_n_u8('0');
+  uint8x16_t const nines = vdupq_n_u8(9);
+  uint8x16_t const minuses = vdupq_n_u8(allow_minus ? '-' : delimiter);
+
+  uint8x16_t previous = delimiters;
+  size_t i = 0;
+  for (; i + 16 <= text.size(); i += 16) {
+    uint8x16_t x = vld1q_u8(reinterpret_cast<uint8_t const*>(text.data() + i));
+    uint8x16_t before = vextq_u8(previous, x, 15);
+    uint8x16_t is_delimiter = vceqq_u8(x, delimiters);
+    uint8x16_t is_digit = vcleq_u8(vsubq_u8(x, zeros), nines);
+    uint8x16_t is_field_minus =
+        vandq_u8(vceqq_u8(x, minuses), vceqq_u8(before, delimiters));
+    uint8x16_t valid =
+        vorrq_u8(vorrq_u8(is_delimiter, is_digit), is_field_minus);
+    if (vminvq_u8(valid) == 0) return false;
+    previous = x;
+  }
+
+  return is_integer_column_scalar(text.substr(i), delimiter, allow_minus,
+                                  i == 0 || text[i - 1] == delimiter);
+}
+
+#endif
+
+}  // namespace
+
+bool is_integer_column(std::string_view text, char delimiter,
+                       bool allow_minus) noexcept {
+#if STX_PARSE_AVX2
+  if (has_avx2()) return is_integer_column_avx2(text, delimiter, allow_minus);
+#endif
+#if STX_PARSE_NEON
+  return is_integer_column_neon(text, delimiter, allow_minus);
+#else
+  return is_integer_column_scalar(text, delimiter, allow_minus, true);
+#endif
+}
+
+}  // namespace parse
+}  // namespace internal
+}  // namespace stx
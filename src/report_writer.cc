@@ -0,0 +1,82 @@
+/**
+ * @file report_writer.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-11
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/report_writer.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#if CFG(OS, POSIX)
+#include <unistd.h>
+#endif
+
+namespace stx {
+
+#if CFG(OS, POSIX)
+
+namespace {
+
+void write_all(int fd, char const* data, size_t size) noexcept {
+  while (size != 0) {
+    ssize_t written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+}
+
+}  // namespace
+
+void FdReportWriter::write(std::string_view text) noexcept {
+  if (text.size() > kBufferSize - size_) {
+    flush();
+    // too large to be worth buffering
+    if (text.size() >= kBufferSize) {
+      write_all(fd_, text.data(), text.size());
+      return;
+    }
+  }
+  std::memcpy(buffer_ + size_, text.data(), text.size());
+  size_ += text.size();
+}
+
+void FdReportWriter::flush() noexcept {
+  write_all(fd_, buffer_, size_);
+  size_ = 0;
+}
+
+#endif
+
+ArenaReportWriter::~ArenaReportWriter() noexcept { std::free(data_); }
+
+void ArenaReportWriter::write(std::string_view text) noexcept {
+  if (text.size() > capacity_ - size_) {
+    size_t capacity = capacity_ == 0 ? 256 : capacity_;
+    while (capacity - size_ < text.size()) capacity *= 2;
+
+    auto* data = static_cast<char*>(std::realloc(data_, capacity));
+    if (data == nullptr) {
+      truncated_ = true;
+      text = text.substr(0, capacity_ - size_);
+    } else {
+      data_ = data;
+      capacity_ = capacity;
+    }
+  }
+  if (!text.empty()) std::memcpy(data_ + size_, text.data(), text.size());
+  size_ += text.size();
+}
+
+};  // namespace stx
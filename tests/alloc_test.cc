@@ -0,0 +1,186 @@
+/**
+ * @file alloc_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/alloc.h"
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace stx;
+
+namespace {
+
+// large allocations are not made to run out of memory, sanitizers abort on
+// them instead of failing them
+
+struct Unallocatable {
+  static void* operator new(size_t, std::nothrow_t const&) noexcept {
+    return nullptr;
+  }
+  static void operator delete(void*) noexcept {}
+};
+
+bool allocations_fail = false;
+
+// an allocator that throws `std::bad_alloc` while `allocations_fail` is set
+template <typename T>
+struct FailingAllocator {
+  using value_type = T;
+
+  FailingAllocator() = default;
+
+  template <typename U>
+  FailingAllocator(FailingAllocator<U> const&) noexcept {}
+
+  T* allocate(size_t n) {
+    if (allocations_fail) throw std::bad_alloc{};
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* pointer, size_t n) noexcept {
+    std::allocator<T>{}.deallocate(pointer, n);
+  }
+
+  template <typename U>
+  bool operator==(FailingAllocator<U> const&) const noexcept {
+    return true;
+  }
+};
+
+class OutOfMemory {
+ public:
+  OutOfMemory() noexcept { allocations_fail = true; }
+  OutOfMemory(OutOfMemory const&) = delete;
+  OutOfMemory& operator=(OutOfMemory const&) = delete;
+  ~OutOfMemory() noexcept { allocations_fail = false; }
+};
+
+template <typename T>
+using FailingVector =
+    std::vector<T, FallibleAllocator<T, FailingAllocator<T>>>;
+
+struct alignas(64) Aligned {
+  int value;
+};
+
+}  // namespace
+
+TEST(AllocTest, TryMakeUnique) {
+  auto value = try_make_unique<std::string>(3, 'x');
+  ASSERT_TRUE(value.is_ok());
+  EXPECT_EQ(*std::move(value).unwrap(), "xxx");
+
+  EXPECT_EQ(try_make_unique<Unallocatable>().unwrap_err(),
+            AllocError::OutOfMemory);
+}
+
+TEST(AllocTest, TryReserve) {
+  FailingVector<int> vector{1, 2, 3};
+  EXPECT_EQ(try_reserve(vector, 64), Ok(Unit{}));
+  EXPECT_GE(vector.capacity(), 64);
+  EXPECT_EQ(vector, (FailingVector<int>{1, 2, 3}));
+
+  EXPECT_EQ(try_reserve(vector, vector.max_size() + 1),
+            Err(AllocError::CapacityOverflow));
+  {
+    OutOfMemory out_of_memory;
+    EXPECT_EQ(try_reserve(vector, 128), Err(AllocError::OutOfMemory));
+  }
+  EXPECT_EQ(vector.size(), 3);
+  EXPECT_GE(vector.capacity(), 64);
+
+  std::vector<int, FallibleAllocator<int>> default_vector;
+  EXPECT_EQ(try_reserve(default_vector, 64), Ok(Unit{}));
+  EXPECT_EQ(try_reserve(default_vector, default_vector.max_size() + 1),
+            Err(AllocError::CapacityOverflow));
+
+  // any allocator
+  std::vector<int, FailingAllocator<int>> other_vector;
+  EXPECT_EQ(try_reserve(other_vector, 64), Ok(Unit{}));
+  OutOfMemory out_of_memory;
+  EXPECT_EQ(try_reserve(other_vector, 128), Err(AllocError::OutOfMemory));
+}
+
+TEST(AllocTest, TryPushBack) {
+  std::vector<std::string, FallibleAllocator<std::string>> vector;
+  std::string value = "value";
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(try_push_back(vector, value), Ok(Unit{}));
+    ASSERT_EQ(try_push_back(vector, std::string("moved")), Ok(Unit{}));
+  }
+  EXPECT_EQ(vector.size(), 200);
+  EXPECT_EQ(vector[198], "value");
+  EXPECT_EQ(vector[199], "moved");
+
+  // the value converts to the element type
+  std::vector<long> longs;
+  EXPECT_EQ(try_push_back(longs, 42), Ok(Unit{}));
+  std::vector<std::string> strings;
+  EXPECT_EQ(try_push_back(strings, "abc"), Ok(Unit{}));
+  EXPECT_EQ(strings.back(), "abc");
+
+  FailingVector<std::string> full;
+  ASSERT_EQ(try_push_back(full, "x"), Ok(Unit{}));
+  {
+    OutOfMemory out_of_memory;
+    EXPECT_EQ(try_push_back(full, "y"), Err(AllocError::OutOfMemory));
+  }
+  EXPECT_EQ(full, FailingVector<std::string>{"x"});
+}
+
+TEST(AllocTest, TryPushBackElement) {
+  // longer than the small-string buffer, so growing frees them
+  std::string const first(64, 'a');
+  std::string const second(64, 'b');
+
+  std::vector<std::string, FallibleAllocator<std::string>> vector{first,
+                                                                  second};
+  vector.shrink_to_fit();
+  ASSERT_EQ(vector.size(), vector.capacity());
+  ASSERT_EQ(try_push_back(vector, vector[0]), Ok(Unit{}));
+  EXPECT_EQ(vector[2], first);
+
+  vector.shrink_to_fit();
+  ASSERT_EQ(vector.size(), vector.capacity());
+  ASSERT_EQ(try_push_back(vector, std::move(vector[1])), Ok(Unit{}));
+  EXPECT_EQ(vector[3], second);
+}
+
+TEST(AllocTest, FallibleAllocator) {
+  FallibleAllocator<Aligned> allocator;
+  Aligned* memory = allocator.try_allocate(3).unwrap();
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(memory) % alignof(Aligned), 0);
+  allocator.deallocate(memory, 3);
+
+  EXPECT_EQ(allocator.try_allocate(SIZE_MAX).unwrap_err(),
+            AllocError::CapacityOverflow);
+  EXPECT_EQ(allocator, FallibleAllocator<int>{});
+
+  std::vector<Aligned, FallibleAllocator<Aligned>> vector(10, Aligned{7});
+  EXPECT_EQ(vector[9].value, 7);
+
+  // the inner allocator is rebound with it
+  static_assert(
+      std::is_same_v<std::allocator_traits<FallibleAllocator<
+                         int, FailingAllocator<int>>>::rebind_alloc<char>,
+                     FallibleAllocator<char, FailingAllocator<char>>>);
+
+  FallibleAllocator<int, FailingAllocator<int>> failing;
+  OutOfMemory out_of_memory;
+  EXPECT_EQ(failing.try_allocate(1).unwrap_err(), AllocError::OutOfMemory);
+}
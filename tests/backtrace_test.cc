@@ -2,6 +2,8 @@
 
 #include "stx/backtrace.h"
 
+#include <signal.h>
+
 #include "gtest/gtest.h"
 #include "stx/option.h"
 #include "stx/panic.h"
@@ -34,3 +36,29 @@ using namespace stx::backtrace;
 [[gnu::noinline]] void fn_a() { fn_b(); }
 
 TEST(BacktraceTest, Backtrace) { fn_a(); }
+
+[[gnu::noinline]] void faulting_fn(int volatile* address) { *address = 1; }
+
+TEST(BacktraceTest, SignalStartsAtFault) {
+  // the faulting function is the first frame, the unwinder only finds the
+  // frames that called it
+  EXPECT_DEATH(
+      {
+        (void)handle_signal(SIGSEGV);
+        faulting_fn(nullptr);
+      },
+      "Stack Pointer\n\n#[0-9]+\t\tfaulting_fn");
+}
+
+TEST(BacktraceTest, PreviousSigInfoHandler) {
+  struct sigaction action {};
+  action.sa_sigaction = [](int, siginfo_t*, void*) {};
+  action.sa_flags = SA_SIGINFO;
+  sigemptyset(&action.sa_mask);
+  struct sigaction previous {};
+  ASSERT_EQ(sigaction(SIGFPE, &action, &previous), 0);
+
+  EXPECT_EQ(handle_signal(SIGFPE).unwrap(), SIG_DFL);
+
+  sigaction(SIGFPE, &previous, nullptr);
+}
@@ -0,0 +1,143 @@
+/**
+ * @file binary_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-06
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/binary.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+using namespace std::string_view_literals;
+using namespace stx;
+
+namespace {
+
+enum class Color : uint16_t { Red = 1, Blue = 0x0102 };
+
+template <typename T>
+auto round_trip(T const& value) -> Result<T, binary::Error> {
+  alignas(8) std::array<std::byte, 1024> buffer{};
+  size_t size = binary::encode(value, buffer).unwrap();
+  EXPECT_EQ(size, binary::encoded_size(value));
+  return binary::decode<T>(std::span(buffer).first(size));
+}
+
+template <typename... Bytes>
+auto bytes(Bytes... values) {
+  return std::array<std::byte, sizeof...(Bytes)>{
+      static_cast<std::byte>(values)...};
+}
+
+}  // namespace
+
+TEST(BinaryTest, PrimitivesAreLittleEndian) {
+  std::array<std::byte, 8> buffer{};
+
+  EXPECT_EQ(binary::encode(uint32_t{0x01020304}, buffer), Ok(4UL));
+  EXPECT_EQ(std::span(buffer).first(4)[0], std::byte{0x04});
+  EXPECT_EQ(std::span(buffer).first(4)[3], std::byte{0x01});
+
+  EXPECT_EQ(binary::encode(Color::Blue, buffer), Ok(2UL));
+  EXPECT_EQ(buffer[0], std::byte{0x02});
+  EXPECT_EQ(buffer[1], std::byte{0x01});
+
+  EXPECT_EQ(round_trip(int64_t{-5}), Ok(int64_t{-5}));
+  EXPECT_EQ(round_trip(2.5), Ok(2.5));
+  EXPECT_EQ(round_trip(true), Ok(true));
+  EXPECT_EQ(round_trip(Color::Blue), Ok(Color::Blue));
+}
+
+TEST(BinaryTest, OptionLayout) {
+  alignas(8) std::array<std::byte, 16> buffer{};
+
+  Option<int32_t> a = Some(7);
+  EXPECT_EQ(binary::encode(a, buffer), Ok(8UL));
+  EXPECT_TRUE(std::ranges::equal(std::span(buffer).first(8),
+                                 bytes(1, 0, 0, 0, 7, 0, 0, 0)));
+
+  Option<int32_t> b = None;
+  EXPECT_EQ(binary::encode(b, buffer), Ok(1UL));
+  EXPECT_EQ(buffer[0], std::byte{0});
+
+  EXPECT_EQ(round_trip(Option<double>(Some(1.5))).unwrap(), Some(1.5));
+  EXPECT_EQ(round_trip(make_none<double>()).unwrap(), None);
+  Option<Option<uint8_t>> nested = Some(Option(Some(uint8_t{3})));
+  EXPECT_EQ(round_trip(nested).unwrap(), Some(Option(Some(uint8_t{3}))));
+}
+
+TEST(BinaryTest, ResultAndReport) {
+  Result<int64_t, Report> a = Ok(int64_t{42});
+  EXPECT_EQ(binary::encoded_size(a), 16);
+  EXPECT_EQ(round_trip(a).unwrap(), Ok(int64_t{42}));
+
+  Result<int64_t, Report> b = Err(Report("connection reset"sv));
+  EXPECT_EQ(binary::encoded_size(b), 8 + 4 + 16);
+  EXPECT_EQ(round_trip(b).unwrap().unwrap_err().what(), "connection reset"sv);
+
+  Result<Option<uint16_t>, Color> c = Err(Color::Red);
+  EXPECT_EQ(round_trip(c).unwrap(), Err(Color::Red));
+}
+
+TEST(BinaryTest, View) {
+  alignas(8) std::array<std::byte, 64> buffer{};
+
+  Result<int64_t, Report> response = Err(Report("timed out"sv));
+  size_t size = binary::encode(response, buffer).unwrap();
+
+  auto view =
+      binary::view<Result<int64_t, Report>>(std::span(buffer).first(size))
+          .unwrap();
+  EXPECT_TRUE(view.is_err());
+  EXPECT_EQ(view.ok(), None);
+  EXPECT_EQ(view.err(), Some("timed out"sv));
+  // the error is viewed in place
+  EXPECT_EQ(view.err().unwrap().data(),
+            reinterpret_cast<char const*>(buffer.data() + 12));
+
+  Option<Result<uint8_t, double>> nested = Some(make_ok<uint8_t, double>(9));
+  size = binary::encode(nested, buffer).unwrap();
+  auto nested_view =
+      binary::view<Option<Result<uint8_t, double>>>(
+          std::span(buffer).first(size))
+          .unwrap();
+  EXPECT_EQ(nested_view.match(
+                [](auto result) {
+                  return result.match([](uint8_t v) { return int{v}; },
+                                      [](double) { return -1; });
+                },
+                []() { return -2; }),
+            9);
+}
+
+TEST(BinaryTest, Errors) {
+  auto truncated = bytes(1, 0, 0, 0, 7);
+  EXPECT_EQ(binary::decode<Option<int32_t>>(truncated),
+            Err(binary::Error::BufferTooSmall));
+
+  auto bad_tag = bytes(2, 0, 0, 0, 7, 0, 0, 0);
+  EXPECT_EQ(binary::decode<Option<int32_t>>(bad_tag),
+            Err(binary::Error::InvalidTag));
+  EXPECT_EQ((binary::view<Result<int32_t, int32_t>>(bad_tag).is_err()), true);
+
+  auto bad_bool = bytes(1, 5);
+  EXPECT_EQ(binary::decode<Option<bool>>(bad_bool),
+            Err(binary::Error::InvalidValue));
+
+  auto long_report = bytes(200, 0, 0, 0, 'a', 'b');
+  EXPECT_EQ(binary::decode<Report>(long_report).is_err(), true);
+
+  std::array<std::byte, 2> small{};
+  EXPECT_EQ(binary::encode(uint64_t{1}, small),
+            Err(binary::Error::BufferTooSmall));
+}
@@ -0,0 +1,89 @@
+/**
+ * @file catch_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-10
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/catch.h"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+using namespace std::string_view_literals;
+using namespace stx;
+
+namespace {
+
+int parse_or_throw(std::string_view input) {
+  if (input.empty()) throw std::invalid_argument("empty input");
+  if (input.size() > 9) throw std::out_of_range("too many digits");
+  if (input == "boom") throw 42;
+  return static_cast<int>(input.size());
+}
+
+}  // namespace
+
+TEST(CatchTest, SingleError) {
+  auto ok = catch_result<std::invalid_argument>([] {
+    return parse_or_throw("abc");
+  });
+  EXPECT_EQ(ok.is_ok(), true);
+  EXPECT_EQ(std::move(ok).unwrap(), 3);
+
+  auto err = catch_result<std::invalid_argument>([] {
+    return parse_or_throw("");
+  });
+  EXPECT_EQ(std::move(err).unwrap_err().what(), "empty input"sv);
+}
+
+TEST(CatchTest, MultipleErrors) {
+  auto catcher = [](std::string_view input) {
+    return catch_result<std::invalid_argument, std::out_of_range>(
+        [&] { return parse_or_throw(input); });
+  };
+
+  EXPECT_EQ(catcher("ab").is_ok(), true);
+  EXPECT_EQ(catcher("").is_err<std::invalid_argument>(), true);
+  EXPECT_EQ(catcher("0123456789").is_err<std::out_of_range>(), true);
+
+  // not listed, propagates
+  EXPECT_THROW((void)catcher("boom"), int);
+}
+
+TEST(CatchTest, ListedOrder) {
+  // matched in the order listed: the derived type is caught first
+  auto derived = catch_result<std::invalid_argument, std::logic_error>(
+      [] { return parse_or_throw(""); });
+  EXPECT_EQ(derived.is_err<std::invalid_argument>(), true);
+
+  // the base type listed first catches the derived exception
+  auto base = catch_result<std::logic_error, std::invalid_argument>(
+      [] { return parse_or_throw(""); });
+  EXPECT_EQ(base.is_err<std::logic_error>(), true);
+}
+
+TEST(CatchTest, VoidAndNoexcept) {
+  int calls = 0;
+  auto unit = catch_result<std::runtime_error>([&] { calls++; });
+  EXPECT_EQ(unit, Ok(Unit{}));
+  EXPECT_EQ(calls, 1);
+
+  auto thrown = catch_result<std::runtime_error>(
+      [] { throw std::runtime_error("failed"); });
+  EXPECT_EQ(thrown.is_err(), true);
+
+  auto nothrow = [] () noexcept { return std::string("fast"); };
+  static_assert(noexcept(catch_result<std::runtime_error>(nothrow)));
+  static_assert(!noexcept(catch_result<std::runtime_error>(
+      [] { return parse_or_throw("a"); })));
+  EXPECT_EQ(catch_result<std::runtime_error>(nothrow),
+            Ok(std::string("fast")));
+}
@@ -0,0 +1,166 @@
+/**
+ * @file checked_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/checked.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace stx;
+
+TEST(CheckedTest, AddSubMul) {
+  EXPECT_EQ(checked_add<int8_t>(100, 27), Some<int8_t>(127));
+  EXPECT_EQ(checked_add<int8_t>(100, 28), None);
+  EXPECT_EQ(checked_add<int8_t>(-100, -28), Some<int8_t>(-128));
+  EXPECT_EQ(checked_add<int8_t>(-100, -29), None);
+  EXPECT_EQ(checked_add<uint64_t>(UINT64_MAX, 1), None);
+
+  EXPECT_EQ(checked_sub<uint32_t>(1, 1), Some<uint32_t>(0));
+  EXPECT_EQ(checked_sub<uint32_t>(1, 2), None);
+  EXPECT_EQ(checked_sub<int32_t>(INT32_MIN, 1), None);
+
+  EXPECT_EQ(checked_mul<int16_t>(-128, 256), Some<int16_t>(-32768));
+  EXPECT_EQ(checked_mul<int16_t>(128, 256), None);
+  EXPECT_EQ(checked_mul<int64_t>(INT64_MIN, -1), None);
+
+  static_assert(checked_add<int32_t>(1, 2).unwrap_or(0) == 3);
+}
+
+TEST(CheckedTest, Div) {
+  EXPECT_EQ(checked_div(7, 2), Ok(3));
+  EXPECT_EQ(checked_div(-7, 2), Ok(-3));
+  EXPECT_EQ(checked_div(7, 0), Err(ArithError::DivisionByZero));
+  EXPECT_EQ(checked_div(INT32_MIN, -1), Err(ArithError::Overflow));
+  EXPECT_EQ(checked_div<uint8_t>(255, 255), Ok<uint8_t>(1));
+}
+
+TEST(CheckedTest, Shl) {
+  EXPECT_EQ(checked_shl<uint8_t>(1, 7), Some<uint8_t>(128));
+  EXPECT_EQ(checked_shl<uint8_t>(2, 7), None);
+  EXPECT_EQ(checked_shl<uint8_t>(0, 8), None);
+  EXPECT_EQ(checked_shl<int8_t>(1, 6), Some<int8_t>(64));
+  EXPECT_EQ(checked_shl<int8_t>(1, 7), None);
+  EXPECT_EQ(checked_shl<int8_t>(-1, 7), Some<int8_t>(-128));
+  EXPECT_EQ(checked_shl<int64_t>(3, 61), Some(int64_t{3} << 61));
+  EXPECT_EQ(checked_shl<int64_t>(3, 62), None);
+}
+
+TEST(CheckedTest, Cast) {
+  EXPECT_EQ(checked_cast<uint8_t>(255), Some<uint8_t>(255));
+  EXPECT_EQ(checked_cast<uint8_t>(256), None);
+  EXPECT_EQ(checked_cast<uint32_t>(-1), None);
+  EXPECT_EQ(checked_cast<int32_t>(UINT32_MAX), None);
+  EXPECT_EQ(checked_cast<int64_t>(UINT32_MAX), Some<int64_t>(UINT32_MAX));
+  EXPECT_EQ(checked_cast<int8_t>(int64_t{-128}), Some<int8_t>(-128));
+}
+
+TEST(CheckedTest, Sum) {
+  std::vector<int32_t> empty;
+  EXPECT_EQ(checked_sum(empty), Ok(0));
+
+  // spans several blocks with a tail
+  std::vector<int32_t> values(1000);
+  std::iota(values.begin(), values.end(), -400);
+  EXPECT_EQ(checked_sum(values),
+            Ok(std::accumulate(values.begin(), values.end(), 0)));
+
+  // a large term that cancels out within a block does not overflow
+  values.assign(300, 0);
+  values[100] = INT32_MAX;
+  values[101] = INT32_MIN;
+  EXPECT_EQ(checked_sum(values), Ok(-1));
+
+  values.assign(300, INT32_MAX / 256);
+  EXPECT_EQ(checked_sum(values),
+            Err(ArithErrorAt{ArithError::Overflow, 256}));
+
+  values.assign(299, -1);
+  values.push_back(INT32_MIN);
+  EXPECT_EQ(checked_sum(values),
+            Err(ArithErrorAt{ArithError::Overflow, 299}));
+
+  std::vector<int64_t> large(517, INT64_MAX / 1024);
+  large[3] = -large[3];
+  EXPECT_EQ(checked_sum(large), Ok(INT64_MAX / 1024 * 515));
+  large.push_back(INT64_MAX / 1024 * 600);
+  EXPECT_EQ(checked_sum(large),
+            Err(ArithErrorAt{ArithError::Overflow, 517}));
+}
+
+TEST(CheckedTest, Dot) {
+  std::vector<int32_t> a(200, 3);
+  std::vector<int32_t> b(250, -7);
+  EXPECT_EQ(checked_dot(a, b), Ok(200 * -21));
+
+  a[150] = 1 << 16;
+  b[150] = 1 << 15;
+  EXPECT_EQ(checked_dot(a, b),
+            Err(ArithErrorAt{ArithError::Overflow, 150}));
+
+  std::vector<int64_t> c(130, int64_t{1} << 20);
+  std::vector<int64_t> d(130, int64_t{1} << 20);
+  EXPECT_EQ(checked_dot(c, d), Ok(int64_t{130} << 40));
+  c.assign(100, int64_t{1} << 31);
+  d.assign(100, int64_t{1} << 31);
+  EXPECT_EQ(checked_dot(c, d), Err(ArithErrorAt{ArithError::Overflow, 1}));
+
+  std::vector<int64_t> e(70, 5);
+  std::vector<int64_t> f(70, -9);
+  EXPECT_EQ(checked_dot(e, f), Ok(int64_t{70 * -45}));
+}
+
+TEST(CheckedTest, DivideEach) {
+  std::vector<int32_t> num(100, 9);
+  std::vector<int32_t> den(100, 2);
+  std::vector<int32_t> out(120, 0);
+  EXPECT_EQ(checked_divide_each(num, den, out).unwrap().size(), 100);
+  EXPECT_EQ(out[99], 4);
+  EXPECT_EQ(out[100], 0);
+
+  den[77] = 0;
+  out.assign(100, 0);
+  EXPECT_EQ(checked_divide_each(num, den, out).unwrap_err(),
+            (ArithErrorAt{ArithError::DivisionByZero, 77}));
+  EXPECT_EQ(out[76], 4);
+  EXPECT_EQ(out[77], 0);
+
+  den[77] = -1;
+  num[70] = INT32_MIN;
+  den[70] = -1;
+  EXPECT_EQ(checked_divide_each(num, den, out).unwrap_err(),
+            (ArithErrorAt{ArithError::Overflow, 70}));
+
+  std::vector<int64_t> lnum(9, INT64_MIN);
+  std::vector<int64_t> lden(9, 2);
+  std::vector<int64_t> lout(9);
+  lden[8] = -1;
+  EXPECT_EQ(checked_divide_each(lnum, lden, lout).unwrap_err(),
+            (ArithErrorAt{ArithError::Overflow, 8}));
+  EXPECT_EQ(lout[7], INT64_MIN / 2);
+
+  std::array<double, 3> dnum{1.0, 2.0, 3.0};
+  std::array<double, 3> dden{2.0, 0.0, 1.0};
+  std::array<double, 3> dout{};
+  EXPECT_EQ(checked_divide_each(dnum, dden, dout).unwrap_err(),
+            (ArithErrorAt{ArithError::DivisionByZero, 1}));
+  EXPECT_EQ(dout[0], 0.5);
+
+  std::vector<double> vnum(67, 1.0);
+  std::vector<double> vden(67, 4.0);
+  std::vector<double> vout(67);
+  EXPECT_EQ(checked_divide_each(vnum, vden, vout).unwrap().size(), 67);
+  EXPECT_EQ(vout[66], 0.25);
+}
@@ -0,0 +1,165 @@
+/**
+ * @file enum_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-04
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/enum.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std::string_literals;
+using namespace stx;
+
+static_assert(sizeof(Enum<int32_t, float>) == 8);
+static_assert(sizeof(Enum<char, uint8_t, bool>) == 2);
+static_assert(std::is_same_v<Enum<int, float>::index_type, uint8_t>);
+static_assert(std::is_trivially_copyable_v<Enum<int, float, double>>);
+static_assert(std::is_trivially_destructible_v<Enum<int, float, double>>);
+static_assert(!std::is_trivially_destructible_v<Enum<int, std::string>>);
+static_assert(!std::is_copy_constructible_v<Enum<int, std::string>>);
+static_assert(std::is_nothrow_move_constructible_v<Enum<int, std::string>>);
+
+// an lvalue can't implicitly be moved into the `Enum`
+static_assert(!std::is_constructible_v<Enum<int, std::string>, std::string&>);
+
+namespace {
+
+struct Ping {
+  int seq;
+};
+
+struct Data {
+  std::string payload;
+};
+
+struct Close {};
+
+using Message = Enum<Ping, Data, Close>;
+
+struct Counted {
+  explicit Counted(int* count) : count_{count} {}
+  Counted(Counted&& other) noexcept : count_{other.count_} {
+    other.count_ = nullptr;
+  }
+  Counted& operator=(Counted&&) = delete;
+  ~Counted() {
+    if (count_ != nullptr) (*count_)++;
+  }
+
+  int* count_;
+};
+
+template <size_t I>
+struct Alt {
+  int value;
+};
+
+template <size_t... I>
+auto make_wide(std::index_sequence<I...>) -> Enum<Alt<I>...>;
+
+template <size_t... I>
+auto sum_wide(Enum<Alt<I>...> const& e, std::index_sequence<I...>) {
+  return e.match([](Alt<I> const& alt) { return alt.value + int{I}; }...);
+}
+
+}  // namespace
+
+TEST(EnumTest, Construction) {
+  Message a = Ping{5};
+  EXPECT_EQ(a.index(), 0);
+  EXPECT_TRUE(a.is<Ping>());
+  EXPECT_FALSE(a.is<Data>());
+
+  Message b = Data{"hello"s};
+  EXPECT_EQ(b.index(), 1);
+  EXPECT_TRUE(b.is<Data>());
+
+  Enum<int, std::string> c{std::in_place_index<1>, 3, 'x'};
+  EXPECT_EQ(c.get<std::string>().unwrap().get(), "xxx"s);
+  EXPECT_TRUE(c.get<int>().is_none());
+}
+
+TEST(EnumTest, Get) {
+  Enum<int, std::string> x = "hello"s;
+  x.get<std::string>().unwrap().get() = "bye"s;
+
+  auto const& cx = x;
+  EXPECT_EQ(cx.get<std::string>().unwrap().get(), "bye"s);
+  EXPECT_TRUE(cx.get<int>().is_none());
+}
+
+TEST(EnumTest, Match) {
+  Message msg = Data{"hello"s};
+
+  auto size = std::move(msg).match([](Ping) { return size_t{0}; },
+                                   [](Data d) { return d.payload.size(); },
+                                   [](Close) { return size_t{0}; });
+  EXPECT_EQ(size, 5);
+
+  Message const ping = Ping{42};
+  EXPECT_EQ(ping.match([](Ping const& p) { return p.seq; },
+                       [](Data const&) { return -1; },
+                       [](Close const&) { return -2; }),
+            42);
+
+  int closed = 0;
+  Message close = Close{};
+  std::move(close).match([](Ping) {}, [](Data) {}, [&](Close) { closed++; });
+  EXPECT_EQ(closed, 1);
+}
+
+TEST(EnumTest, WideMatch) {
+  constexpr auto seq = std::make_index_sequence<40>{};
+  using Wide = decltype(make_wide(seq));
+  static_assert(sizeof(Wide) == 8);
+
+  Wide a{std::in_place_index<3>, 10};
+  EXPECT_EQ(sum_wide(a, seq), 13);
+
+  Wide b{std::in_place_index<37>, 1};
+  EXPECT_EQ(sum_wide(b, seq), 38);
+
+  a = std::move(b);
+  EXPECT_EQ(a.index(), 37);
+}
+
+TEST(EnumTest, MoveAndDestroy) {
+  int destroyed = 0;
+  {
+    Enum<int, Counted> a{std::in_place_index<1>, &destroyed};
+    Enum<int, Counted> b = std::move(a);
+    EXPECT_EQ(destroyed, 0);
+
+    b = Enum<int, Counted>{0};
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_TRUE(b.is<int>());
+  }
+  EXPECT_EQ(destroyed, 1);
+
+  std::vector<Enum<int, std::unique_ptr<int>>> v;
+  v.push_back(std::make_unique<int>(4));
+  v.push_back(9);
+  v.pop_back();
+  EXPECT_EQ(*v[0].get<std::unique_ptr<int>>().unwrap().get(), 4);
+}
+
+TEST(EnumTest, EqualityAndClone) {
+  Enum<int, std::string> a = "a"s;
+  Enum<int, std::string> b = a.clone();
+  EXPECT_EQ(a, b);
+
+  b = Enum<int, std::string>{1};
+  EXPECT_NE(a, b);
+  EXPECT_EQ(b, (Enum<int, std::string>{1}));
+}
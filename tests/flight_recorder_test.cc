@@ -0,0 +1,88 @@
+/**
+ * @file flight_recorder_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-19
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/flight_recorder.h"
+
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std::string_view_literals;
+using namespace stx;
+
+namespace {
+
+std::vector<FlightEvent> recent(size_t max) {
+  std::vector<FlightEvent> events;
+  this_thread::flight_recorder().for_each_recent(
+      max, [&](FlightEvent const& event) { events.push_back(event); });
+  return events;
+}
+
+}  // namespace
+
+TEST(FlightRecorderTest, Record) {
+  this_thread::flight_recorder().clear();
+
+  {
+    FlightSpan span{"request", 7};
+    this_thread::record_event("parsed", 42);
+  }
+
+  std::vector<FlightEvent> events = recent(8);
+  ASSERT_EQ(events.size(), 3);
+
+  EXPECT_EQ(events[0].kind, FlightEventKind::SpanBegin);
+  EXPECT_EQ(events[0].name, "request"sv);
+  EXPECT_EQ(events[0].value, 7);
+  EXPECT_EQ(events[1].kind, FlightEventKind::Event);
+  EXPECT_EQ(events[1].name, "parsed"sv);
+  EXPECT_EQ(events[1].value, 42);
+  EXPECT_EQ(events[2].kind, FlightEventKind::SpanEnd);
+  EXPECT_EQ(events[2].name, "request"sv);
+
+  EXPECT_LE(events[0].timestamp, events[1].timestamp);
+  EXPECT_LE(events[1].timestamp, events[2].timestamp);
+}
+
+TEST(FlightRecorderTest, Wraps) {
+  this_thread::flight_recorder().clear();
+
+  for (uint64_t i = 0; i < kFlightRecorderCapacity + 10; i++) {
+    this_thread::record_event("tick", i);
+  }
+
+  EXPECT_EQ(this_thread::flight_recorder().count(),
+            kFlightRecorderCapacity + 10);
+
+  std::vector<FlightEvent> events = recent(kFlightRecorderCapacity * 2);
+  ASSERT_EQ(events.size(), kFlightRecorderCapacity);
+  EXPECT_EQ(events.front().value, 10);
+  EXPECT_EQ(events.back().value, kFlightRecorderCapacity + 9);
+
+  events = recent(2);
+  ASSERT_EQ(events.size(), 2);
+  EXPECT_EQ(events[0].value, kFlightRecorderCapacity + 8);
+}
+
+TEST(FlightRecorderTest, PerThread) {
+  this_thread::flight_recorder().clear();
+  this_thread::record_event("main");
+
+  std::thread{[] {
+    EXPECT_EQ(this_thread::flight_recorder().count(), 0);
+    this_thread::record_event("worker");
+  }}.join();
+
+  EXPECT_EQ(this_thread::flight_recorder().count(), 1);
+}
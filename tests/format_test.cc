@@ -0,0 +1,97 @@
+/**
+ * @file format_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-12
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/format.h"
+
+#include <array>
+#include <string>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "stx/option.h"
+#include "stx/result.h"
+
+using namespace std::string_view_literals;
+using namespace stx;
+
+namespace {
+
+int reports = 0;
+
+struct Counted {
+  int value;
+};
+
+Report operator>>(ReportQuery query, Counted const& counted) noexcept {
+  reports++;
+  return query >> counted.value;
+}
+
+template <typename... Args>
+std::string format(FormatString<std::type_identity_t<Args>...> format,
+                   Args const&... args) {
+  std::array<char, 128> buffer;
+  SpanReportWriter writer{buffer};
+  writer << FormatArgs<Args...>{format.str, args...};
+  return std::string(writer.view());
+}
+
+}  // namespace
+
+static_assert(internal::format::count_placeholders("") == 0);
+static_assert(internal::format::count_placeholders("{}, {}") == 2);
+static_assert(internal::format::count_placeholders("{{}} {}") == 1);
+
+TEST(FormatTest, Placeholders) {
+  EXPECT_EQ(format("no arguments"), "no arguments");
+  EXPECT_EQ(format("user {} shard {}", 42, 7U), "user 42 shard 7");
+  EXPECT_EQ(format("{}{}", "ab"sv, -1.5), "ab-1.5");
+  EXPECT_EQ(format("{{{}}} }}{{", true), "{true} }{");
+  EXPECT_EQ(format("{}", Counted{3}), "3");
+}
+
+TEST(FormatTest, Location) {
+  FormatString<int> format = "{}";
+  EXPECT_EQ(format.location.line(), __LINE__ - 1);
+}
+
+TEST(FormatTest, ExpectSuccessDoesNotFormat) {
+  reports = 0;
+  Counted counted{1};
+
+  Option<int> some = Some(5);
+  EXPECT_EQ(std::move(some).expect_fmt("value {}", counted), 5);
+
+  Result<int, std::string_view> ok = Ok(6);
+  EXPECT_EQ(std::move(ok).expect_fmt("value {}", counted), 6);
+
+  EXPECT_EQ(reports, 0);
+}
+
+TEST(FormatTest, PanicFmt) {
+  EXPECT_DEATH(panic_fmt("user {} shard {}", 42, Counted{7}),
+               "panicked with: 'user 42 shard 7'");
+  EXPECT_DEATH(panic_fmt("plain"), "panicked with: 'plain'");
+}
+
+TEST(FormatTest, ExpectFmt) {
+  auto expect_none = [] {
+    Option<int> none = None;
+    (void)std::move(none).expect_fmt("user {} shard {}", 42, 7);
+  };
+  EXPECT_DEATH(expect_none(), "panicked with: 'user 42 shard 7'");
+
+  auto expect_err = [] {
+    Result<int, std::string_view> err = Err("emergency failure"sv);
+    (void)std::move(err).expect_fmt("shard {}", 7);
+  };
+  EXPECT_DEATH(expect_err(), "panicked with: 'shard 7: emergency failure'");
+}
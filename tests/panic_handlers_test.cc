@@ -0,0 +1,317 @@
+/**
+ * @file panic_handlers_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-13
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "stx/flight_recorder.h"
+#include "stx/panic/handlers/binary/binary.h"
+#include "stx/panic/handlers/default/default.h"
+#include "stx/panic/handlers/halt/halt.h"
+#include "stx/panic/handlers/json/json.h"
+
+using namespace std::string_view_literals;
+using namespace stx;
+
+namespace {
+
+struct Context {
+  int user;
+  std::string_view name;
+};
+
+ReportWriter& operator<<(ReportWriter& writer, Context const& context) {
+  return writer << "user " << context.user << " \"" << context.name << "\"";
+}
+
+// writes "é" with its UTF-8 sequence split across two writes
+struct SplitSequence {};
+
+ReportWriter& operator<<(ReportWriter& writer, SplitSequence) {
+  return writer << "\xc3" << "\xa9";
+}
+
+// runs `handler` with stderr redirected to a pipe, returns what it wrote
+template <typename Handler>
+std::string capture_stderr(Handler&& handler) {
+  int fds[2];
+  EXPECT_EQ(pipe(fds), 0);
+  int saved = dup(STDERR_FILENO);
+  dup2(fds[1], STDERR_FILENO);
+  close(fds[1]);
+
+  handler();
+
+  dup2(saved, STDERR_FILENO);
+  close(saved);
+
+  std::string output;
+  char buffer[512];
+  ssize_t size;
+  while ((size = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    output.append(buffer, static_cast<size_t>(size));
+  }
+  close(fds[0]);
+  return output;
+}
+
+// parks a thread with `panic_park`, and returns once it is parked
+std::thread start_parked() {
+  size_t parked = parked_threads();
+  std::thread thread{
+      [] { panic_park("parked", ReportPayload(), SourceLocation::current()); }};
+  while (parked_threads() == parked) std::this_thread::yield();
+  return thread;
+}
+
+// reads the little-endian fields of a binary panic record
+struct RecordReader {
+  template <typename T>
+  T read() {
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+      value |= static_cast<uint64_t>(static_cast<uint8_t>(data[offset + i]))
+               << (8 * i);
+    }
+    offset += sizeof(T);
+    return static_cast<T>(value);
+  }
+
+  std::string_view read_string() {
+    auto size = read<uint32_t>();
+    std::string_view text = data.substr(offset, size);
+    offset += size;
+    return text;
+  }
+
+  std::string_view data;
+  size_t offset = 0;
+};
+
+}  // namespace
+
+TEST(PanicHandlersTest, Json) {
+  Context context{42, "ab\\c"};
+  SourceLocation location = SourceLocation::current();
+  std::string output = capture_stderr([&] {
+    panic_json("request\nfailed", ReportPayload::deferred(context), location);
+  });
+
+  EXPECT_TRUE(output.starts_with("{\"thread_id\":"));
+  EXPECT_TRUE(output.ends_with("]}\n"));
+  EXPECT_EQ(output.find('\n'), output.size() - 1);
+  EXPECT_NE(output.find(",\"timestamp_ns\":"), std::string::npos);
+  EXPECT_NE(output.find(",\"info\":\"request\\nfailed\","
+                        "\"payload\":\"user 42 \\\"ab\\\\c\\\"\","),
+            std::string::npos);
+  EXPECT_NE(output.find(",\"line\":" + std::to_string(location.line()) +
+                        ",\"column\":"),
+            std::string::npos);
+  EXPECT_NE(output.find("panic_handlers_test.cc\""), std::string::npos);
+}
+
+TEST(PanicHandlersTest, JsonUnbounded) {
+  std::string large(10000, 'x');
+  std::string_view payload = large;
+  std::string output = capture_stderr([&] {
+    panic_json("large", ReportPayload::deferred(payload));
+  });
+  EXPECT_NE(output.find("\"payload\":\"" + large + "\""), std::string::npos);
+}
+
+TEST(PanicHandlersTest, JsonInvalidUtf8) {
+  std::string output = capture_stderr([] {
+    // a valid sequence, an invalid byte, an overlong encoding, a surrogate,
+    // and a sequence cut short by the end of the string
+    panic_json("\xe2\x82\xac \xff \xc0\xaf \xed\xa0\x80 \xe2\x82",
+               ReportPayload::deferred(SplitSequence{}));
+  });
+
+  EXPECT_NE(output.find("\"info\":\"\xe2\x82\xac \\ufffd \\ufffd\\ufffd "
+                        "\\ufffd\\ufffd\\ufffd \\ufffd\","),
+            std::string::npos);
+  EXPECT_NE(output.find("\"payload\":\"\xc3\xa9\","), std::string::npos);
+}
+
+TEST(PanicHandlersTest, Binary) {
+  Context context{7, "name"};
+  SourceLocation location = SourceLocation::current();
+  std::string output = capture_stderr([&] {
+    panic_binary("request failed", ReportPayload::deferred(context),
+                 location);
+  });
+
+  RecordReader reader{output};
+  EXPECT_EQ(reader.read<uint32_t>(), kPanicRecordMagic);
+  EXPECT_EQ(std::string_view(output.data(), 4), "STXP"sv);
+  EXPECT_EQ(reader.read<uint16_t>(), kPanicRecordVersion);
+  (void)reader.read<uint64_t>();
+  EXPECT_GT(reader.read<uint64_t>(), 0);
+  EXPECT_EQ(reader.read<uint32_t>(), location.line());
+  EXPECT_EQ(reader.read<uint32_t>(), location.column());
+  EXPECT_EQ(reader.read_string(), "request failed"sv);
+
+  std::string payload;
+  for (uint32_t size; (size = reader.read<uint32_t>()) != 0;) {
+    payload += output.substr(reader.offset, size);
+    reader.offset += size;
+  }
+  EXPECT_EQ(payload, "user 7 \"name\"");
+
+  EXPECT_EQ(reader.read_string(), std::string_view(location.function_name()));
+  EXPECT_EQ(reader.read_string(), std::string_view(location.file_name()));
+
+  while (reader.read<uint8_t>() != 0) {
+    (void)reader.read<uint64_t>();
+    (void)reader.read_string();
+  }
+  EXPECT_EQ(reader.offset, output.size());
+}
+
+TEST(PanicHandlersTest, Park) {
+  std::thread first = start_parked();
+  std::thread second = start_parked();
+  EXPECT_EQ(parked_threads(), 2);
+
+  // the parked threads do not use the CPU, a spinning thread would use about
+  // as much CPU time as the time it is halted for
+  std::clock_t cpu_start = std::clock();
+  std::this_thread::sleep_for(std::chrono::milliseconds{500});
+  double cpu_seconds =
+      static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  EXPECT_LT(cpu_seconds, 0.05);
+  EXPECT_EQ(parked_threads(), 2);
+
+  release_parked_threads();
+  first.join();
+  second.join();
+  EXPECT_EQ(parked_threads(), 0);
+}
+
+TEST(PanicHandlersTest, ParkReleasedBySignal) {
+  ASSERT_TRUE(release_parked_threads_on(SIGUSR1));
+
+  std::thread parked = start_parked();
+  ASSERT_EQ(raise(SIGUSR1), 0);
+  parked.join();
+  EXPECT_EQ(parked_threads(), 0);
+
+  signal(SIGUSR1, SIG_DFL);
+}
+
+TEST(PanicHandlersTest, StormDeduplicated) {
+  set_panic_storm_limit(8, std::chrono::hours{1});
+
+  auto const storm = [] {
+    for (int i = 0; i < 3; i++) {
+      panic_default("storm", ReportPayload(), SourceLocation::current());
+    }
+  };
+
+  std::string output = capture_stderr(storm);
+  size_t first = output.find("panicked with: 'storm' at function: '");
+  EXPECT_NE(first, std::string::npos);
+  EXPECT_NE(output.find("(panic #2 at this location, full report suppressed)",
+                        first),
+            std::string::npos);
+  EXPECT_NE(output.find("(panic #3 at this location, full report suppressed)",
+                        first),
+            std::string::npos);
+
+  // the location is remembered within the window
+  output = capture_stderr(storm);
+  set_panic_storm_limit(8, std::chrono::seconds{1});
+
+  EXPECT_EQ(output.find("at function: '"), std::string::npos);
+  EXPECT_NE(output.find("(panic #6 at this location"), std::string::npos);
+}
+
+TEST(PanicHandlersTest, StormCountsAgeWithTheWindow) {
+  set_panic_storm_limit(8, std::chrono::milliseconds{1});
+
+  auto const storm = [] {
+    for (int i = 0; i < 2; i++) {
+      panic_default("storm", ReportPayload(), SourceLocation::current());
+    }
+  };
+
+  capture_stderr(storm);
+  std::this_thread::sleep_for(std::chrono::milliseconds{5});
+  std::string output = capture_stderr(storm);
+
+  set_panic_storm_limit(8, std::chrono::seconds{1});
+
+  // the first panic of the new window is written in full again
+  EXPECT_NE(output.find("panicked with: 'storm' at function: '"),
+            std::string::npos);
+  EXPECT_EQ(output.find("(panic #3"), std::string::npos);
+}
+
+TEST(PanicHandlersTest, StormRateLimited) {
+  set_panic_storm_limit(1, std::chrono::hours{1});
+
+  std::string output = capture_stderr([] {
+    panic_default("first", ReportPayload(), SourceLocation::current());
+    panic_default("second", ReportPayload(), SourceLocation::current());
+  });
+
+  set_panic_storm_limit(8, std::chrono::seconds{1});
+
+  EXPECT_NE(output.find("panicked with: 'first' at function: '"),
+            std::string::npos);
+  EXPECT_NE(output.find("panicked with: 'second' at ["), std::string::npos);
+  EXPECT_NE(output.find("(full report suppressed by the rate limit)"),
+            std::string::npos);
+}
+
+TEST(PanicHandlersTest, FlightRecorder) {
+  this_thread::flight_recorder().clear();
+
+  std::string output = capture_stderr([] {
+    FlightSpan span{"handle request", 3};
+    this_thread::record_event("parsed body", 512);
+    panic_default("recorded", ReportPayload(), SourceLocation::current());
+  });
+
+  size_t events = output.find("Flight recorder (most recent 2 of 2 events");
+  ASSERT_NE(events, std::string::npos);
+  size_t begin = output.find("begin 'handle request' 3", events);
+  EXPECT_NE(begin, std::string::npos);
+  EXPECT_NE(output.find("event 'parsed body' 512", begin), std::string::npos);
+}
+
+TEST(PanicHandlersTest, ReportSegments) {
+  // alternating copies and references use up the segments, a copy made when
+  // they are full must not land in a pending segment's part of the buffer
+  std::string expected;
+  std::string output = capture_stderr([&] {
+    internal::panic_util::StderrReport report;
+    for (int i = 0; i < 40; i++) {
+      std::string copied = "copy" + std::to_string(i) + ";";
+      report.write(copied);
+      report.write_ref("ref;");
+      expected += copied + "ref;";
+    }
+    report.finish();
+  });
+
+  EXPECT_EQ(output, expected);
+}
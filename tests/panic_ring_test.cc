@@ -0,0 +1,201 @@
+/**
+ * @file panic_ring_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-20
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/panic/ring_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "stx/flight_recorder.h"
+
+using namespace stx;
+
+namespace {
+
+// a ring file in the temporary directory, removed with the fixture
+class PanicRingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/stx_panic_ring_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    path_ = path;
+  }
+
+  void TearDown() override {
+    close_panic_ring();
+    unlink(path_.c_str());
+  }
+
+  // the records in the file, read the way `stx_panic_inspect` does
+  std::vector<PanicRingRecord> records(std::vector<std::string>& reports) {
+    std::vector<PanicRingRecord> result;
+    int fd = open(path_.c_str(), O_RDONLY);
+    struct stat status {};
+    fstat(fd, &status);
+    auto size = static_cast<size_t>(status.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return result;
+
+    valid_ = for_each_panic_ring_record(
+        std::span<char const>{static_cast<char const*>(mapping), size},
+        [&](PanicRingRecord const& record) {
+          reports.emplace_back(record.report);
+          result.push_back(record);
+        });
+    munmap(mapping, size);
+    // the views point into the unmapped file
+    for (size_t i = 0; i < result.size(); i++) result[i].report = reports[i];
+    return result;
+  }
+
+  static void panic_at(int i) {
+    panic_ring_hook(nullptr, "ring", ReportPayload::deferred(i),
+                    SourceLocation::current());
+  }
+
+  std::string path_;
+  bool valid_ = false;
+};
+
+}  // namespace
+
+TEST_F(PanicRingTest, Write) {
+  ASSERT_TRUE(open_panic_ring(path_.c_str(), 4, 512));
+
+  this_thread::flight_recorder().clear();
+  this_thread::record_event("before panic", 9);
+  panic_at(1);
+
+  std::vector<std::string> reports;
+  std::vector<PanicRingRecord> written = records(reports);
+  EXPECT_TRUE(valid_);
+  ASSERT_EQ(written.size(), 1);
+  EXPECT_EQ(written[0].sequence, 1);
+  EXPECT_NE(written[0].timestamp_ns, 0);
+  EXPECT_FALSE(written[0].truncated);
+  EXPECT_NE(written[0].report.find("panicked with: 'ring: 1'"),
+            std::string::npos);
+  EXPECT_NE(written[0].report.find("event 'before panic' 9"),
+            std::string::npos);
+}
+
+TEST_F(PanicRingTest, Wraps) {
+  ASSERT_TRUE(open_panic_ring(path_.c_str(), 4, 512));
+
+  for (int i = 1; i <= 10; i++) panic_at(i);
+
+  // the 4 most recent reports, oldest first
+  std::vector<std::string> reports;
+  std::vector<PanicRingRecord> written = records(reports);
+  ASSERT_EQ(written.size(), 4);
+  for (size_t i = 0; i < written.size(); i++) {
+    EXPECT_EQ(written[i].sequence, 7 + i);
+    EXPECT_NE(written[i].report.find("ring: " + std::to_string(7 + i)),
+              std::string::npos);
+  }
+}
+
+TEST_F(PanicRingTest, Truncated) {
+  ASSERT_TRUE(open_panic_ring(path_.c_str(), 2, 64));
+
+  panic_at(1);
+
+  std::vector<std::string> reports;
+  std::vector<PanicRingRecord> written = records(reports);
+  ASSERT_EQ(written.size(), 1);
+  EXPECT_TRUE(written[0].truncated);
+  EXPECT_EQ(written[0].report.size(),
+            64 - sizeof(internal::panic_ring::SlotHeader));
+}
+
+TEST_F(PanicRingTest, Reopen) {
+  ASSERT_TRUE(open_panic_ring(path_.c_str(), 4, 512));
+  panic_at(1);
+  panic_at(2);
+  close_panic_ring();
+
+  // the reports of a previous run are kept, and the sequence continues
+  ASSERT_TRUE(open_panic_ring(path_.c_str(), 4, 512));
+  panic_at(3);
+
+  std::vector<std::string> reports;
+  std::vector<PanicRingRecord> written = records(reports);
+  ASSERT_EQ(written.size(), 3);
+  EXPECT_EQ(written[2].sequence, 3);
+
+  // a different geometry resets the file
+  ASSERT_TRUE(open_panic_ring(path_.c_str(), 8, 512));
+  reports.clear();
+  EXPECT_TRUE(records(reports).empty());
+  EXPECT_TRUE(valid_);
+}
+
+TEST_F(PanicRingTest, HeldSlot) {
+  ASSERT_TRUE(open_panic_ring(path_.c_str(), 2, 512));
+
+  // the first slot is held by a writer, i.e. one a ticket around the ring
+  // behind, or one whose process died while writing
+  {
+    int fd = open(path_.c_str(), O_RDWR);
+    ASSERT_GE(fd, 0);
+    size_t size = internal::panic_ring::file_size(2, 512);
+    void* mapping =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    ASSERT_NE(mapping, MAP_FAILED);
+    reinterpret_cast<internal::panic_ring::SlotHeader*>(
+        static_cast<char*>(mapping) + internal::panic_ring::kSlotsOffset)
+        ->sequence = internal::panic_ring::kSlotWriting;
+    munmap(mapping, size);
+  }
+
+  // the report for the held slot is dropped rather than torn
+  panic_at(1);
+  panic_at(2);
+
+  std::vector<std::string> reports;
+  std::vector<PanicRingRecord> written = records(reports);
+  ASSERT_EQ(written.size(), 1);
+  EXPECT_EQ(written[0].sequence, 2);
+
+  // reopening frees the slot
+  close_panic_ring();
+  ASSERT_TRUE(open_panic_ring(path_.c_str(), 2, 512));
+  panic_at(3);
+
+  reports.clear();
+  written = records(reports);
+  ASSERT_EQ(written.size(), 2);
+  EXPECT_EQ(written[0].sequence, 2);
+  EXPECT_EQ(written[1].sequence, 3);
+}
+
+TEST_F(PanicRingTest, Closed) {
+  // writing does nothing if no ring is open
+  panic_at(1);
+
+  std::vector<std::string> reports;
+  EXPECT_TRUE(records(reports).empty());
+  EXPECT_FALSE(valid_);
+
+  EXPECT_FALSE(open_panic_ring(path_.c_str(), 0, 512));
+  EXPECT_FALSE(open_panic_ring(path_.c_str(), 4, 8));
+}
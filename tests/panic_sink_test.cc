@@ -0,0 +1,191 @@
+/**
+ * @file panic_sink_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-22
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/panic/sink.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "stx/panic/handlers/default/default.h"
+#include "stx/panic/signal_safe.h"
+
+using namespace stx;
+
+namespace {
+
+class PanicSinkTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // full reports for every panic
+    set_panic_storm_limit(0, std::chrono::seconds{1});
+
+    char directory[] = "/tmp/stx_panic_sink_XXXXXX";
+    ASSERT_NE(mkdtemp(directory), nullptr);
+    directory_ = directory;
+  }
+
+  void TearDown() override {
+    reset_panic_sink();
+    set_panic_storm_limit(8, std::chrono::seconds{1});
+    for (char const* name : {"/panics.log", "/panics.log.1", "/panics.sock"}) {
+      unlink((directory_ + name).c_str());
+    }
+    rmdir(directory_.c_str());
+  }
+
+  static std::string read_all(int fd) {
+    std::string output;
+    char buffer[512];
+    ssize_t size;
+    while ((size = read(fd, buffer, sizeof(buffer))) > 0) {
+      output.append(buffer, static_cast<size_t>(size));
+    }
+    return output;
+  }
+
+  static std::string read_file(std::string const& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return {};
+    std::string contents = read_all(fd);
+    close(fd);
+    return contents;
+  }
+
+  std::string directory_;
+};
+
+}  // namespace
+
+TEST_F(PanicSinkTest, Fd) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  ASSERT_TRUE(set_panic_sink_fd(fds[1]));
+  EXPECT_EQ(panic_sink_kind(), PanicSinkKind::Fd);
+
+  panic_default("to the pipe", ReportPayload(), SourceLocation::current());
+
+  reset_panic_sink();
+  EXPECT_EQ(panic_sink_kind(), PanicSinkKind::Stderr);
+  close(fds[1]);
+
+  EXPECT_NE(read_all(fds[0]).find("panicked with: 'to the pipe'"),
+            std::string::npos);
+  close(fds[0]);
+}
+
+TEST_F(PanicSinkTest, FullPipeDoesNotBlock) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  ASSERT_TRUE(set_panic_sink_fd(fds[1]));
+
+  // fills the pipe, as a stalled log shipper would
+  char chunk[4096] = {};
+  while (write(fds[1], chunk, sizeof(chunk)) > 0) {
+  }
+
+  uint64_t dropped = panic_sink_dropped();
+  panic_default("into a full pipe", ReportPayload(), SourceLocation::current());
+  EXPECT_GT(panic_sink_dropped(), dropped);
+
+  reset_panic_sink();
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST_F(PanicSinkTest, FileRotation) {
+  std::string path = directory_ + "/panics.log";
+  ASSERT_TRUE(open_panic_sink_file(path.c_str(), 64));
+  EXPECT_EQ(panic_sink_kind(), PanicSinkKind::File);
+
+  // the first report fills the file, so the second one rotates it
+  panic_default("first", ReportPayload(), SourceLocation::current());
+  panic_default("second", ReportPayload(), SourceLocation::current());
+  reset_panic_sink();
+
+  std::string rotated = read_file(path + ".1");
+  std::string current = read_file(path);
+  EXPECT_NE(rotated.find("panicked with: 'first'"), std::string::npos);
+  EXPECT_EQ(rotated.find("'second'"), std::string::npos);
+  EXPECT_NE(current.find("panicked with: 'second'"), std::string::npos);
+  EXPECT_EQ(current.find("'first'"), std::string::npos);
+}
+
+TEST_F(PanicSinkTest, FileAppends) {
+  std::string path = directory_ + "/panics.log";
+  ASSERT_TRUE(open_panic_sink_file(path.c_str(), 0));
+  panic_default("first", ReportPayload(), SourceLocation::current());
+  ASSERT_TRUE(open_panic_sink_file(path.c_str(), 0));
+  panic_default("second", ReportPayload(), SourceLocation::current());
+  reset_panic_sink();
+
+  std::string contents = read_file(path);
+  size_t first = contents.find("'first'");
+  ASSERT_NE(first, std::string::npos);
+  EXPECT_NE(contents.find("'second'", first), std::string::npos);
+}
+
+TEST_F(PanicSinkTest, Socket) {
+  std::string path = directory_ + "/panics.sock";
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  ASSERT_LT(path.size(), sizeof(address.sun_path));
+  std::strcpy(address.sun_path, path.c_str());
+
+  int collector = socket(AF_UNIX, SOCK_DGRAM, 0);
+  ASSERT_GE(collector, 0);
+  ASSERT_EQ(bind(collector, reinterpret_cast<sockaddr const*>(&address),
+                 sizeof(address)),
+            0);
+
+  ASSERT_TRUE(connect_panic_sink_socket(path.c_str()));
+  EXPECT_EQ(panic_sink_kind(), PanicSinkKind::Socket);
+
+  panic_default("to the collector", ReportPayload(),
+                SourceLocation::current());
+
+  // the report is one datagram
+  char datagram[4096];
+  ssize_t size = recv(collector, datagram, sizeof(datagram), MSG_DONTWAIT);
+  ASSERT_GT(size, 0);
+  std::string report{datagram, static_cast<size_t>(size)};
+  EXPECT_NE(report.find("panicked with: 'to the collector'"),
+            std::string::npos);
+  EXPECT_EQ(report.back(), '\n');
+
+  reset_panic_sink();
+  close(collector);
+
+  EXPECT_FALSE(connect_panic_sink_socket(path.c_str()));
+}
+
+TEST_F(PanicSinkTest, SignalSafeReport) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  ASSERT_TRUE(set_panic_sink_fd(fds[1]));
+
+  internal::signal_safe::SignalSafeReport report =
+      internal::signal_safe::begin_signal_report();
+  report.write("from a signal handler");
+  report.finish();
+
+  reset_panic_sink();
+  close(fds[1]);
+  EXPECT_EQ(read_all(fds[0]), "from a signal handler");
+  close(fds[0]);
+}
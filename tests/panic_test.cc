@@ -18,7 +18,161 @@
 //
 
 #include "stx/panic.h"
+#include "stx/panic/hook.h"
 
+#include <array>
+#include <cstdio>
+#include <thread>
+#include <string_view>
+
+using namespace std::string_view_literals;
 using namespace stx;
 
+namespace {
+
+int reports = 0;
+
+struct Counted {
+  int value;
+};
+
+Report operator>>(ReportQuery query, Counted const& counted) noexcept {
+  reports++;
+  return query >> counted.value;
+}
+
+}  // namespace
+
 TEST(PanicTest, PanicInfo) {}
+
+TEST(PanicTest, DeferredPayload) {
+  reports = 0;
+  Counted counted{42};
+  auto payload = ReportPayload::deferred(counted);
+  EXPECT_TRUE(payload.is_deferred());
+  // not formatted until written
+  EXPECT_EQ(reports, 0);
+
+  std::array<char, 8> buffer;
+  EXPECT_EQ(std::string_view(buffer.data(), payload.write(buffer)), "42"sv);
+  EXPECT_EQ(reports, 1);
+  EXPECT_EQ(payload.data(), "42"sv);
+  EXPECT_EQ(reports, 2);
+
+  // truncated to the buffer
+  counted.value = 123456789;
+  EXPECT_EQ(std::string_view(buffer.data(), payload.write(buffer)),
+            "12345678"sv);
+
+  Report report("eager"sv);
+  EXPECT_FALSE(ReportPayload(report).is_deferred());
+  EXPECT_EQ(ReportPayload(report).data(), "eager"sv);
+  EXPECT_EQ(ReportPayload().data(), ""sv);
+}
+
+TEST(PanicTest, DeferredPanicReport) {
+  EXPECT_DEATH(panic("unexpected value", Counted{-7}),
+               "panicked with: 'unexpected value: -7'");
+  EXPECT_DEATH(panic("no payload"), "panicked with: 'no payload'");
+}
+
+namespace {
+
+void print_hook(void* context, std::string_view, ReportPayload const&,
+                SourceLocation) noexcept {
+  std::fputs(static_cast<char const*>(context), stderr);
+}
+
+void noop_hook(void*, std::string_view, ReportPayload const&,
+               SourceLocation) noexcept {}
+
+void job_hook(std::string_view info, ReportPayload const& payload,
+              SourceLocation) noexcept {
+  std::string_view report = payload.data();
+  std::fprintf(stderr, "job failed: %.*s: %.*s\n",
+               static_cast<int>(info.size()), info.data(),
+               static_cast<int>(report.size()), report.data());
+}
+
+void other_hook(std::string_view, ReportPayload const&,
+                SourceLocation) noexcept {}
+
+}  // namespace
+
+TEST(PanicTest, HookChain) {
+  static char first[] = "first hook\n";
+  static char second[] = "second hook\n";
+  static char removed[] = "removed hook\n";
+
+  auto chain = [] {
+    EXPECT_TRUE(register_panic_hook(print_hook, first));
+    EXPECT_TRUE(register_panic_hook(print_hook, removed));
+    EXPECT_TRUE(register_panic_hook(print_hook, second));
+    EXPECT_TRUE(unregister_panic_hook(print_hook, removed));
+    EXPECT_FALSE(unregister_panic_hook(print_hook, removed));
+    panic("chained");
+  };
+
+  // the hooks are called in registration order, before the panic handler
+  EXPECT_DEATH(chain(),
+               "^first hook\nsecond hook\n\nthread with hash: '[0-9]+' "
+               "panicked with: 'chained'");
+}
+
+TEST(PanicTest, HookChainFull) {
+  auto fill = [] {
+    for (size_t i = 0; i < kMaxChainedPanicHooks; i++) {
+      EXPECT_TRUE(register_panic_hook(noop_hook, nullptr));
+    }
+    if (!register_panic_hook(noop_hook, nullptr)) panic("chain is full");
+  };
+  EXPECT_DEATH(fill(), "chain is full");
+}
+
+TEST(PanicTest, HookChainReusesSlots) {
+  static char loaded[] = "loaded plugin\n";
+
+  // a plugin that is loaded and unloaded many times does not exhaust the chain
+  auto reload = [] {
+    for (size_t i = 0; i < kMaxChainedPanicHooks * 4; i++) {
+      if (!register_panic_hook(noop_hook, nullptr)) panic("chain is full");
+      EXPECT_TRUE(unregister_panic_hook(noop_hook, nullptr));
+    }
+    EXPECT_TRUE(register_panic_hook(print_hook, loaded));
+    panic("reloaded");
+  };
+  EXPECT_DEATH(reload(), "^loaded plugin\n\nthread with hash: '[0-9]+' "
+                         "panicked with: 'reloaded'");
+}
+
+TEST(PanicTest, ThreadHookGuard) {
+  EXPECT_EQ(this_thread::exchange_panic_hook(nullptr), nullptr);
+  {
+    ScopedPanicHook outer{job_hook};
+    {
+      ScopedPanicHook inner{other_hook};
+      EXPECT_EQ(this_thread::exchange_panic_hook(other_hook), other_hook);
+    }
+    EXPECT_EQ(this_thread::exchange_panic_hook(job_hook), job_hook);
+  }
+  EXPECT_EQ(this_thread::exchange_panic_hook(nullptr), nullptr);
+
+  EXPECT_TRUE(this_thread::attach_panic_hook(job_hook));
+  EXPECT_EQ(this_thread::exchange_panic_hook(nullptr), job_hook);
+}
+
+TEST(PanicTest, ThreadHook) {
+  auto job = [] {
+    ScopedPanicHook guard{job_hook};
+    panic("boom", 42);
+  };
+  // the thread's hook replaces the default hook
+  EXPECT_DEATH(job(), "^job failed: boom: 42\n$");
+
+  // other threads still use the global hook
+  auto worker = [] {
+    ScopedPanicHook guard{job_hook};
+    std::thread([] { panic("elsewhere"); }).join();
+  };
+  EXPECT_DEATH(worker(), "panicked with: 'elsewhere'");
+}
@@ -0,0 +1,132 @@
+/**
+ * @file parse_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-09
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/parse.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std::string_view_literals;
+using namespace stx;
+
+TEST(ParseTest, Integers) {
+  EXPECT_EQ(parse<int32_t>("-42"), Ok(-42));
+  EXPECT_EQ(parse<uint8_t>("255"), Ok<uint8_t>(255));
+  EXPECT_EQ(parse<int64_t>("-9223372036854775808"), Ok(INT64_MIN));
+
+  EXPECT_EQ(parse<uint8_t>("256").unwrap_err(),
+            (ParseError{ParseErrorKind::OutOfRange, 0, "256"}));
+  EXPECT_EQ(parse<int32_t>("4x2").unwrap_err(),
+            (ParseError{ParseErrorKind::InvalidDigit, 1, "4x2"}));
+  EXPECT_EQ(parse<int32_t>(" 1").unwrap_err(),
+            (ParseError{ParseErrorKind::InvalidDigit, 0, " 1"}));
+  EXPECT_EQ(parse<uint32_t>("-1").unwrap_err().kind,
+            ParseErrorKind::InvalidDigit);
+  EXPECT_EQ(parse<int32_t>("").unwrap_err().kind, ParseErrorKind::Empty);
+}
+
+TEST(ParseTest, Floats) {
+  EXPECT_EQ(parse<double>("1.5e3"), Ok(1500.0));
+  EXPECT_EQ(parse<float>("-0.25"), Ok(-0.25f));
+  EXPECT_EQ(parse<double>("1e999").unwrap_err().kind,
+            ParseErrorKind::OutOfRange);
+  EXPECT_EQ(parse<double>("2.5.1").unwrap_err(),
+            (ParseError{ParseErrorKind::InvalidDigit, 3, "2.5.1"}));
+}
+
+TEST(ParseTest, Column) {
+  std::array<int64_t, 8> out{};
+  auto values = parse_column<int64_t>("1,-2,30", ',', out).unwrap();
+  EXPECT_EQ(values.size(), 3);
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[1], -2);
+  EXPECT_EQ(values[2], 30);
+
+  EXPECT_EQ(parse_column<int64_t>("", ',', out).unwrap().size(), 0);
+  EXPECT_EQ(parse_column<int64_t>("1,2,3,4,5,6,7,8,9", ',', out).unwrap().size(),
+            8);
+
+  EXPECT_EQ(parse_column<int64_t>("1,,3", ',', out).unwrap_err(),
+            (ParseErrorAt{ParseError{ParseErrorKind::Empty, 0, ""}, 1}));
+  EXPECT_EQ(parse_column<int64_t>("1,2-3", ',', out).unwrap_err(),
+            (ParseErrorAt{ParseError{ParseErrorKind::InvalidDigit, 1, "2-3"},
+                          1}));
+  EXPECT_EQ(parse_column<int64_t>("1,-", ',', out).unwrap_err().index, 1);
+
+  std::array<uint8_t, 4> bytes{};
+  EXPECT_EQ(parse_column<uint8_t>("1|300", '|', bytes).unwrap_err().error.kind,
+            ParseErrorKind::OutOfRange);
+  EXPECT_EQ(parse_column<uint8_t>("1|-3", '|', bytes).unwrap_err().index, 1);
+
+  std::array<double, 4> reals{};
+  EXPECT_EQ(parse_column<double>("0.5;-1e2", ';', reals).unwrap().size(), 2);
+  EXPECT_EQ(reals[1], -100.0);
+}
+
+TEST(ParseTest, LongColumn) {
+  // long enough for the vectorized validation, with fields that are too long
+  // for the unchecked conversion
+  std::string text;
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < 300; i++) {
+    int64_t value = (i % 3 == 0) ? -i * 30'000'000'000'000'001 : i;
+    if (i == 299) value = INT64_MIN;
+    expected.push_back(value);
+    text += std::to_string(value);
+    text += ',';
+  }
+  text.pop_back();
+
+  std::vector<int64_t> out(400);
+  auto values = parse_column<int64_t>(text, ',', out).unwrap();
+  EXPECT_EQ(std::vector<int64_t>(values.begin(), values.end()), expected);
+
+  // a minus sign at the start of a field, after the delimiter that ends a
+  // 32-byte block
+  std::string carried;
+  for (int i = 0; i < 15; i++) carried += "1,";
+  carried += "1,-5";
+  EXPECT_EQ(parse_column<int64_t>(carried, ',', out).unwrap().back(), -5);
+
+  // a minus sign in the middle of a field, at the start of a 32-byte block
+  std::string bad;
+  for (int i = 0; i < 15; i++) bad += "1,";
+  bad += "11-5";
+  EXPECT_EQ(parse_column<int64_t>(bad, ',', out).unwrap_err().error.kind,
+            ParseErrorKind::InvalidDigit);
+
+  std::string spaced = text;
+  spaced[100] = ' ';
+  EXPECT_TRUE(parse_column<int64_t>(spaced, ',', out).is_err());
+}
+
+TEST(ParseTest, Report) {
+  EXPECT_EQ((internal::report::query >> parse<int32_t>("12x4").unwrap_err())
+                .what(),
+            R"(invalid digit at offset 2 in "12x4")"sv);
+  EXPECT_EQ((internal::report::query >> parse<int8_t>("300").unwrap_err())
+                .what(),
+            R"(number out of range in "300")"sv);
+
+  std::array<int32_t, 4> out{};
+  EXPECT_EQ((internal::report::query >>
+             parse_column<int32_t>("1,2,", ',', out).unwrap_err())
+                .what(),
+            "field 2: cannot parse number from empty string"sv);
+
+  static_assert(Reportable<ParseError>);
+  static_assert(Reportable<ParseErrorAt>);
+}
@@ -0,0 +1,141 @@
+/**
+ * @file ranges_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-02
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/ranges.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace stx;
+
+static_assert(std::ranges::sized_range<Option<int>>);
+static_assert(std::ranges::contiguous_range<Option<int>>);
+static_assert(std::ranges::sized_range<Option<int> const>);
+
+TEST(RangesTest, OptionAsRange) {
+  Option a = Some(8);
+  EXPECT_EQ(a.size(), 1);
+  EXPECT_EQ(std::ranges::distance(a), 1);
+
+  for (int& v : a) v = 9;
+  EXPECT_EQ(a, Some(9));
+
+  Option<std::string> b = None;
+  EXPECT_EQ(b.size(), 0);
+  EXPECT_TRUE(std::ranges::empty(b));
+
+  int iterations = 0;
+  for (auto const& v : b) {
+    (void)v;
+    iterations++;
+  }
+  EXPECT_EQ(iterations, 0);
+
+  Option const c = Some("hello"s);
+  EXPECT_EQ(std::ranges::count(c, "hello"s), 1);
+}
+
+TEST(RangesTest, FlattenOptions) {
+  std::vector<Option<std::string>> v;
+  v.push_back(Some("a"s));
+  v.push_back(None);
+  v.push_back(Some("b"s));
+  v.push_back(None);
+
+  std::string joined;
+  for (std::string& s : v | views::flatten_options) joined += s;
+  EXPECT_EQ(joined, "ab");
+
+  for (std::string& s : views::flatten_options(v)) s += "!";
+  EXPECT_EQ(v[0], Some("a!"s));
+  EXPECT_EQ(v[2], Some("b!"s));
+
+  std::vector<Option<int>> none;
+  none.push_back(None);
+  EXPECT_TRUE(std::ranges::empty(none | views::flatten_options));
+}
+
+TEST(RangesTest, OkAndErrValues) {
+  std::vector<Result<int, std::string>> v;
+  v.push_back(Ok(1));
+  v.push_back(Err("bad"s));
+  v.push_back(Ok(2));
+  v.push_back(Err("worse"s));
+
+  int sum = 0;
+  for (int x : v | views::ok_values) sum += x;
+  EXPECT_EQ(sum, 3);
+
+  std::vector<std::string> errors;
+  for (std::string const& e : v | views::err_values) errors.push_back(e);
+  EXPECT_EQ(errors, (std::vector{"bad"s, "worse"s}));
+
+  auto const& cv = v;
+  EXPECT_EQ(std::ranges::distance(cv | views::ok_values), 2);
+}
+
+TEST(RangesTest, FilterMap) {
+  std::vector<std::string_view> v{"1"sv, "x"sv, "3"sv, ""sv};
+
+  auto digit = [](std::string_view s) -> Option<int> {
+    if (!s.empty() && s[0] >= '0' && s[0] <= '9') return Some(s[0] - '0');
+    return None;
+  };
+
+  int sum = 0;
+  for (int x : v | views::filter_map(digit)) sum += x;
+  EXPECT_EQ(sum, 4);
+
+  int offset = 10;
+  auto shifted = views::filter_map(v, [&offset](std::string_view s) {
+    return make_some(s.size() + offset);
+  });
+
+  size_t total = 0;
+  for (size_t x : shifted) total += x;
+  EXPECT_EQ(total, 43);
+
+  auto moved = views::filter_map(
+      v, [](std::string_view s) -> Option<std::string> {
+        if (s.empty()) return None;
+        return Some(std::string(s));
+      });
+
+  std::vector<std::string> strings;
+  for (std::string& s : moved) strings.push_back(std::move(s));
+  EXPECT_EQ(strings, (std::vector{"1"s, "x"s, "3"s}));
+}
+
+TEST(RangesTest, Transpose) {
+  std::vector<Option<Result<int, std::string>>> v;
+  v.push_back(Some(make_ok<int, std::string>(1)));
+  v.push_back(None);
+  v.push_back(Some(make_err<int, std::string>("bad"s)));
+
+  std::vector<std::string> out;
+  for (auto&& r : v | views::transpose) {
+    std::move(r).match(
+        [&](auto option) {
+          out.push_back(std::move(option).match(
+              [](auto value) { return std::to_string(value.get()); },
+              []() { return "none"s; }));
+        },
+        [&](auto err) { out.push_back(err.get()); });
+  }
+
+  EXPECT_EQ(out, (std::vector{"1"s, "none"s, "bad"s}));
+}
@@ -6,6 +6,12 @@
 
 enum class IoError { EoF = 1, NotExists = 2, InvalidPath = 4, __Reserved };
 enum class Dummy {};
+enum class Color : uint8_t { Red, Green = 100, Blue = 200 };
+enum Unscoped { First = -3, Second };
+
+namespace {
+enum class Hidden : int64_t { Value = 7 };
+}  // namespace
 
 using namespace stx;
 
@@ -27,8 +33,22 @@ static_assert(Reportable<uint8_t>);
 static_assert(Reportable<int16_t>);
 static_assert(Reportable<uint16_t>);
 
+static_assert(Reportable<int64_t>);
+static_assert(Reportable<uint64_t>);
+static_assert(Reportable<long long>);
+static_assert(Reportable<float>);
+static_assert(Reportable<double>);
+static_assert(Reportable<long double>);
+static_assert(Reportable<bool>);
+static_assert(Reportable<int const*>);
+
 static_assert(Reportable<IoError>);
-static_assert(!Reportable<Dummy>);
+// every enum is reportable by its enumerator names
+static_assert(Reportable<Dummy>);
+static_assert(Reportable<Report>);
+// characters and C-strings are not implicitly reported as numbers or strings
+static_assert(!Reportable<char>);
+static_assert(!Reportable<char[6]>);
 
 static constexpr auto query = ReportQuery{};
 
@@ -78,4 +98,62 @@ TEST(ReportTest, FormatEnum) {
   auto strq = "Hi"sv;
 
   EXPECT_EQ((query >> strq).what(), strq);
-}
\ No newline at end of file
+}
+
+TEST(ReportTest, FormatWideIntegers) {
+  EXPECT_EQ((query >> std::numeric_limits<int64_t>::min()).what(),
+            "-9223372036854775808");
+  EXPECT_EQ((query >> std::numeric_limits<uint64_t>::max()).what(),
+            "18446744073709551615");
+  EXPECT_EQ((query >> int32_t{-2147483647 - 1}).what(), "-2147483648");
+  EXPECT_EQ((query >> uint16_t{65535}).what(), "65535");
+
+#if defined(__SIZEOF_INT128__)
+  using internal::report::int128, internal::report::uint128;
+  uint128 u128_max = ~static_cast<uint128>(0);
+  EXPECT_EQ((query >> u128_max).what(),
+            "340282366920938463463374607431768211455");
+  int128 i128_min = -static_cast<int128>(u128_max >> 1) - 1;
+  EXPECT_EQ((query >> i128_min).what(),
+            "-170141183460469231731687303715884105728");
+  EXPECT_EQ((query >> static_cast<int128>(0)).what(), "0");
+  EXPECT_EQ((query >> static_cast<int128>(-10'000'000'000'000'000'000.0L))
+                .what(),
+            "-10000000000000000000");
+#endif
+}
+
+TEST(ReportTest, FormatFloatingPoint) {
+  EXPECT_EQ((query >> 0.1).what(), "0.1");
+  EXPECT_EQ((query >> -2.5f).what(), "-2.5");
+  EXPECT_EQ((query >> 1e100).what(), "1e+100");
+  EXPECT_EQ((query >> std::numeric_limits<double>::infinity()).what(), "inf");
+  EXPECT_EQ((query >> 1.5L).what(), "1.5");
+}
+
+TEST(ReportTest, FormatBoolAndPointer) {
+  EXPECT_EQ((query >> true).what(), "true");
+  EXPECT_EQ((query >> false).what(), "false");
+  EXPECT_EQ((query >> nullptr).what(), "nullptr");
+
+  int const* null = nullptr;
+  EXPECT_EQ((query >> null).what(), "0x0");
+  auto address = reinterpret_cast<int const*>(uintptr_t{0xdeadbeef});
+  EXPECT_EQ((query >> address).what(), "0xdeadbeef");
+}
+
+TEST(ReportTest, FormatEnumName) {
+  EXPECT_EQ((query >> Color::Red).what(), "Red");
+  EXPECT_EQ((query >> Color::Green).what(), "Green");
+  // outside of the default name range
+  EXPECT_EQ((query >> Color::Blue).what(), "200");
+  EXPECT_EQ((query >> static_cast<Color>(3)).what(), "3");
+
+  EXPECT_EQ((query >> First).what(), "First");
+  EXPECT_EQ((query >> Second).what(), "Second");
+  EXPECT_EQ((query >> Hidden::Value).what(), "Value");
+  EXPECT_EQ((query >> static_cast<Dummy>(-5)).what(), "-5");
+
+  // user-provided overloads take precedence
+  EXPECT_EQ((query >> IoError::NotExists).what(), "File does not exist");
+}
@@ -0,0 +1,153 @@
+/**
+ * @file report_writer_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-11
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/report_writer.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#if CFG(OS, POSIX)
+#include <unistd.h>
+#endif
+
+using namespace std::string_view_literals;
+using namespace stx;
+
+namespace {
+
+struct Manifest {
+  std::vector<std::string> missing;
+};
+
+ReportWriter& operator<<(ReportWriter& writer, Manifest const& manifest) {
+  writer << "missing " << manifest.missing.size() << " files:";
+  for (std::string const& path : manifest.missing) writer << ' ' << path;
+  return writer;
+}
+
+Manifest make_manifest(size_t size) {
+  Manifest manifest;
+  for (size_t i = 0; i < size; i++) {
+    manifest.missing.push_back("assets/texture_" + std::to_string(i) + ".png");
+  }
+  return manifest;
+}
+
+std::string expected_report(Manifest const& manifest) {
+  std::string report =
+      "missing " + std::to_string(manifest.missing.size()) + " files:";
+  for (std::string const& path : manifest.missing) report += " " + path;
+  return report;
+}
+
+}  // namespace
+
+static_assert(ReportWritable<Manifest>);
+static_assert(ReportWritable<int>);
+static_assert(ReportWritable<double>);
+static_assert(ReportWritable<std::string>);
+// types that can be streamed are also reportable, truncated to a `Report`
+static_assert(Reportable<Manifest>);
+
+TEST(ReportWriterTest, Primitives) {
+  char buffer[64];
+  SpanReportWriter writer{buffer};
+  writer << "n=" << -42 << ", x=" << 0.5 << ", ok=" << true << ' '
+         << uint64_t{18446744073709551615ULL};
+  EXPECT_EQ(writer.view(), "n=-42, x=0.5, ok=true 18446744073709551615"sv);
+  EXPECT_FALSE(writer.truncated());
+}
+
+TEST(ReportWriterTest, SpanTruncates) {
+  char buffer[8];
+  SpanReportWriter writer{buffer};
+  writer << "0123" << "456789";
+  EXPECT_EQ(writer.view(), "01234567"sv);
+  EXPECT_EQ(writer.size(), 8);
+  EXPECT_TRUE(writer.truncated());
+}
+
+TEST(ReportWriterTest, Arena) {
+  Manifest manifest = make_manifest(500);
+
+  ArenaReportWriter writer;
+  write_report(writer, manifest);
+  EXPECT_EQ(writer.view(), expected_report(manifest));
+  EXPECT_GT(writer.view().size(), kMaxReportSize);
+  EXPECT_FALSE(writer.truncated());
+
+  writer.clear();
+  write_report(writer, 7);
+  EXPECT_EQ(writer.view(), "7"sv);
+}
+
+TEST(ReportWriterTest, ReportSink) {
+  Manifest small = make_manifest(2);
+  EXPECT_EQ((ReportQuery{} >> small).what(), expected_report(small));
+
+  // the fixed `Report` keeps its head and marks the truncation
+  Manifest large = make_manifest(100);
+  Report report = ReportQuery{} >> large;
+  EXPECT_EQ(report.what().size(), kMaxReportSize);
+  EXPECT_TRUE(report.what().ends_with(kReportTruncationMessage));
+  EXPECT_TRUE(expected_report(large).starts_with(report.what().substr(
+      0, kMaxReportSize - kReportTruncationMessage.size())));
+
+  // types without `operator<<` are written through their `Report`
+  ArenaReportWriter writer;
+  write_report(writer, Report("from a report"));
+  EXPECT_EQ(writer.view(), "from a report"sv);
+}
+
+TEST(ReportWriterTest, DeferredPayloadStreams) {
+  Manifest manifest = make_manifest(500);
+  ReportPayload payload = ReportPayload::deferred(manifest);
+
+  ArenaReportWriter writer;
+  payload.write_to(writer);
+  EXPECT_EQ(writer.view(), expected_report(manifest));
+
+  // the buffer overload is truncated to the buffer
+  char buffer[16];
+  EXPECT_EQ(payload.write(buffer), 16);
+  EXPECT_EQ(std::string_view(buffer, 16), "missing 500 file"sv);
+}
+
+#if CFG(OS, POSIX)
+TEST(ReportWriterTest, FileDescriptor) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+
+  Manifest manifest = make_manifest(40);
+  std::string expected = expected_report(manifest);
+  // must fit in the pipe's buffer, as nothing reads it concurrently
+  ASSERT_LT(expected.size(), 4096);
+
+  {
+    FdReportWriter writer{fds[1]};
+    write_report(writer, manifest);
+  }
+  close(fds[1]);
+
+  std::string read_back;
+  char buffer[512];
+  ssize_t size;
+  while ((size = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    read_back.append(buffer, static_cast<size_t>(size));
+  }
+  close(fds[0]);
+
+  EXPECT_EQ(read_back, expected);
+}
+#endif
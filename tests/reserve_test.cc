@@ -0,0 +1,168 @@
+/**
+ * @file reserve_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/panic/reserve.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "stx/panic/handlers/default/default.h"
+#include "stx/spawn.h"
+
+using namespace stx;
+
+namespace {
+
+// a payload whose formatter needs more stack than the panicking thread has
+struct StackHungry {};
+
+constexpr size_t kHungryStackSize = 44 * 1024;
+bool formatted = false;
+
+ReportWriter& operator<<(ReportWriter& writer, StackHungry const&) {
+  volatile char scratch[kHungryStackSize];
+  for (size_t i = 0; i < kHungryStackSize; i++) scratch[i] = 0;
+  formatted = scratch[0] == 0;
+  return writer << "stack hungry payload";
+}
+
+void* panic_on_small_stack(void*) {
+  int saved = dup(STDERR_FILENO);
+  int null = open("/dev/null", O_WRONLY);
+  dup2(null, STDERR_FILENO);
+  close(null);
+
+  panic_default("out of stack", ReportPayload::deferred(StackHungry{}),
+                SourceLocation::current());
+
+  dup2(saved, STDERR_FILENO);
+  close(saved);
+  return nullptr;
+}
+
+// the size of the calling thread's alternate signal stack, 0 if it has none
+size_t signal_stack_size() {
+  stack_t stack{};
+  if (sigaltstack(nullptr, &stack) != 0 || (stack.ss_flags & SS_DISABLE) != 0) {
+    return 0;
+  }
+  return stack.ss_size;
+}
+
+size_t volatile overflow_limit = SIZE_MAX;
+
+[[gnu::noinline]] size_t overflow_stack(size_t depth) {
+  char volatile frame[1024];
+  frame[0] = static_cast<char>(depth);
+  if (depth == overflow_limit) return 0;
+  return overflow_stack(depth + 1) + static_cast<size_t>(frame[0]);
+}
+
+void report_overflow(int) {
+  constexpr char kMessage[] = "stack overflow reported\n";
+  (void)write(STDERR_FILENO, kMessage, sizeof(kMessage) - 1);
+  _exit(1);
+}
+
+}  // namespace
+
+TEST(ReserveTest, Run) {
+  if (!setup_panic_reserve()) {
+    EXPECT_FALSE(panic_reserve_ready());
+    GTEST_SKIP() << "the emergency reserve is not supported";
+  }
+  EXPECT_TRUE(panic_reserve_ready());
+  EXPECT_TRUE(setup_panic_reserve());
+
+  struct Context {
+    char const* caller;
+    char const* reserve;
+    bool nested;
+  };
+
+  char caller_local = 0;
+  Context context{&caller_local, nullptr, true};
+
+  EXPECT_TRUE(internal::panic_reserve::run(
+      [](void* arg) {
+        auto& context = *static_cast<Context*>(arg);
+        char reserve_local = 0;
+        context.reserve = &reserve_local;
+        // the panic stack is in use
+        context.nested = internal::panic_reserve::run([](void*) {}, nullptr);
+      },
+      &context));
+
+  auto const distance = [](char const* a, char const* b) {
+    return a > b ? static_cast<size_t>(a - b) : static_cast<size_t>(b - a);
+  };
+
+  ASSERT_NE(context.reserve, nullptr);
+  EXPECT_GT(distance(context.caller, context.reserve), kPanicReserveStackSize);
+  EXPECT_FALSE(context.nested);
+}
+
+TEST(ReserveTest, PanicOnSmallStack) {
+  if (!setup_panic_reserve()) GTEST_SKIP();
+
+  // the thread's stack can not hold the report, the reserve's can
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(
+      &attr, std::max<size_t>(PTHREAD_STACK_MIN, kHungryStackSize + 4096));
+
+  pthread_t thread;
+  int error = pthread_create(&thread, &attr, panic_on_small_stack, nullptr);
+  pthread_attr_destroy(&attr);
+  if (error != 0) GTEST_SKIP() << "could not create the thread";
+
+  pthread_join(thread, nullptr);
+  EXPECT_TRUE(formatted);
+}
+
+TEST(ReserveTest, ThreadSignalStack) {
+  std::thread{[] {
+    ASSERT_TRUE(setup_panic_signal_stack());
+    EXPECT_EQ(signal_stack_size(), kPanicReserveStackSize);
+    // the installed stack is kept
+    EXPECT_TRUE(setup_panic_signal_stack());
+    EXPECT_EQ(signal_stack_size(), kPanicReserveStackSize);
+  }}.join();
+
+  // a spawned thread installs its own
+  EXPECT_EQ(spawn([] { return signal_stack_size(); }).join().unwrap(),
+            kPanicReserveStackSize);
+}
+
+TEST(ReserveTest, WorkerStackOverflow) {
+  EXPECT_EXIT(
+      {
+        std::thread{[] {
+          if (!setup_panic_signal_stack()) _exit(2);
+
+          struct sigaction action {};
+          action.sa_handler = report_overflow;
+          action.sa_flags = SA_ONSTACK;
+          sigemptyset(&action.sa_mask);
+          sigaction(SIGSEGV, &action, nullptr);
+
+          (void)overflow_stack(0);
+        }}.join();
+      },
+      ::testing::ExitedWithCode(1), "stack overflow reported");
+}
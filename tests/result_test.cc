@@ -773,4 +773,96 @@ TEST(ResultTest, TryOk) {
   EXPECT_EQ(ok_try_a(-10), Err(-1));
 }
 
+enum class IoError { Eof, Closed };
+enum class ParseError { BadDigit };
+enum class RangeError { TooLarge };
+
+static_assert(sizeof(Result<int, IoError, ParseError, RangeError>) == 8);
+
+auto read_text(string text) -> Result<string, IoError> {
+  if (text.empty()) return Err(IoError::Eof);
+  return Ok(std::move(text));
+}
+
+auto parse_digit(string text) -> Result<int, ParseError> {
+  if (text.size() != 1 || text[0] < '0' || text[0] > '9')
+    return Err(ParseError::BadDigit);
+  return Ok(text[0] - '0');
+}
+
+auto check_range(int x) -> Result<int, ParseError, RangeError> {
+  if (x > 5) return Err(RangeError::TooLarge);
+  return Ok(std::move(x));
+}
+
+auto read_digit(string text) -> Result<int, IoError, ParseError, RangeError> {
+  TRY_OK(content, read_text(std::move(text)));
+  TRY_OK(digit, parse_digit(std::move(content)));
+  TRY_OK(checked, check_range(std::move(digit)));
+  return Ok(std::move(checked));
+}
+
+TEST(ResultTest, MultiError) {
+  Result<int, IoError, ParseError> a = Ok(8);
+  EXPECT_TRUE(a.is_ok());
+  EXPECT_EQ(a, Ok(8));
+  EXPECT_NE(a, Err(IoError::Eof));
+
+  Result<int, IoError, ParseError> b = Err(ParseError::BadDigit);
+  EXPECT_TRUE(b.is_err());
+  EXPECT_TRUE(b.is_err<ParseError>());
+  EXPECT_FALSE(b.is_err<IoError>());
+  EXPECT_EQ(b, Err(ParseError::BadDigit));
+  EXPECT_EQ(b.clone(), b);
+
+  auto message = std::move(b).match([](int) { return "ok"s; },
+                                    [](IoError) { return "io"s; },
+                                    [](ParseError) { return "parse"s; });
+  EXPECT_EQ(message, "parse"s);
+
+  Result<string, IoError, ParseError> c = Err(IoError::Closed);
+  auto err = std::move(c).unwrap_err();
+  EXPECT_EQ(err.index(), 0);
+  EXPECT_EQ(err.get<IoError>().unwrap().get(), IoError::Closed);
+
+  Result<string, IoError, ParseError> d = Ok("hello"s);
+  EXPECT_EQ(std::move(d).map([](string s) { return s.size(); }), Ok(5UL));
+  EXPECT_EQ((Result<int, IoError, ParseError>{Err(IoError::Eof)}.unwrap_or(4)),
+            4);
+}
+
+TEST(ResultTest, MultiErrorWidening) {
+  // `Result<T, E>` and `Result<T, E...>` convert to results with a superset of
+  // their error types
+  Result<int, ParseError, IoError> a = parse_digit("x");
+  EXPECT_EQ(a, Err(ParseError::BadDigit));
+
+  Result<int, RangeError, IoError, ParseError> b = check_range(9);
+  EXPECT_EQ(b, Err(RangeError::TooLarge));
+
+  EXPECT_EQ(read_digit("3"), Ok(3));
+  EXPECT_EQ(read_digit(""), Err(IoError::Eof));
+  EXPECT_EQ(read_digit("z"), Err(ParseError::BadDigit));
+  EXPECT_EQ(read_digit("8"), Err(RangeError::TooLarge));
+}
+
+TEST(ResultTest, AndThenFlattens) {
+  Result<int, IoError, ParseError> a = read_text("7"s).and_then(parse_digit);
+  EXPECT_EQ(a, Ok(7));
+
+  auto b = read_text("7"s).and_then(parse_digit).and_then(check_range);
+  static_assert(
+      is_same_v<decltype(b), Result<int, IoError, ParseError, RangeError>>);
+  EXPECT_EQ(b, Err(RangeError::TooLarge));
+
+  auto c = read_text(""s).and_then(parse_digit).and_then(check_range);
+  EXPECT_EQ(c, Err(IoError::Eof));
+
+  // not nested if the function returns a `Result` with the same error type
+  auto d = make_ok<int, IoError>(2).and_then(
+      [](int x) -> Result<int, IoError> { return Ok(x * 2); });
+  static_assert(is_same_v<decltype(d), Result<int, IoError>>);
+  EXPECT_EQ(d, Ok(4));
+}
+
 TEST(ResultTest, Docs) {}
@@ -0,0 +1,170 @@
+/**
+ * @file signal_safe_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-21
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/panic/signal_safe.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace std::string_view_literals;
+using namespace stx;
+using internal::signal_safe::begin_signal_report;
+using internal::signal_safe::SignalSafeReport;
+
+namespace {
+
+// runs `fn` and returns what it wrote to stderr
+template <typename Fn>
+std::string stderr_output(Fn&& fn) {
+  int fds[2];
+  EXPECT_EQ(pipe(fds), 0);
+  int saved = dup(STDERR_FILENO);
+  dup2(fds[1], STDERR_FILENO);
+  close(fds[1]);
+
+  fn();
+
+  dup2(saved, STDERR_FILENO);
+  close(saved);
+
+  std::string output;
+  char buffer[512];
+  ssize_t size;
+  while ((size = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    output.append(buffer, static_cast<size_t>(size));
+  }
+  close(fds[0]);
+  return output;
+}
+
+// writes a signal-safe report with `write` and returns what reached stderr
+template <typename Fn>
+std::string report_output(Fn&& write) {
+  return stderr_output([&] {
+    SignalSafeReport report = begin_signal_report();
+    write(report);
+    report.finish();
+  });
+}
+
+void panic_in_handler(int) { panic_signal_safe("interrupted"); }
+
+}  // namespace
+
+TEST(SignalSafeTest, FormatNumbers) {
+  std::string output = report_output([](SignalSafeReport& report) {
+    report.write_number(0);
+    report.write(" ");
+    report.write_number(-42);
+    report.write(" ");
+    report.write_number(std::numeric_limits<int64_t>::min());
+    report.write(" ");
+    report.write_number(std::numeric_limits<uint64_t>::max());
+    report.write(" ");
+    report.write_number(uint32_t{0xdeadbeef}, 16);
+  });
+
+  EXPECT_EQ(output,
+            "0 -42 -9223372036854775808 18446744073709551615 deadbeef"sv);
+}
+
+TEST(SignalSafeTest, LongReport) {
+  // a report larger than the buffer is written in parts, in order
+  std::string text(internal::signal_safe::kSignalReportBufferSize * 2 + 7, 'x');
+  text.back() = 'y';
+
+  std::string output =
+      report_output([&](SignalSafeReport& report) { report.write(text); });
+
+  EXPECT_EQ(output, text);
+}
+
+TEST(SignalSafeTest, ReportsInTurn) {
+  // each report takes the next turn once the one before it is finished
+  EXPECT_EQ(report_output([](SignalSafeReport& report) { report.write("a"); }),
+            "a"sv);
+  EXPECT_EQ(report_output([](SignalSafeReport& report) { report.write("b"); }),
+            "b"sv);
+}
+
+TEST(SignalSafeTest, TakeOverStalledReport) {
+  std::string output = stderr_output([] {
+    SignalSafeReport stalled = begin_signal_report();
+    stalled.write("stalled ");
+
+    // takes over at once, as the stalled report is this thread's, and writes
+    // through, as the stalled report holds the buffer
+    SignalSafeReport next = begin_signal_report();
+    next.write("next ");
+    next.finish();
+
+    SignalSafeReport third = begin_signal_report();
+    third.write("third ");
+
+    // the stalled report resumes, but the turn stays with the third report
+    stalled.finish();
+    std::thread fourth{[] {
+      SignalSafeReport report = begin_signal_report();
+      report.write("fourth");
+      report.finish();
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    third.write("end ");
+    third.finish();
+    fourth.join();
+  });
+
+  EXPECT_EQ(output, "next third stalled end fourth"sv);
+}
+
+TEST(SignalSafeTest, TakeOverOnOwningThread) {
+  // a signal handler that interrupted the report being written must not wait
+  // for it, it can not finish before the handler returns
+  auto const start = std::chrono::steady_clock::now();
+  std::string output = stderr_output([] {
+    SignalSafeReport interrupted = begin_signal_report();
+    interrupted.write("interrupted");
+
+    SignalSafeReport handler = begin_signal_report();
+    handler.write("handler ");
+    handler.finish();
+
+    interrupted.finish();
+  });
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds{500});
+  EXPECT_EQ(output, "handler interrupted"sv);
+}
+
+TEST(SignalSafeTest, Panic) {
+  EXPECT_DEATH(panic_signal_safe("stalled"),
+               "panicked in a signal-safe context with: 'stalled'");
+}
+
+TEST(SignalSafeTest, PanicFromSignalHandler) {
+  EXPECT_DEATH(
+      {
+        std::signal(SIGUSR1, panic_in_handler);
+        std::raise(SIGUSR1);
+      },
+      "panicked in a signal-safe context with: 'interrupted' at function: "
+      "'.*panic_in_handler");
+}
@@ -0,0 +1,76 @@
+/**
+ * @file spawn_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-15
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/spawn.h"
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "stx/panic/hook.h"
+
+using namespace std::string_view_literals;
+using namespace stx;
+
+namespace {
+
+void quiet_hook(std::string_view, ReportPayload const&,
+                SourceLocation) noexcept {}
+
+}  // namespace
+
+TEST(SpawnTest, Join) {
+  EXPECT_EQ(spawn([] { return 42; }).join(), Ok(42));
+  EXPECT_EQ(spawn([] {}).join(), Ok(Unit{}));
+
+  std::string owned = "moved into the thread";
+  auto handle = spawn([owned = std::move(owned)] { return owned; });
+  EXPECT_NE(handle.id(), std::this_thread::get_id());
+  EXPECT_EQ(std::move(handle).join(), Ok(std::string("moved into the thread")));
+}
+
+TEST(SpawnTest, Panic) {
+  if constexpr (!kPanicUnwind) {
+    EXPECT_DEATH((void)spawn([] { panic("worker"); }).join(),
+                 "panicked with: 'worker'");
+    return;
+  }
+
+  std::vector<JoinHandle<int>> handles;
+  for (int i = 0; i < 4; i++) {
+    handles.push_back(spawn([i]() -> int {
+      ScopedPanicHook quiet{quiet_hook};
+      if (i % 2 != 0) panic_fmt("worker {} failed", i);
+      return i;
+    }));
+  }
+
+  for (int i = 0; i < 4; i++) {
+    auto result = std::move(handles[i]).join();
+    if (i % 2 != 0) {
+      ASSERT_TRUE(result.is_err());
+      PanicInfo info = std::move(result).unwrap_err();
+      EXPECT_EQ(info.report(), "worker " + std::to_string(i) + " failed");
+      EXPECT_EQ(std::string_view(info.location().file_name()),
+                std::string_view(__FILE__));
+    } else {
+      EXPECT_EQ(result, Ok(int{i}));
+    }
+  }
+}
+
+TEST(SpawnTest, DropJoins) {
+  int value = 0;
+  { auto handle = spawn([&] { value = 7; }); }
+  EXPECT_EQ(value, 7);
+}
@@ -0,0 +1,144 @@
+/**
+ * @file unwind_test.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief
+ * @version  0.1
+ * @date 2020-06-14
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stx/panic/unwind.h"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "stx/option.h"
+#include "stx/panic/hook.h"
+
+using namespace std::string_view_literals;
+using namespace stx;
+
+namespace {
+
+int destroyed = 0;
+
+struct Guard {
+  ~Guard() { destroyed++; }
+};
+
+struct PanicsOnDestruction {
+  ~PanicsOnDestruction() { panic("panicked while unwinding"); }
+};
+
+// keeps the panic reports of the caught panics out of the test output
+void quiet_hook(std::string_view, ReportPayload const&,
+                SourceLocation) noexcept {}
+
+}  // namespace
+
+TEST(UnwindTest, NoPanic) {
+  EXPECT_EQ(catch_panic([] { return 5; }), Ok(5));
+  EXPECT_EQ(catch_panic([] {}), Ok(Unit{}));
+}
+
+TEST(UnwindTest, CatchPanic) {
+  if constexpr (!kPanicUnwind) {
+    EXPECT_DEATH((void)catch_panic([] { panic("boom"); }),
+                 "panicked with: 'boom'");
+    return;
+  }
+
+  ScopedPanicHook quiet{quiet_hook};
+  destroyed = 0;
+
+  auto result = catch_panic([]() -> int {
+    Guard guard;
+    std::string value = "owned " + std::to_string(42);
+    panic("request failed", std::string_view(value));
+  });
+
+  ASSERT_TRUE(result.is_err());
+  PanicInfo info = std::move(result).unwrap_err();
+  EXPECT_EQ(info.info(), "request failed");
+  // formatted before the stack was unwound
+  EXPECT_EQ(info.report(), "owned 42");
+  EXPECT_FALSE(info.truncated());
+  EXPECT_EQ(destroyed, 1);
+  EXPECT_FALSE(this_thread::is_panicking());
+
+  // the thread can panic again, the panic count was reset
+  auto unwrap = catch_panic([] { return Option<int>{None}.unwrap(); });
+  ASSERT_TRUE(unwrap.is_err());
+  EXPECT_EQ(std::move(unwrap).unwrap_err().info(),
+            "called `Option::unwrap()` on a `None` value");
+}
+
+TEST(UnwindTest, Truncated) {
+  if constexpr (!kPanicUnwind) return;
+
+  ScopedPanicHook quiet{quiet_hook};
+
+  std::string long_info(kPanicInfoSize + 1, 'i');
+  std::string long_report(kPanicReportSize + 1, 'r');
+
+  auto result = catch_panic([&] {
+    panic(long_info, std::string_view(long_report));
+  });
+
+  PanicInfo info = std::move(result).unwrap_err();
+  EXPECT_TRUE(info.truncated());
+  EXPECT_EQ(info.info(), std::string_view(long_info).substr(0, kPanicInfoSize));
+  EXPECT_EQ(info.report(),
+            std::string_view(long_report).substr(0, kPanicReportSize));
+}
+
+TEST(UnwindTest, NotCaughtAsException) {
+  if constexpr (!kPanicUnwind) return;
+
+  ScopedPanicHook quiet{quiet_hook};
+  bool caught_exception = false;
+
+  auto result = catch_panic([&] {
+    try {
+      panic("not an exception");
+    } catch (std::exception const&) {
+      caught_exception = true;
+    }
+  });
+
+  EXPECT_TRUE(result.is_err());
+  EXPECT_FALSE(caught_exception);
+}
+
+TEST(UnwindTest, Nested) {
+  if constexpr (!kPanicUnwind) return;
+
+  ScopedPanicHook quiet{quiet_hook};
+
+  auto outer = catch_panic([] {
+    auto inner = catch_panic([] { panic_fmt("inner {}", 1); });
+    EXPECT_EQ(std::move(inner).unwrap_err().report(), "inner 1");
+    panic_fmt("outer {}", 2);
+  });
+  EXPECT_EQ(std::move(outer).unwrap_err().report(), "outer 2");
+}
+
+TEST(UnwindTest, Aborts) {
+  // outside of `catch_panic`
+  EXPECT_DEATH(panic("uncaught"), "panicked with: 'uncaught'");
+
+  // a panic while unwinding from another panic
+  auto double_panic = [] {
+    (void)catch_panic([] {
+      PanicsOnDestruction object;
+      panic("first");
+    });
+  };
+  if constexpr (kPanicUnwind) {
+    EXPECT_DEATH(double_panic(), "while processing a panic");
+  }
+}
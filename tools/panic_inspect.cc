@@ -0,0 +1,91 @@
+/**
+ * @file panic_inspect.cc
+ * @author Basit Ayantunde <rlamarrr@gmail.com>
+ * @brief prints the reports in a panic ring file, oldest first
+ * @version  0.1
+ * @date 2020-06-20
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "stx/panic/ring_file.h"
+
+namespace {
+
+void print_record(stx::PanicRingRecord const& record) {
+  auto seconds = static_cast<time_t>(record.timestamp_ns / 1'000'000'000);
+  tm utc{};
+  char date[32] = "<unknown>";
+  if (gmtime_r(&seconds, &utc) != nullptr) {
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &utc);
+  }
+
+  std::printf("=== panic #%llu at %s.%09lluZ%s\n",
+              static_cast<unsigned long long>(record.sequence), date,
+              static_cast<unsigned long long>(record.timestamp_ns %
+                                              1'000'000'000),
+              record.truncated ? " (truncated)" : "");
+  std::fwrite(record.report.data(), 1, record.report.size(), stdout);
+  if (!record.report.empty() && record.report.back() != '\n') {
+    std::fputc('\n', stdout);
+  }
+  std::fputc('\n', stdout);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::fprintf(stderr, "usage: %s <panic ring file>\n", argv[0]);
+    return 2;
+  }
+
+  int fd = open(argv[1], O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    std::fprintf(stderr, "%s: %s\n", argv[1], std::strerror(errno));
+    return 1;
+  }
+
+  struct stat status {};
+  if (fstat(fd, &status) != 0 || status.st_size == 0) {
+    std::fprintf(stderr, "%s: not a panic ring file\n", argv[1]);
+    close(fd);
+    return 1;
+  }
+
+  auto size = static_cast<size_t>(status.st_size);
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    std::fprintf(stderr, "%s: %s\n", argv[1], std::strerror(errno));
+    return 1;
+  }
+
+  size_t num_records = 0;
+  bool valid = stx::for_each_panic_ring_record(
+      std::span<char const>{static_cast<char const*>(mapping), size},
+      [&num_records](stx::PanicRingRecord const& record) {
+        print_record(record);
+        num_records++;
+      });
+
+  munmap(mapping, size);
+
+  if (!valid) {
+    std::fprintf(stderr, "%s: not a panic ring file\n", argv[1]);
+    return 1;
+  }
+
+  std::printf("%zu report(s)\n", num_records);
+  return 0;
+}